@@ -0,0 +1,131 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+* License, v. 2.0. If a copy of the MPL was not distributed with this
+* file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+/*
+Authors:
+Michael Berg <michael.berg@zalf.de>
+
+Maintainers:
+Currently maintained by the authors.
+
+This file is part of the MONICA model.
+Copyright (C) Leibniz Centre for Agricultural Landscape Research (ZALF)
+*/
+
+#include "allocation-counter.h"
+
+#ifdef MONICA_COUNT_ALLOCATIONS
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+#ifdef _WIN32
+#include <malloc.h>
+#endif
+
+namespace {
+
+std::atomic<size_t> allocations{0};
+thread_local size_t threadAllocations = 0;
+
+void* countedAlloc(size_t size) {
+  allocations.fetch_add(1, std::memory_order_relaxed);
+  threadAllocations++;
+  return std::malloc(size == 0 ? 1 : size);
+}
+
+void* countedAlignedAlloc(size_t size, std::align_val_t al) {
+  allocations.fetch_add(1, std::memory_order_relaxed);
+  threadAllocations++;
+  auto alignment = size_t(al);
+#ifdef _WIN32
+  return _aligned_malloc(size == 0 ? 1 : size, alignment);
+#else
+  // aligned_alloc needs a multiple of the alignment as size
+  return std::aligned_alloc(alignment, size == 0 ? alignment : (size + alignment - 1) / alignment * alignment);
+#endif
+}
+
+void alignedFree(void* p) {
+#ifdef _WIN32
+  _aligned_free(p);
+#else
+  std::free(p);
+#endif
+}
+
+} // namespace
+
+void* operator new(size_t size) {
+  if (auto p = countedAlloc(size)) return p;
+  throw std::bad_alloc();
+}
+
+void* operator new[](size_t size) {
+  if (auto p = countedAlloc(size)) return p;
+  throw std::bad_alloc();
+}
+
+void* operator new(size_t size, const std::nothrow_t&) noexcept { return countedAlloc(size); }
+
+void* operator new[](size_t size, const std::nothrow_t&) noexcept { return countedAlloc(size); }
+
+void* operator new(size_t size, std::align_val_t al) {
+  if (auto p = countedAlignedAlloc(size, al)) return p;
+  throw std::bad_alloc();
+}
+
+void* operator new[](size_t size, std::align_val_t al) {
+  if (auto p = countedAlignedAlloc(size, al)) return p;
+  throw std::bad_alloc();
+}
+
+void* operator new(size_t size, std::align_val_t al, const std::nothrow_t&) noexcept {
+  return countedAlignedAlloc(size, al);
+}
+
+void* operator new[](size_t size, std::align_val_t al, const std::nothrow_t&) noexcept {
+  return countedAlignedAlloc(size, al);
+}
+
+void operator delete(void* p) noexcept { std::free(p); }
+
+void operator delete[](void* p) noexcept { std::free(p); }
+
+void operator delete(void* p, size_t) noexcept { std::free(p); }
+
+void operator delete[](void* p, size_t) noexcept { std::free(p); }
+
+void operator delete(void* p, const std::nothrow_t&) noexcept { std::free(p); }
+
+void operator delete[](void* p, const std::nothrow_t&) noexcept { std::free(p); }
+
+void operator delete(void* p, std::align_val_t) noexcept { alignedFree(p); }
+
+void operator delete[](void* p, std::align_val_t) noexcept { alignedFree(p); }
+
+void operator delete(void* p, size_t, std::align_val_t) noexcept { alignedFree(p); }
+
+void operator delete[](void* p, size_t, std::align_val_t) noexcept { alignedFree(p); }
+
+void operator delete(void* p, std::align_val_t, const std::nothrow_t&) noexcept { alignedFree(p); }
+
+void operator delete[](void* p, std::align_val_t, const std::nothrow_t&) noexcept { alignedFree(p); }
+
+bool monica::allocationsCounted() { return true; }
+
+size_t monica::threadAllocationCount() { return threadAllocations; }
+
+size_t monica::allocationCount() { return allocations.load(std::memory_order_relaxed); }
+
+#else
+
+bool monica::allocationsCounted() { return false; }
+
+size_t monica::threadAllocationCount() { return 0; }
+
+size_t monica::allocationCount() { return 0; }
+
+#endif
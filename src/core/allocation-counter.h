@@ -0,0 +1,38 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+* License, v. 2.0. If a copy of the MPL was not distributed with this
+* file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+/*
+Authors:
+Michael Berg <michael.berg@zalf.de>
+
+Maintainers:
+Currently maintained by the authors.
+
+This file is part of the MONICA model.
+Copyright (C) Leibniz Centre for Agricultural Landscape Research (ZALF)
+*/
+
+#pragma once
+
+#include <cstddef>
+
+namespace monica {
+
+/*
+ * Counting of heap allocations, to find allocations on the daily step path.
+ *
+ * Only if built with the cmake option MONICA_COUNT_ALLOCATIONS (defines MONICA_COUNT_ALLOCATIONS),
+ * which replaces the global operator new/delete (also the aligned ones). Otherwise the counts are always 0.
+ */
+
+//! true if the allocations are actually counted
+bool allocationsCounted();
+
+//! number of heap allocations (calls of operator new) of the calling thread so far
+size_t threadAllocationCount();
+
+//! number of heap allocations of all threads so far
+size_t allocationCount();
+
+} // namespace monica
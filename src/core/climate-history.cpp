@@ -0,0 +1,61 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+* License, v. 2.0. If a copy of the MPL was not distributed with this
+* file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+/*
+Authors:
+Michael Berg <michael.berg@zalf.de>
+
+Maintainers:
+Currently maintained by the authors.
+
+This file is part of the MONICA model.
+Copyright (C) Leibniz Centre for Agricultural Landscape Research (ZALF)
+*/
+
+#include "climate-history.h"
+
+#include <algorithm>
+
+using namespace monica;
+using namespace std;
+
+void ClimateHistory::setCapacity(size_t capacity) {
+  capacity = max(size_t(1), capacity);
+  auto keep = min(_size, capacity);
+  vector<ClimateStep> steps(capacity);
+  // copy the kept days oldest first to the front of the new buffer
+  for (size_t i = 0; i < keep; i++) steps[i] = daysAgo(keep - 1 - i);
+  _steps = move(steps);
+  _size = keep;
+  _next = keep % capacity;
+}
+
+void ClimateHistory::push(const ClimateStep& step) {
+  _steps[_next] = step;
+  _next = (_next + 1) % _steps.size();
+  _size = min(_size + 1, _steps.size());
+
+  if (step.has(Climate::tavg)) {
+    double tavg = step.values[Climate::tavg];
+    for (auto& p : _tavgSumsAboveBaseTemp) p.second += max(0.0, tavg - p.first);
+  }
+}
+
+void ClimateHistory::trackTavgSumAboveBaseTemp(double baseTemp) {
+  for (const auto& p : _tavgSumsAboveBaseTemp) if (p.first == baseTemp) return;
+
+  double sum = 0;
+  for (size_t i = _size; i > 0; i--) {
+    const auto& step = daysAgo(i - 1);
+    if (step.has(Climate::tavg)) sum += max(0.0, step.values[Climate::tavg] - baseTemp);
+  }
+  _tavgSumsAboveBaseTemp.emplace_back(baseTemp, sum);
+}
+
+double ClimateHistory::tavgSumAboveBaseTemp(double baseTemp) {
+  for (const auto& p : _tavgSumsAboveBaseTemp) if (p.first == baseTemp) return p.second;
+
+  trackTavgSumAboveBaseTemp(baseTemp);
+  return _tavgSumsAboveBaseTemp.back().second;
+}
@@ -0,0 +1,76 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+* License, v. 2.0. If a copy of the MPL was not distributed with this
+* file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+/*
+Authors:
+Michael Berg <michael.berg@zalf.de>
+
+Maintainers:
+Currently maintained by the authors.
+
+This file is part of the MONICA model.
+Copyright (C) Leibniz Centre for Agricultural Landscape Research (ZALF)
+*/
+
+#pragma once
+
+#include <utility>
+#include <vector>
+
+#include "climate-step.h"
+
+namespace monica {
+
+/**
+ * @brief Climate data of the last days of a run in a ring buffer.
+ *
+ * Only as many days are kept as the registered users need to look back (e.g. the temperature window
+ * of automatic sowing or the days to be serialized with the model state), so the memory used doesn't
+ * grow with the length of a run. Sums over the whole run have to be tracked as running sums instead.
+ */
+class ClimateHistory {
+public:
+  explicit ClimateHistory(size_t capacity = 1) { setCapacity(capacity); }
+
+  //! make sure at least noOfDays days (including the current one) are kept
+  void requireDays(size_t noOfDays) { if (noOfDays > capacity()) setCapacity(noOfDays); }
+
+  size_t capacity() const { return _steps.size(); }
+
+  //! resize the buffer, keeping the newest days
+  void setCapacity(size_t capacity);
+
+  //! number of days stored, at most capacity()
+  size_t size() const { return _size; }
+
+  bool empty() const { return _size == 0; }
+
+  void clear() { _size = 0, _next = 0; }
+
+  void push(const ClimateStep& step);
+
+  //! climate data of the day daysAgo days before the newest day, 0 is the newest day
+  const ClimateStep& daysAgo(size_t daysAgo) const {
+    assert(daysAgo < _size);
+    auto cap = _steps.size();
+    return _steps[(_next + cap - 1 - daysAgo) % cap];
+  }
+
+  const ClimateStep& back() const { return daysAgo(0); }
+
+  //! keep a running sum of max(0, tavg - baseTemp) over all days pushed from now on,
+  //! if tracking starts late, the sum starts with the days still in the buffer
+  void trackTavgSumAboveBaseTemp(double baseTemp);
+
+  //! sum of max(0, tavg - baseTemp) over the days pushed, starts tracking if not done yet
+  double tavgSumAboveBaseTemp(double baseTemp);
+
+private:
+  std::vector<ClimateStep> _steps;
+  size_t _next{0}; //!< index the next day will be stored at
+  size_t _size{0};
+  std::vector<std::pair<double, double>> _tavgSumsAboveBaseTemp; //!< base temperature -> running sum
+};
+
+} // namespace monica
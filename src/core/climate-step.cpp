@@ -0,0 +1,41 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+* License, v. 2.0. If a copy of the MPL was not distributed with this
+* file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+/*
+Authors:
+Michael Berg <michael.berg@zalf.de>
+
+Maintainers:
+Currently maintained by the authors.
+
+This file is part of the MONICA model.
+Copyright (C) Leibniz Centre for Agricultural Landscape Research (ZALF)
+*/
+
+#include "climate-step.h"
+
+using namespace monica;
+using namespace std;
+using namespace Climate;
+
+ClimateStepReader::ClimateStepReader(const DataAccessor& da, double latitude)
+: _da(&da)
+, _latitude(latitude) {
+  if (da.noOfStepsPossible() == 0) return;
+
+  // the first step tells which elements the data accessor delivers
+  for (const auto& p : da.allDataForStep(0, latitude)) {
+    if (da.hasAvailableClimateData(p.first)) _acds.push_back(p.first);
+    else _hasDerivedData = true;
+  }
+}
+
+ClimateStep ClimateStepReader::step(size_t stepNo) const {
+  // derived elements are only calculated by the data accessor itself
+  if (_hasDerivedData) return ClimateStep(_da->allDataForStep(stepNo, _latitude));
+
+  ClimateStep cs;
+  for (auto acd : _acds) cs.set(acd, _da->dataForTimestep(acd, stepNo));
+  return cs;
+}
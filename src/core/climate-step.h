@@ -0,0 +1,91 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+* License, v. 2.0. If a copy of the MPL was not distributed with this
+* file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+/*
+Authors:
+Michael Berg <michael.berg@zalf.de>
+
+Maintainers:
+Currently maintained by the authors.
+
+This file is part of the MONICA model.
+Copyright (C) Leibniz Centre for Agricultural Landscape Research (ZALF)
+*/
+
+#pragma once
+
+#include <array>
+#include <cassert>
+#include <cstdint>
+#include <map>
+#include <stdexcept>
+#include <vector>
+
+#include "climate/climate-common.h"
+
+namespace monica {
+
+//! the climate data of a single day in a flat record indexed by Climate::ACD,
+//! presence bits tell which of the values have been set
+struct ClimateStep {
+  static const size_t maxNoOfACDs = 64;
+
+  ClimateStep() = default;
+
+  explicit ClimateStep(const std::map<Climate::ACD, double>& acd2value) {
+    for (const auto& p : acd2value) set(p.first, p.second);
+  }
+
+  bool has(Climate::ACD acd) const { return size_t(acd) < maxNoOfACDs && ((presence >> size_t(acd)) & 1); }
+
+  double get(Climate::ACD acd, double defaultValue = 0.0) const { return has(acd) ? values[acd] : defaultValue; }
+
+  //! like std::map::at, throws std::out_of_range if acd is not present
+  double at(Climate::ACD acd) const {
+    if (!has(acd)) throw std::out_of_range("ClimateStep::at: climate element not available");
+    return values[acd];
+  }
+
+  //! elements beyond the record's capacity (e.g. Climate::skip) are ignored
+  void set(Climate::ACD acd, double value) {
+    if (size_t(acd) >= maxNoOfACDs) return;
+    values[acd] = value;
+    presence |= uint64_t(1) << size_t(acd);
+  }
+
+  void clear() { presence = 0; }
+
+  size_t size() const {
+    size_t count = 0;
+    for (auto p = presence; p; p &= p - 1) count++;
+    return count;
+  }
+
+  std::map<Climate::ACD, double> toMap() const {
+    std::map<Climate::ACD, double> acd2value;
+    for (size_t i = 0; i < maxNoOfACDs; i++) {
+      if ((presence >> i) & 1) acd2value[Climate::ACD(i)] = values[i];
+    }
+    return acd2value;
+  }
+
+  std::array<double, maxNoOfACDs> values{};
+  uint64_t presence{0};
+};
+
+//! reads the ClimateSteps of a DataAccessor without building a map per day
+class ClimateStepReader {
+public:
+  ClimateStepReader(const Climate::DataAccessor& da, double latitude);
+
+  ClimateStep step(size_t stepNo) const;
+
+private:
+  const Climate::DataAccessor* _da{nullptr};
+  double _latitude{0};
+  std::vector<Climate::ACD> _acds; //!< elements stored in the data accessor
+  bool _hasDerivedData{false}; //!< elements calculated by the data accessor (e.g. globrad from sunhours)
+};
+
+} // namespace monica
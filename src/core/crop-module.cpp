@@ -26,6 +26,7 @@ Copyright (C) Leibniz Centre for Agricultural Landscape Research (ZALF)
 #include <kj/exception.h>
 
 #include "tools/debug.h"
+#include "debug-log.h"
 #include "soilmoisture.h"
 #include "monica-parameters.h"
 #include "tools/helper.h"
@@ -35,6 +36,7 @@ Copyright (C) Leibniz Centre for Agricultural Landscape Research (ZALF)
 #include "voc-common.h"
 #include "photosynthesis-FvCB.h"
 #include "O3-impact.h"
+#include "step-timer.h"
 #include "io/output.h"
 
 const double PI = 3.14159265358979323;
@@ -53,6 +55,7 @@ using namespace Tools;
  * @author Claas Nendel
  */
 CropModule::CropModule(SoilColumn& sc,
+                       ScratchArena& scratch,
                        const CropParameters& cps,
                        CropResidueParameters rps,
                        bool isWinterCrop,
@@ -66,6 +69,7 @@ CropModule::CropModule(SoilColumn& sc,
 : _intercropping(ic)
 , _frostKillOn(simPs.pc_FrostKillOn)
 , soilColumn(sc)
+, scratch(scratch)
 , cropPs(cropPs)
 , speciesPs(cps.speciesParams)
 , cultivarPs(cps.cultivarParams)
@@ -301,6 +305,7 @@ CropModule::CropModule(SoilColumn& sc,
 }
 
 CropModule::CropModule(SoilColumn& sc,
+                       ScratchArena& scratch,
                        const CropModuleParameters& cropPs,
                        std::function<void(std::string)> fireEvent,
                        std::function<void(std::map<size_t, double>, double)> addOrganicMatter,
@@ -309,6 +314,7 @@ CropModule::CropModule(SoilColumn& sc,
                        Intercropping& ic)
 : _intercropping(ic)
 , soilColumn(sc)
+, scratch(scratch)
 , cropPs(cropPs)
 , _fireEvent(kj::mv(fireEvent))
 , _addOrganicMatter(
@@ -1020,7 +1026,7 @@ void CropModule::step(double vw_MeanAirTemperature,
 
   auto icSendRcv = [&](const string& outmsg) {
     if (cropPs.isIntercropping && _intercropping.isAsync()) {
-      debug() << outmsg;
+      MONICA_DEBUG(outmsg);
       // tell the other side our current crop height
       auto wreq = _intercropping.writer.writeRequest();
       auto wval = wreq.initValue();
@@ -1028,15 +1034,15 @@ void CropModule::step(double vw_MeanAirTemperature,
       auto prom = wreq.send();
       //.wait(_intercropping.ioContext->waitScope); //.eagerlyEvaluate(nullptr); //[](kj::Exception&& ex){ cout << "crop-module: CropModule::fc_CropPhotosynthesis: write height failed: " << ex.getDescription().cStr() << endl;});
       auto val = _intercropping.reader.readRequest().send().wait(_intercropping.ioContext->waitScope).getValue();
-      debug() << "sent height: " << vc_CropHeight << " and received ";
+      MONICA_DEBUG("sent height: " << vc_CropHeight << " and received ");
       if (val.isHeight()) {
         _intercroppingOtherCropHeight = val.getHeight();
-        debug() << "height: " << _intercroppingOtherCropHeight << endl;
+        MONICA_DEBUG("height: " << _intercroppingOtherCropHeight << endl);
       } else if (val.isNoCrop()) {
         _intercroppingOtherCropHeight = -1;
-        debug() << " no-crop" << endl;
+        MONICA_DEBUG(" no-crop" << endl);
       } else if (val.isLait()) {
-        debug() << " LAI_t -> Error shouldn't happen here." << endl;
+        MONICA_DEBUG(" LAI_t -> Error shouldn't happen here." << endl);
         assert(false);
       }
     }
@@ -1047,7 +1053,7 @@ void CropModule::step(double vw_MeanAirTemperature,
                          && _intercroppingOtherCropHeight > vc_CropHeight
                            ? pc_MaxCropHeight * cropPs.pc_intercropping_phRedux
                            : pc_MaxCropHeight;
-    debug() << "original maxCropHeight: " << pc_MaxCropHeight << " -> new maxCropHeight: " << maxCropHeight << endl;
+    MONICA_DEBUG("original maxCropHeight: " << pc_MaxCropHeight << " -> new maxCropHeight: " << maxCropHeight << endl);
 
     fc_CropSize(maxCropHeight);
 
@@ -1511,7 +1517,7 @@ void CropModule::fc_CropDevelopmentalStage(double meanAirTemperature,
     vc_ErrorMessage = "irregular developmental stage";
   }
 
-  debug() << "devstage: " << vc_DevelopmentalStage << endl;
+  MONICA_DEBUG("devstage: " << vc_DevelopmentalStage << endl);
 }
 
 /**
@@ -1755,12 +1761,12 @@ ostream& monica::tout(bool closeFile) {
 
 void CropModule::fc_MoveDeadRootBiomassToSoil(double deadRootBiomass,
                                               double vc_RootDensityFactorSum,
-                                              const vector<double>& vc_RootDensityFactor) {
+                                              const double* vc_RootDensityFactor) {
   auto nools = soilColumn.vs_NumberOfOrganicLayers();
 
   map<size_t, double> layer2deadRootBiomassAtLayer;
   for (size_t i = 0; i < vc_RootingZone; i++) {
-    double deadRootBiomassAtLayer = vc_RootDensityFactor.at(i) / vc_RootDensityFactorSum * deadRootBiomass;
+    double deadRootBiomassAtLayer = vc_RootDensityFactor[i] / vc_RootDensityFactorSum * deadRootBiomass;
     // just add organica matter if > 0.0001
     if (int(deadRootBiomassAtLayer * 10000) > 0) {
       layer2deadRootBiomassAtLayer[i < nools ? i : nools - 1] += deadRootBiomassAtLayer;
@@ -2252,18 +2258,19 @@ void CropModule::fc_CropPhotosynthesis(double vw_MeanAirTemperature,
     int vs_JulianDay = currentDate.julianDay();
     double dailyGP = 0;
     if (cropPs.__enable_hourly_FvCB_photosynthesis__ && pc_CarboxylationPathway == 1) {
-      vector<double> hourlyGlobrads;
-      vector<double> hourlyExtrarad;
+      StepKernelTimer t(HOURLY_FVCB_PHOTOSYNTHESIS, stepKernelTimes);
+      double* hourlyGlobrads = scratch.doubles(24);
+      double* hourlyExtrarad = scratch.doubles(24);
       int sunriseH = 0;
 
       for (int h = 0; h < 24; h++) {
         double hgr = hourlyRad(vc_GlobalRadiation, vs_Latitude, vs_JulianDay, h);
-        if (hgr > 0 && hourlyGlobrads.back() == 0.0) {
+        if (hgr > 0 && h > 0 && hourlyGlobrads[h - 1] == 0.0) {
           sunriseH = h;
         }
-        hourlyGlobrads.push_back(hgr);
+        hourlyGlobrads[h] = hgr;
 
-        hourlyExtrarad.push_back(hourlyRad(vc_ExtraterrestrialRadiation, vs_Latitude, vs_JulianDay, h));
+        hourlyExtrarad[h] = hourlyRad(vc_ExtraterrestrialRadiation, vs_Latitude, vs_JulianDay, h);
       }
 
       using namespace FvCB;
@@ -2284,8 +2291,8 @@ void CropModule::fc_CropPhotosynthesis(double vw_MeanAirTemperature,
 
         double hourlyTemp = hourlyT(vw_MinAirTemperature, vw_MaxAirTemperature, h, sunriseH);
         FvCB_in.leaf_temp = hourlyTemp;
-        FvCB_in.global_rad = hourlyGlobrads.at(h);
-        FvCB_in.extra_terr_rad = hourlyExtrarad.at(h);
+        FvCB_in.global_rad = hourlyGlobrads[h];
+        FvCB_in.extra_terr_rad = hourlyExtrarad[h];
         FvCB_in.LAI = LAI;
         FvCB_in.solar_el = solarElevation(h, vs_Latitude, vs_JulianDay);
         FvCB_in.VPD = hourlyVaporPressureDeficit(hourlyTemp, vw_MinAirTemperature, vw_MeanAirTemperature,
@@ -2520,17 +2527,17 @@ void CropModule::fc_CropPhotosynthesis(double vw_MeanAirTemperature,
   double vc_GrossCO2Assimilation = 0, vc_GrossCO2AssimilationReference = 0;
   double zeroHeightEps = 0.00001;
   if (_intercroppingOtherCropHeight <= zeroHeightEps || vc_CropHeight <= zeroHeightEps) {
-    debug() << "no-other-crop: dev-stage: " << (vc_DevelopmentalStage + 1)
+    MONICA_DEBUG("no-other-crop: dev-stage: " << (vc_DevelopmentalStage + 1)
       << " other-crop-height: " << _intercroppingOtherCropHeight
-      << " own-crop-height: " << vc_CropHeight << endl;
-    debug() << "vc_OvercastSkyTimeFraction: " << vc_OvercastSkyTimeFraction << endl;
+      << " own-crop-height: " << vc_CropHeight << endl);
+    MONICA_DEBUG("vc_OvercastSkyTimeFraction: " << vc_OvercastSkyTimeFraction << endl);
     auto F_t1 = [this](double LAI) {
       return 1.0 - exp(-cultivarPs.pc_LightExtinctionCoefficient * LAI);
     };
     tie(vc_GrossCO2Assimilation, vc_GrossCO2AssimilationReference) = code(F_t1, vc_LeafAreaIndex);
     fractionOfInterceptedRadiation1 = F_t1(vc_LeafAreaIndex);
-    debug() << "assimilation calculations for only one crop: grossCO2Assim: " << vc_GrossCO2Assimilation
-      << " ref: " << vc_GrossCO2AssimilationReference << endl;
+    MONICA_DEBUG("assimilation calculations for only one crop: grossCO2Assim: " << vc_GrossCO2Assimilation
+      << " ref: " << vc_GrossCO2AssimilationReference << endl);
   } else {
     double k_t = cropPs.pc_intercropping_k_t;
     double k_s = cropPs.pc_intercropping_k_s;
@@ -2549,9 +2556,9 @@ void CropModule::fc_CropPhotosynthesis(double vw_MeanAirTemperature,
 
     assert(_intercroppingOtherCropHeight > zeroHeightEps);
     if (vc_CropHeight < _intercroppingOtherCropHeight) {
-      debug() << "smaller crop: dev-stage: " << (vc_DevelopmentalStage + 1)
+      MONICA_DEBUG("smaller crop: dev-stage: " << (vc_DevelopmentalStage + 1)
         << " other-crop-height: " << _intercroppingOtherCropHeight
-        << " own-crop-height: " << vc_CropHeight << endl;
+        << " own-crop-height: " << vc_CropHeight << endl);
 
       // send out LAI_s and wait for LAI_t2 from the larger plant
       double LAI_t2 = phr * _intercroppingOtherLAIt;
@@ -2565,7 +2572,7 @@ void CropModule::fc_CropPhotosynthesis(double vw_MeanAirTemperature,
         LAI_t2 = val.isLait()
                    ? val.getLait()
                    : -9999; // throw kj::Exception(kj::Exception::Type::FAILED, "crop-module.cpp", 2718);
-        debug() << "sent LAI_s: " << vc_LeafAreaIndex << " received LAI_t2: " << LAI_t2 << endl;
+        MONICA_DEBUG("sent LAI_s: " << vc_LeafAreaIndex << " received LAI_t2: " << LAI_t2 << endl);
       }
       // fraction of radiation intercepted for lower plant part
 
@@ -2576,12 +2583,12 @@ void CropModule::fc_CropPhotosynthesis(double vw_MeanAirTemperature,
 
       tie(vc_GrossCO2Assimilation, vc_GrossCO2AssimilationReference) = code(F_s, vc_LeafAreaIndex);
       fractionOfInterceptedRadiation1 = F_s(vc_LeafAreaIndex) / one_minus_F_t1_val;
-      debug() << "assimilation calculations for smaller crop: grossCO2Assim: " << vc_GrossCO2Assimilation
-        << " ref: " << vc_GrossCO2AssimilationReference << endl;
+      MONICA_DEBUG("assimilation calculations for smaller crop: grossCO2Assim: " << vc_GrossCO2Assimilation
+        << " ref: " << vc_GrossCO2AssimilationReference << endl);
     } else {
-      debug() << "taller crop: dev-stage: " << (vc_DevelopmentalStage + 1)
+      MONICA_DEBUG("taller crop: dev-stage: " << (vc_DevelopmentalStage + 1)
         << " other-crop-height: " << _intercroppingOtherCropHeight
-        << " own-crop-height: " << vc_CropHeight << endl;
+        << " own-crop-height: " << vc_CropHeight << endl);
       // this crop is larger than the other
       double LAI_t2 = max(0.001, phr * vc_LeafAreaIndex);
 
@@ -2597,7 +2604,7 @@ void CropModule::fc_CropPhotosynthesis(double vw_MeanAirTemperature,
         LAI_s = val.isLait()
                   ? val.getLait()
                   : -9999; // throw kj::Exception(kj::Exception::Type::FAILED, "crop-module.cpp", 2724);
-        debug() << "sent LAI_t2: " << LAI_t2 << " received LAI_s: " << LAI_s << endl;
+        MONICA_DEBUG("sent LAI_t2: " << LAI_t2 << " received LAI_s: " << LAI_s << endl);
       }
       // fraction of radiation intercepted for lower plant part
       auto F_t2 = [k_s, k_t, LAI_s, one_minus_F_t1_val](double LAI_t2) {
@@ -2611,8 +2618,8 @@ void CropModule::fc_CropPhotosynthesis(double vw_MeanAirTemperature,
       fractionOfInterceptedRadiation1 = F_t1(LAI_t1);
       fractionOfInterceptedRadiation2 = F_t2(LAI_t2) / one_minus_F_t1_val;
       vc_GrossCO2AssimilationReference = t1.second + t2.second;
-      debug() << "assimilation calculations for taller crop: grossCO2Assim: " << vc_GrossCO2Assimilation
-        << " ref: " << vc_GrossCO2AssimilationReference << endl;
+      MONICA_DEBUG("assimilation calculations for taller crop: grossCO2Assim: " << vc_GrossCO2Assimilation
+        << " ref: " << vc_GrossCO2AssimilationReference << endl);
     }
   }
 
@@ -3050,12 +3057,12 @@ void CropModule::fc_CropDryMatter(double vw_MeanAirTemperature) {
 
           double incr = assimilate_partition_leaf * vc_NetPhotosynthesis;
           if (fabs(incr) <= vc_OrganBiomass[i_Organ]) {
-            debug() << "LEAF - Reducing organ biomass - default case ("
-              << vc_OrganBiomass[i_Organ] + vc_OrganGrowthIncrement[i_Organ] << ")" << endl;
+            MONICA_DEBUG("LEAF - Reducing organ biomass - default case ("
+              << vc_OrganBiomass[i_Organ] + vc_OrganGrowthIncrement[i_Organ] << ")" << endl);
             vc_OrganGrowthIncrement[i_Organ] = incr;
           } else {
             // temporary hack because complex algorithm produces questionable results
-            debug() << "LEAF - Not enough biomass for reduction - Reducing only what is available " << endl;
+            MONICA_DEBUG("LEAF - Not enough biomass for reduction - Reducing only what is available " << endl);
             vc_OrganGrowthIncrement[i_Organ] = (-1) * vc_OrganBiomass[i_Organ];
             //            debug() << "LEAF - Not enough biomass for reduction; Need to calculate new partition coefficient" << endl;
             //            // calculate new partition coefficient to detect, how much of organ biomass
@@ -3075,11 +3082,11 @@ void CropModule::fc_CropDryMatter(double vw_MeanAirTemperature) {
 
           if (fabs(incr) <= vc_OrganBiomass[i_Organ]) {
             vc_OrganGrowthIncrement[i_Organ] = incr;
-            debug() << "SHOOT - Reducing organ biomass - default case ("
-              << vc_OrganBiomass[i_Organ] + vc_OrganGrowthIncrement[i_Organ] << ")" << endl;
+            MONICA_DEBUG("SHOOT - Reducing organ biomass - default case ("
+              << vc_OrganBiomass[i_Organ] + vc_OrganGrowthIncrement[i_Organ] << ")" << endl);
           } else {
             // temporary hack because complex algorithm produces questionable results
-            debug() << "SHOOT - Not enough biomass for reduction - Reducing only what is available " << endl;
+            MONICA_DEBUG("SHOOT - Not enough biomass for reduction - Reducing only what is available " << endl);
             vc_OrganGrowthIncrement[i_Organ] = (-1) * vc_OrganBiomass[i_Organ];
             //            debug() << "SHOOT - Not enough biomass for reduction; Need to calculate new partition coefficient" << endl;
             //
@@ -3329,7 +3336,7 @@ void CropModule::fc_CropDryMatter(double vw_MeanAirTemperature) {
   vc_TotalRootLength = vc_RootBiomass * pc_SpecificRootLength; //[m m-2]
 
   // Calculating a root density distribution factor []
-  std::vector<double> vc_RootDensityFactor;
+  double* vc_RootDensityFactor = nullptr;
   double vc_RootDensityFactorSum = 0.0;
   tie(vc_RootDensityFactor, vc_RootDensityFactorSum) = calcRootDensityFactorAndSum();
 
@@ -3448,12 +3455,12 @@ void CropModule::fc_CropDryMatter(double vw_MeanAirTemperature) {
   }
 }
 
-pair<vector<double>, double> CropModule::calcRootDensityFactorAndSum() {
+pair<double*, double> CropModule::calcRootDensityFactorAndSum() {
   auto nols = soilColumn.vs_NumberOfLayers();
   double layerThickness = soilColumn.vs_LayerThickness();
 
   // Calculating a root density distribution factor []
-  std::vector<double> vc_RootDensityFactor(nols, 0.0);
+  double* vc_RootDensityFactor = scratch.doubles(nols);
   for (size_t i_Layer = 0; i_Layer < nols; i_Layer++) {
     if (i_Layer < vc_RootingDepth) {
       vc_RootDensityFactor[i_Layer] = exp(-pc_RootFormFactor * (i_Layer * layerThickness));
@@ -3861,10 +3868,10 @@ void CropModule::fc_CropNUptake(size_t vc_GroundwaterTable,
 
   double vc_ConvectiveNUptake = 0.0; // old TRNSUM
   double vc_DiffusiveNUptake = 0.0; // old SUMDIFF
-  std::vector<double> vc_ConvectiveNUptakeFromLayer(nols, 0.0); // old MASS
+  double* vc_ConvectiveNUptakeFromLayer = scratch.doubles(nols); // old MASS
 
-  std::vector<double> vc_DiffusionCoeff(nols, 0.0); // old D
-  std::vector<double> vc_DiffusiveNUptakeFromLayer(nols, 0.0); // old DIFF
+  double* vc_DiffusionCoeff = scratch.doubles(nols); // old D
+  double* vc_DiffusiveNUptakeFromLayer = scratch.doubles(nols); // old DIFF
   double vc_ConvectiveNUptake_1 = 0.0; // old MASSUM
   double vc_DiffusiveNUptake_1 = 0.0; // old DIFFSUM
   double pc_MinimumAvailableN = cropPs.pc_MinimumAvailableN; // kg m-3
@@ -3881,7 +3888,7 @@ void CropModule::fc_CropNUptake(size_t vc_GroundwaterTable,
     // if ((vc_CurrentTotalTemperatureSum / vc_TotalTemperatureSum) < 1.0){
 
     for (int i_Layer = 0; i_Layer < (min(vc_RootingZone, vc_GroundwaterTable)); i_Layer++) {
-      vs_SoilMineralNContent[i_Layer] = soilColumn[i_Layer].vs_SoilNO3; // [kg m-3]
+      vs_SoilMineralNContent[i_Layer] = soilColumn[i_Layer].vs_SoilNO3(); // [kg m-3]
 
       // Convective N uptake per layer
       vc_ConvectiveNUptakeFromLayer[i_Layer] = (vc_Transpiration[i_Layer] / 1000.0) * //[mm --> m]
@@ -4712,7 +4719,7 @@ void CropModule::applyCutting(std::map<int, Cutting::Value>& organs,
   double sumCutBiomass = 0.0;
   double currentSLA = get_LeafAreaIndex() / vc_OrganGreenBiomass[OId::LEAF];
 
-  Tools::debug() << "CropModule::applyCutting()" << endl;
+  MONICA_DEBUG("CropModule::applyCutting()" << endl);
 
   if (organs.empty()) {
     for (auto yc : pc_OrganIdsForCutting) {
@@ -4779,9 +4786,9 @@ void CropModule::applyCutting(std::map<int, Cutting::Value>& organs,
 
     double exportBiomass = cutOrganBiomass * exports[organId];
 
-    debug() << "cutting organ with id: " << organId << " with old biomass: " << oldOrganBiomass
+    MONICA_DEBUG("cutting organ with id: " << organId << " with old biomass: " << oldOrganBiomass
       << " exporting percentage: " << (exports[organId] * 100) << "% -> export biomass: " << exportBiomass
-      << " -> residues biomass: " << (cutOrganBiomass - exportBiomass) << endl;
+      << " -> residues biomass: " << (cutOrganBiomass - exportBiomass) << endl);
     vc_AbovegroundBiomass -= cutOrganBiomass;
     sumCutBiomass += cutOrganBiomass;
     sumResidueBiomass += (cutOrganBiomass - exportBiomass);
@@ -4802,16 +4809,16 @@ void CropModule::applyCutting(std::map<int, Cutting::Value>& organs,
   vc_residueCutBiomass = sumResidueBiomass;
   vc_sumResidueCutBiomass += vc_residueCutBiomass;
 
-  debug() << "total cut biomass: " << sumCutBiomass
+  MONICA_DEBUG("total cut biomass: " << sumCutBiomass
     << " exported cut biomass: " << vc_exportedCutBiomass
-    << " residue cut biomass: " << vc_residueCutBiomass << endl;
+    << " residue cut biomass: " << vc_residueCutBiomass << endl);
 
   if (sumResidueBiomass > 0) {
     // prepare to add crop residues to soilorganic (AOMs)
     double residueNConcentration = get_AbovegroundBiomassNConcentration();
-    debug() << "adding organic matter from cut residues to soilOrganic" << endl;
-    debug() << "Residue biomass: " << sumResidueBiomass
-      << " Residue N concentration: " << residueNConcentration << endl;
+    MONICA_DEBUG("adding organic matter from cut residues to soilOrganic" << endl);
+    MONICA_DEBUG("Residue biomass: " << sumResidueBiomass
+      << " Residue N concentration: " << residueNConcentration << endl);
     _addOrganicMatter({{0, sumResidueBiomass}}, residueNConcentration);
   }
 
@@ -4973,7 +4980,7 @@ int CropModule::getMaturityDay() const {
 }
 
 bool CropModule::maturityReached() const {
-  debug() << "vc_MaturityReached: " << vc_MaturityReached << endl;
+  MONICA_DEBUG("vc_MaturityReached: " << vc_MaturityReached << endl);
   return vc_MaturityReached;
 }
 
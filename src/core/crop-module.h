@@ -35,10 +35,14 @@ Copyright (C) Leibniz Centre for Agricultural Landscape Research (ZALF)
 
 #include "monica-parameters.h"
 #include "soilcolumn.h"
+#include "scratch-arena.h"
 #include "voc-common.h"
 #include "run/cultivation-method.h"
 
 namespace monica {
+
+struct StepKernelTimes;
+
 /*
 * @brief  Crop part of model
 *
@@ -55,6 +59,7 @@ namespace monica {
 class CropModule {
 public:
   CropModule(SoilColumn& soilColumn,
+             ScratchArena& scratch,
              const CropParameters& cropParams,
              CropResidueParameters rps,
              bool isWinterCrop,
@@ -67,6 +72,7 @@ public:
              Intercropping& ic);
 
   CropModule(SoilColumn& sc,
+             ScratchArena& scratch,
              const CropModuleParameters& cropPs,
              std::function<void(std::string)> fireEvent,
              std::function<void(std::map<size_t, double>, double)> addOrganicMatter,
@@ -140,7 +146,7 @@ public:
 
   void fc_MoveDeadRootBiomassToSoil(double deadRootBiomass,
                                     double vc_RootDensityFactorSum,
-                                    const std::vector<double>& vc_RootDensityFactor);
+                                    const double* vc_RootDensityFactor);
 
   void addAndDistributeRootBiomassInSoil(double rootBiomass);
 
@@ -411,7 +417,8 @@ public:
 
   double rootNConcentration() const { return vc_NConcentrationRoot; }
 
-  std::pair<std::vector<double>, double> calcRootDensityFactorAndSum();
+  //! the factors are kept in the model's scratch arena for the current day
+  std::pair<double*, double> calcRootDensityFactorAndSum();
 
   void setStage(size_t newStage);
 
@@ -451,6 +458,9 @@ public:
     _intercroppingOtherLAIt = lait;
   }
 
+  //! the model's step kernel times, the crop module adds the time of the hourly FvCB photosynthesis
+  void setStepKernelTimes(StepKernelTimes* times) { stepKernelTimes = times; }
+
   double getFractionOfInterceptedRadiation1() const { return fractionOfInterceptedRadiation1; }
 
   double getFractionOfInterceptedRadiation2() const { return fractionOfInterceptedRadiation2; }
@@ -491,6 +501,8 @@ private:
 
   // members
   SoilColumn& soilColumn;
+  ScratchArena& scratch; //!< the daily scratch buffers of the model
+  StepKernelTimes* stepKernelTimes{nullptr};
   kj::Own<CropParameters> perennialCropParams;
   const CropModuleParameters& cropPs;
   SpeciesParameters speciesPs;
@@ -0,0 +1,65 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+* License, v. 2.0. If a copy of the MPL was not distributed with this
+* file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+/*
+Authors:
+Michael Berg <michael.berg@zalf.de>
+
+Maintainers:
+Currently maintained by the authors.
+
+This file is part of the MONICA model.
+Copyright (C) Leibniz Centre for Agricultural Landscape Research (ZALF)
+*/
+
+#pragma once
+
+#include <iostream>
+
+#include "tools/debug.h"
+
+/*
+ * Debug output for the daily step path.
+ *
+ * MONICA_DEBUG("currentDate: " << currentDate.toString() << std::endl);
+ * streams into Tools::debug(), but the arguments are only evaluated if debug output
+ * has been activated (Tools::activateDebug), so e.g. no strings are formatted otherwise.
+ *
+ * Besides the process wide switch a simulation can ask for debug output just for itself
+ * (Env::debugMode), which is kept per thread (see ThreadDebugMode), so concurrently running
+ * simulations don't switch each other's output.
+ *
+ * If built with the cmake option MONICA_DEBUG_OUTPUT=OFF (defines MONICA_NO_DEBUG_OUTPUT)
+ * the calls are removed completely, the arguments are just type checked.
+ */
+
+namespace monica {
+
+//! debug output switched on for the simulation running on this thread
+inline thread_local bool threadDebugMode = false;
+
+//! sets the debug mode of the current thread for the lifetime of the object
+class ThreadDebugMode {
+public:
+  explicit ThreadDebugMode(bool on) : _previous(threadDebugMode) { threadDebugMode = on; }
+  ~ThreadDebugMode() { threadDebugMode = _previous; }
+
+  ThreadDebugMode(const ThreadDebugMode&) = delete;
+  ThreadDebugMode& operator=(const ThreadDebugMode&) = delete;
+
+private:
+  bool _previous;
+};
+
+} // namespace monica
+
+#ifdef MONICA_NO_DEBUG_OUTPUT
+#define MONICA_DEBUG(...) do { if (false) Tools::debug() << __VA_ARGS__; } while (false)
+#else
+// Tools::debug() is muted unless the process wide switch is on, so a thread's own debug mode writes to std::cout
+#define MONICA_DEBUG(...) do { \
+    if (Tools::activateDebug) Tools::debug() << __VA_ARGS__; \
+    else if (monica::threadDebugMode) std::cout << __VA_ARGS__; \
+  } while (false)
+#endif
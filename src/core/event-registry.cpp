@@ -0,0 +1,109 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+* License, v. 2.0. If a copy of the MPL was not distributed with this
+* file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+/*
+Authors:
+Michael Berg <michael.berg@zalf.de>
+
+Maintainers:
+Currently maintained by the authors.
+
+This file is part of the MONICA model.
+Copyright (C) Leibniz Centre for Agricultural Landscape Research (ZALF)
+*/
+
+#include "event-registry.h"
+
+#include <unordered_map>
+#include <vector>
+
+using namespace monica;
+using namespace std;
+
+namespace {
+
+//! in the order of BuiltinEvent
+const char* const namedEvents[] = {
+  "run-started",
+  "Workstep",
+  "Sowing",
+  "AutomaticSowing",
+  "Transplant",
+  "Harvest",
+  "AutomaticHarvest",
+  "Cutting",
+  "MineralFertilization",
+  "NDemandFertilization",
+  "OrganicFertilization",
+  "Tillage",
+  "SetValue",
+  "SaveMonicaState",
+  "Irrigation",
+  "AutomaticIrrigation",
+  "emergence",
+  "anthesis",
+  "maturity",
+  "cereal-stem-elongation"
+};
+static_assert(sizeof(namedEvents) / sizeof(namedEvents[0]) == STAGE_1_EVENT,
+              "namedEvents has to match BuiltinEvent");
+
+//! filled once on first use and read only afterwards
+struct EventRegistry {
+  EventRegistry() {
+    names.reserve(MAX_NO_OF_EVENT_IDS);
+    for (auto name : namedEvents) names.emplace_back(name);
+    for (size_t stage = 1; stage <= MAX_NO_OF_STAGE_EVENTS; stage++) names.push_back("Stage-" + to_string(stage));
+    for (size_t id = 0; id < names.size(); id++) name2id[names[id]] = EventId(id);
+  }
+
+  unordered_map<string, EventId> name2id;
+  vector<string> names;
+};
+
+const EventRegistry& registry() {
+  static const EventRegistry r;
+  return r;
+}
+
+} // namespace
+
+EventId monica::lookupEvent(const string& name) {
+  const auto& r = registry();
+  auto it = r.name2id.find(name);
+  return it == r.name2id.end() ? NO_EVENT_ID : it->second;
+}
+
+const string& monica::eventName(EventId id) {
+  static const string empty;
+  const auto& r = registry();
+  return id < r.names.size() ? r.names[id] : empty;
+}
+
+//-----------------------------------------------------------------------------
+
+void EventSet::insert(const string& name) {
+  auto id = lookupEvent(name);
+  if (id == NO_EVENT_ID) _notInterned.insert(name);
+  else _ids.set(id);
+}
+
+bool EventSet::contains(const string& name) const {
+  auto id = lookupEvent(name);
+  // a name which isn't a built-in event can only have been kept as string
+  return id == NO_EVENT_ID ? _notInterned.find(name) != _notInterned.end() : _ids.test(id);
+}
+
+void EventSet::clear() {
+  _ids.reset();
+  _notInterned.clear();
+}
+
+set<string> EventSet::names() const {
+  set<string> ns(_notInterned);
+  for (size_t id = 0; id < MAX_NO_OF_EVENT_IDS; id++) {
+    if (_ids.test(id)) ns.insert(eventName(EventId(id)));
+  }
+  return ns;
+}
@@ -0,0 +1,103 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+* License, v. 2.0. If a copy of the MPL was not distributed with this
+* file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+/*
+Authors:
+Michael Berg <michael.berg@zalf.de>
+
+Maintainers:
+Currently maintained by the authors.
+
+This file is part of the MONICA model.
+Copyright (C) Leibniz Centre for Agricultural Landscape Research (ZALF)
+*/
+
+#pragma once
+
+#include <bitset>
+#include <cstddef>
+#include <cstdint>
+#include <set>
+#include <string>
+
+namespace monica {
+
+/*
+ * The events MONICA raises itself (worksteps, crop development) have fixed small integer ids,
+ * so the events of a day can be kept as a bitset and matching an event is just a bit test.
+ * The table of these built-in names is created once and never changes, so lookups don't need a lock.
+ * All other names (e.g. unknown events in an output spec) are kept and matched as strings.
+ */
+
+typedef uint16_t EventId;
+
+//! the ids of the built-in events
+enum BuiltinEvent : EventId {
+  RUN_STARTED_EVENT = 0,
+  WORKSTEP_EVENT,
+  SOWING_EVENT,
+  AUTOMATIC_SOWING_EVENT,
+  TRANSPLANT_EVENT,
+  HARVEST_EVENT,
+  AUTOMATIC_HARVEST_EVENT,
+  CUTTING_EVENT,
+  MINERAL_FERTILIZATION_EVENT,
+  NDEMAND_FERTILIZATION_EVENT,
+  ORGANIC_FERTILIZATION_EVENT,
+  TILLAGE_EVENT,
+  SET_VALUE_EVENT,
+  SAVE_MONICA_STATE_EVENT,
+  IRRIGATION_EVENT,
+  AUTOMATIC_IRRIGATION_EVENT,
+  EMERGENCE_EVENT,
+  ANTHESIS_EVENT,
+  MATURITY_EVENT,
+  CEREAL_STEM_ELONGATION_EVENT,
+  //! "Stage-1" ... "Stage-<MAX_NO_OF_STAGE_EVENTS>" follow
+  STAGE_1_EVENT
+};
+
+//! number of "Stage-n" events with a built-in id
+const size_t MAX_NO_OF_STAGE_EVENTS = 10;
+
+//! number of built-in event ids
+const size_t MAX_NO_OF_EVENT_IDS = STAGE_1_EVENT + MAX_NO_OF_STAGE_EVENTS;
+
+//! returned for names which aren't built-in events
+const EventId NO_EVENT_ID = EventId(MAX_NO_OF_EVENT_IDS);
+
+//! get the id of a built-in event name
+//! @return NO_EVENT_ID if the name isn't a built-in event
+EventId lookupEvent(const std::string& name);
+
+//! the name of a built-in event
+const std::string& eventName(EventId id);
+
+//! the events of one day
+class EventSet {
+public:
+  void insert(EventId id) { if (id < MAX_NO_OF_EVENT_IDS) _ids.set(id); }
+
+  //! names which aren't built-in events are kept as strings
+  void insert(const std::string& name);
+
+  bool contains(EventId id) const { return id < MAX_NO_OF_EVENT_IDS && _ids.test(id); }
+
+  bool contains(const std::string& name) const;
+
+  void clear();
+
+  bool empty() const { return _ids.none() && _notInterned.empty(); }
+
+  size_t size() const { return _ids.count() + _notInterned.size(); }
+
+  //! the event names, e.g. for serialization
+  std::set<std::string> names() const;
+
+private:
+  std::bitset<MAX_NO_OF_EVENT_IDS> _ids;
+  std::set<std::string> _notInterned;
+};
+
+} // namespace monica
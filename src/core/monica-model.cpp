@@ -30,7 +30,10 @@ Copyright (C) Leibniz Centre for Agricultural Landscape Research (ZALF)
 #include <cmath>
 
 #include "tools/debug.h"
+#include "debug-log.h"
 #include "climate/climate-common.h"
+#include "allocation-counter.h"
+#include "step-timer.h"
 //#include "db/abstract-db-connections.h"
 #include "voc-common.h"
 #include "tools/algorithms.h"
@@ -74,7 +77,7 @@ MonicaModel::MonicaModel(const CentralParameterProvider& cpp)
 _soilTemperature(kj::heap<SoilTemperature>(*this, cpp.userSoilTemperatureParameters))
 , _soilMoisture(kj::heap<SoilMoisture>(*this, cpp.userSoilMoistureParameters))
 , _soilOrganic(kj::heap<SoilOrganic>(*_soilColumn, cpp.userSoilOrganicParameters))
-, _soilTransport(kj::heap<SoilTransport>(*_soilColumn, _sitePs, cpp.userSoilTransportParameters,
+, _soilTransport(kj::heap<SoilTransport>(*_soilColumn, _scratchArena, _sitePs, cpp.userSoilTransportParameters,
                                          _envPs.p_LeachingDepth, _envPs.p_timeStep, _cropPs.pc_MinimumAvailableN)) {}
 
 void MonicaModel::deserialize(mas::schema::model::monica::MonicaModelState::Reader reader) {
@@ -94,7 +97,7 @@ void MonicaModel::deserialize(mas::schema::model::monica::MonicaModelState::Read
                                            nconc);
     };
     _currentCropModule = nullptr;
-    _currentCropModule = kj::heap<CropModule>(*_soilColumn, _cropPs,
+    _currentCropModule = kj::heap<CropModule>(*_soilColumn, _scratchArena, _cropPs,
                                               [this](string event) { this->addEvent(event); }, addOMFunc,
                                               [this](double avgAirTemp) {
                                                 return this->soilMoisture().getSnowDepthAndCalcTemperatureUnderSnow(
@@ -102,6 +105,7 @@ void MonicaModel::deserialize(mas::schema::model::monica::MonicaModelState::Read
                                               },
                                               reader.getCurrentCropModule(),
                                               _intercropping);
+    _currentCropModule->setStepKernelTimes(timedStepKernelTimes());
   }
 
   _soilColumn->putCrop(_currentCropModule.get());
@@ -127,7 +131,8 @@ void MonicaModel::deserialize(mas::schema::model::monica::MonicaModelState::Read
     _soilTransport->deserialize(reader.getSoilTransport());
     _soilTransport->putCrop(_currentCropModule.get());
   } else {
-    _soilTransport = kj::heap<SoilTransport>(*_soilColumn, reader.getSoilTransport(), _currentCropModule.get());
+    _soilTransport = kj::heap<SoilTransport>(*_soilColumn, _scratchArena, reader.getSoilTransport(),
+                                             _currentCropModule.get());
   }
 
   _sumFertiliser = reader.getSumFertiliser();
@@ -148,16 +153,16 @@ void MonicaModel::deserialize(mas::schema::model::monica::MonicaModelState::Read
 
   _currentStepDate.deserialize(reader.getCurrentStepDate());
 
-  _climateData.resize(reader.getClimateData().size());
-  {
-    capnp::uint i = 0;
-    for (const auto& mapList : reader.getClimateData()) {
-      auto& acd2val = _climateData[i++];
-      acd2val.clear();
-      for (const auto& readAcd2Val : mapList) {
-        acd2val[Climate::ACD(readAcd2Val.getAcd())] = readAcd2Val.getValue();
-      }
+  _climateHistory.clear();
+  _climateHistory.requireDays(max(size_t(_simPs.noOfPreviousDaysSerializedClimateData),
+                                  size_t(reader.getClimateData().size())));
+  _currentStepClimateData.clear();
+  for (const auto& mapList : reader.getClimateData()) {
+    _currentStepClimateData.clear();
+    for (const auto& readAcd2Val : mapList) {
+      _currentStepClimateData.set(Climate::ACD(readAcd2Val.getAcd()), readAcd2Val.getValue());
     }
+    _climateHistory.push(_currentStepClimateData);
   }
 
   _currentEvents.clear();
@@ -213,13 +218,12 @@ void MonicaModel::serialize(mas::schema::model::monica::MonicaModelState::Builde
 
   _currentStepDate.serialize(builder.initCurrentStepDate());
 
-  auto cdSize = _climateData.size();
-  auto serMaxDays = min(size_t(_simPs.noOfPreviousDaysSerializedClimateData), cdSize);
+  auto serMaxDays = min(size_t(_simPs.noOfPreviousDaysSerializedClimateData), _climateHistory.size());
   auto buildCdList = builder.initClimateData((capnp::uint)serMaxDays);
   {
     capnp::uint i = 0;
-    for (size_t j = cdSize - serMaxDays; j < cdSize; j++) {
-      auto& map = _climateData[j];
+    for (size_t j = serMaxDays; j > 0; j--) {
+      auto map = _climateHistory.daysAgo(j - 1).toMap();
       auto buildList = buildCdList.init(i++, (capnp::uint)map.size());
       capnp::uint k = 0;
       for (auto& p : map) {
@@ -233,7 +237,7 @@ void MonicaModel::serialize(mas::schema::model::monica::MonicaModelState::Builde
   auto buildEvents = builder.initCurrentEvents((capnp::uint)_currentEvents.size());
   {
     capnp::uint i = 0;
-    for (auto& e : _currentEvents) {
+    for (auto& e : _currentEvents.names()) {
       buildEvents.set(i++, e);
     }
   }
@@ -241,7 +245,7 @@ void MonicaModel::serialize(mas::schema::model::monica::MonicaModelState::Builde
   auto buildPrevEvents = builder.initPreviousDaysEvents((capnp::uint)_previousDaysEvents.size());
   {
     capnp::uint i = 0;
-    for (auto& e : _previousDaysEvents) {
+    for (auto& e : _previousDaysEvents.names()) {
       buildPrevEvents.set(i++, e);
     }
   }
@@ -262,7 +266,7 @@ void MonicaModel::serialize(mas::schema::model::monica::MonicaModelState::Builde
 }
 
 void MonicaModel::seedCrop(mas::schema::model::monica::CropSpec::Reader reader) {
-  debug() << "seedCrop" << endl;
+  MONICA_DEBUG("seedCrop" << endl);
 
   p_daysWithCrop = 0;
   p_accuNStress = 0.0;
@@ -283,7 +287,7 @@ void MonicaModel::seedCrop(mas::schema::model::monica::CropSpec::Reader reader)
     };
     CropParameters cps(reader.getCropParams());
     _currentCropModule = nullptr;
-    _currentCropModule = kj::heap<CropModule>(*_soilColumn, cps, reader.getResidueParams(),
+    _currentCropModule = kj::heap<CropModule>(*_soilColumn, _scratchArena, cps, reader.getResidueParams(),
                                               cps.cultivarParams.winterCrop, _sitePs, _cropPs, _simPs,
                                               [this](const string& event) { this->addEvent(event); },
                                               addOMFunc,
@@ -292,6 +296,7 @@ void MonicaModel::seedCrop(mas::schema::model::monica::CropSpec::Reader reader)
                                                    avgAirTemp);
                                               },
                                               _intercropping);
+    _currentCropModule->setStepKernelTimes(timedStepKernelTimes());
 
     //if (crop->separatePerennialCropParameters())
     //  _currentCropModule->setPerennialCropParameters(crop->perennialCropParameters());
@@ -304,7 +309,7 @@ void MonicaModel::seedCrop(mas::schema::model::monica::CropSpec::Reader reader)
     if (_simPs.p_UseNMinMineralFertilisingMethod
         && !_currentCropModule->isWinterCrop()) {
       _soilColumn->clearTopDressingParams();
-      debug() << "nMin fertilising summer crop" << endl;
+      MONICA_DEBUG("nMin fertilising summer crop" << endl);
       double fertAmount = applyMineralFertiliserViaNMinMethod
         (_simPs.p_NMinFertiliserPartition,
          NMinCropParameters(cps.speciesParams.pc_SamplingDepth,
@@ -320,7 +325,7 @@ void MonicaModel::seedCrop(mas::schema::model::monica::CropSpec::Reader reader)
  * @param crop to be planted
  */
 void MonicaModel::seedCrop(Crop* crop) {
-  debug() << "seedCrop" << endl;
+  MONICA_DEBUG("seedCrop" << endl);
 
   p_daysWithCrop = 0;
   p_accuNStress = 0.0;
@@ -338,7 +343,7 @@ void MonicaModel::seedCrop(Crop* crop) {
     };
     auto cps = crop->cropParameters();
     _currentCropModule = nullptr;
-    _currentCropModule = kj::heap<CropModule>(*_soilColumn, cps, crop->residueParameters(),
+    _currentCropModule = kj::heap<CropModule>(*_soilColumn, _scratchArena, cps, crop->residueParameters(),
                                               crop->isWinterCrop(), _sitePs, _cropPs, _simPs,
                                               [this](string event) { this->addEvent(event); }, addOMFunc,
                                               [this](double avgAirTemp) {
@@ -346,6 +351,7 @@ void MonicaModel::seedCrop(Crop* crop) {
                                                    avgAirTemp);
                                               },
                                               _intercropping);
+    _currentCropModule->setStepKernelTimes(timedStepKernelTimes());
 
     if (crop->separatePerennialCropParameters())
       _currentCropModule->
@@ -362,7 +368,7 @@ void MonicaModel::seedCrop(Crop* crop) {
     if (_simPs.p_UseNMinMineralFertilisingMethod
         && !_currentCropModule->isWinterCrop()) {
       _soilColumn->clearTopDressingParams();
-      debug() << "nMin fertilising summer crop" << endl;
+      MONICA_DEBUG("nMin fertilising summer crop" << endl);
       double fert_amount = applyMineralFertiliserViaNMinMethod
         (_simPs.p_NMinFertiliserPartition,
          NMinCropParameters(cps.speciesParams.pc_SamplingDepth,
@@ -386,9 +392,9 @@ void MonicaModel::harvestCurrentCrop(bool exported, const Harvest::Spec& spec,
     // dead root biomass has already been added daily, so just living root biomass is left
     double rootBiomass = _currentCropModule->get_OrganGreenBiomass(0);
     double rootNConcentration = _currentCropModule->get_RootNConcentration();
-    debug() << "adding organic matter from root to soilOrganic" << endl;
-    debug() << "root biomass: " << rootBiomass
-      << " Root N concentration: " << rootNConcentration << endl;
+    MONICA_DEBUG("adding organic matter from root to soilOrganic" << endl);
+    MONICA_DEBUG("root biomass: " << rootBiomass
+      << " Root N concentration: " << rootNConcentration << endl);
     _currentCropModule->addAndDistributeRootBiomassInSoil(rootBiomass);
 
     if (exported && spec.organ2specVal.empty()) {
@@ -442,16 +448,16 @@ void MonicaModel::harvestCurrentCrop(bool exported, const Harvest::Spec& spec,
 
         //!@todo Claas: das hier noch berechnen
         double residueNConcentration = _currentCropModule->get_ResiduesNConcentration();
-        debug() << "adding organic matter from residues to soilOrganic" << endl;
-        debug() << "residue biomass: " << residueBiomass
-          << " Residue N concentration: " << residueNConcentration << endl;
-        debug() << "primary yield biomass: " << _currentCropModule->get_PrimaryCropYield()
-          << " Primary yield N concentration: " << _currentCropModule->get_PrimaryYieldNConcentration() << endl;
-        debug() << "secondary yield biomass: " << _currentCropModule->get_SecondaryCropYield()
-          << " Secondary yield N concentration: " << _currentCropModule->get_PrimaryYieldNConcentration() << endl;
-        debug() << "Residues N content: " << _currentCropModule->get_ResiduesNContent()
+        MONICA_DEBUG("adding organic matter from residues to soilOrganic" << endl);
+        MONICA_DEBUG("residue biomass: " << residueBiomass
+          << " Residue N concentration: " << residueNConcentration << endl);
+        MONICA_DEBUG("primary yield biomass: " << _currentCropModule->get_PrimaryCropYield()
+          << " Primary yield N concentration: " << _currentCropModule->get_PrimaryYieldNConcentration() << endl);
+        MONICA_DEBUG("secondary yield biomass: " << _currentCropModule->get_SecondaryCropYield()
+          << " Secondary yield N concentration: " << _currentCropModule->get_PrimaryYieldNConcentration() << endl);
+        MONICA_DEBUG("Residues N content: " << _currentCropModule->get_ResiduesNContent()
           << " Primary yield N content: " << _currentCropModule->get_PrimaryYieldNContent()
-          << " Secondary yield N content: " << _currentCropModule->get_SecondaryYieldNContent() << endl;
+          << " Secondary yield N content: " << _currentCropModule->get_SecondaryYieldNContent() << endl);
         _soilOrganic->addOrganicMatter(_currentCropModule->residueParameters(),
                                        residueBiomass,
                                        residueNConcentration,
@@ -483,8 +489,7 @@ void MonicaModel::harvestCurrentCrop(bool exported, const Harvest::Spec& spec,
                                      residuesNConcentration,
                                      incorporateIntoLayerIndex);
 
-      debug()
-        << "adding organic matter from residues to soilOrganic"
+      MONICA_DEBUG("adding organic matter from residues to soilOrganic"
         << endl
         << "total residue biomass: " << totalResidueBiomass
         << " residue biomass as overlay: " << sumOrganResidueBiomassAsOverlay
@@ -501,15 +506,15 @@ void MonicaModel::harvestCurrentCrop(bool exported, const Harvest::Spec& spec,
         << " primary yield N content: " << _currentCropModule->get_PrimaryYieldNContent(primaryCropYield)
         << " secondary yield N content: "
         << _currentCropModule->get_SecondaryYieldNContent(primaryCropYield, cropYield - primaryCropYield)
-        << endl;
+        << endl);
     } else {
       //prepare to add the total plant to soilorganic (AOMs)
       double abovegroundBiomass = _currentCropModule->get_AbovegroundBiomass();
       double abovegroundBiomassNConcentration =
         _currentCropModule->get_AbovegroundBiomassNConcentration();
-      debug() << "adding organic matter from aboveground biomass to soilOrganic" << endl;
-      debug() << "aboveground biomass: " << abovegroundBiomass
-        << " Aboveground biomass N concentration: " << abovegroundBiomassNConcentration << endl;
+      MONICA_DEBUG("adding organic matter from aboveground biomass to soilOrganic" << endl);
+      MONICA_DEBUG("aboveground biomass: " << abovegroundBiomass
+        << " Aboveground biomass N concentration: " << abovegroundBiomassNConcentration << endl);
       _soilOrganic->addOrganicMatter(_currentCropModule->residueParameters(),
                                      abovegroundBiomass,
                                      abovegroundBiomassNConcentration,
@@ -533,9 +538,9 @@ void MonicaModel::incorporateCurrentCrop() {
                            _currentCropModule->get_RootNConcentration() * _currentCropModule->get_OrganBiomass(0);
     double totalNConcentration = totalNContent / total_biomass;
 
-    debug() << "Adding organic matter from total biomass of crop to soilOrganic" << endl;
-    debug() << "Total biomass: " << total_biomass << endl
-      << " Total N concentration: " << totalNConcentration << endl;
+    MONICA_DEBUG("Adding organic matter from total biomass of crop to soilOrganic" << endl);
+    MONICA_DEBUG("Total biomass: " << total_biomass << endl
+      << " Total N concentration: " << totalNConcentration << endl);
 
     _soilOrganic->addOrganicMatter(_currentCropModule->residueParameters(),
                                    total_biomass,
@@ -562,7 +567,7 @@ void MonicaModel::applyOrganicFertiliser(const OrganicMatterParameters& params,
                                          double amountFM,
                                          bool incorporation,
                                          int incorporateIntoLayerIndex) {
-  debug() << "MONICA model: applyOrganicFertiliser:\t" << amountFM << "\t" << params.vo_NConcentration << endl;
+  MONICA_DEBUG("MONICA model: applyOrganicFertiliser:\t" << amountFM << "\t" << params.vo_NConcentration << endl);
   _soilOrganic->setIncorporation(incorporation);
   _soilOrganic->addOrganicMatter(params, amountFM, params.vo_NConcentration, incorporateIntoLayerIndex);
   addDailySumOrgFertiliser(amountFM, params);
@@ -604,6 +609,7 @@ void MonicaModel::dailyReset() {
   _optCarbonExportedResidues = 0.0;
   _optCarbonReturnedResidues = 0.0;
   clearEvents();
+  _scratchArena.reset();
 
   if (_clearCropUponNextDay) {
     _soilTransport->removeCrop();
@@ -635,7 +641,27 @@ void MonicaModel::applyTillage(double depth) {
   _soilColumn->applyTillage(depth);
 }
 
+void MonicaModel::setStepKernelsTimed(bool timed) {
+  _stepKernelsTimed = timed;
+  if (_currentCropModule) _currentCropModule->setStepKernelTimes(timedStepKernelTimes());
+}
+
 void MonicaModel::step() {
+  beginStep();
+  {
+    StepKernelTimer t(SOIL_TEMPERATURE_STEP, timedStepKernelTimes());
+    _soilTemperature->solve();
+  }
+  midStep();
+  {
+    StepKernelTimer t(SOIL_TRANSPORT_STEP, timedStepKernelTimes());
+    _soilTransport->transport();
+  }
+  endStep();
+}
+
+void MonicaModel::beginStep() {
+  _allocationCountAtStepStart = threadAllocationCount();
   if (isCropPlanted() && !_clearCropUponNextDay) {
     cropStep();
   } else if (_intercropping.isAsync()) {
@@ -643,18 +669,18 @@ void MonicaModel::step() {
     auto wreq = _intercropping.writer.writeRequest();
     auto wval = wreq.initValue();
     wval.setNoCrop();
-    debug() << "MonicaModel::step -> send no-crop" << std::endl;
+    MONICA_DEBUG("MonicaModel::step -> send no-crop" << std::endl);
     auto prom = wreq.send(); //.wait(_intercropping.ioContext->waitScope);
     //prom.eagerlyEvaluate(nullptr); //[](kj::Exception&& ex){ cout << "MonicaModel::step write noCrop failed: " << ex.getDescription().cStr() << endl;});
     // wait for other sides crop height or no crop info
     auto val = _intercropping.reader.readRequest().send().wait(_intercropping.ioContext->waitScope).getValue();
-    debug() << "MonicaModel::step -> sent no-crop, received ";
-    if (val.isHeight()) cout << " height: " << val.getHeight() << endl;
-    else if (val.isNoCrop()) cout << "no-crop" << endl;
-    else if (val.isLait()) cout << " LAI_t: " << val.getLait() << " ---> Error: shouldn't happen." << endl;
+    MONICA_DEBUG("MonicaModel::step -> sent no-crop, received ");
+    if (val.isHeight()) MONICA_DEBUG(" height: " << val.getHeight() << endl);
+    else if (val.isNoCrop()) MONICA_DEBUG("no-crop" << endl);
+    else if (val.isLait()) MONICA_DEBUG(" LAI_t: " << val.getLait() << " ---> Error: shouldn't happen." << endl);
   }
 
-  generalStep();
+  beginGeneralStep();
 }
 
 /**
@@ -662,23 +688,29 @@ void MonicaModel::step() {
  * @param stepNo Number of current processed step
  */
 void MonicaModel::generalStep() {
+  _allocationCountAtStepStart = threadAllocationCount();
+  beginGeneralStep();
+  {
+    StepKernelTimer t(SOIL_TEMPERATURE_STEP, timedStepKernelTimes());
+    _soilTemperature->solve();
+  }
+  midStep();
+  {
+    StepKernelTimer t(SOIL_TRANSPORT_STEP, timedStepKernelTimes());
+    _soilTransport->transport();
+  }
+  endStep();
+}
+
+void MonicaModel::beginGeneralStep() {
   auto date = _currentStepDate;
   unsigned int julday = date.julianDay();
   bool leapYear = date.isLeapYear();
 
-  auto climateData = currentStepClimateData();
-  double tmin = climateData[Climate::tmin];
-  double tavg = climateData[Climate::tavg];
-  double tmax = climateData[Climate::tmax];
-  double precip = climateData[Climate::precip];
-  double wind = climateData[Climate::wind];
-  double globrad = climateData[Climate::globrad];
-
-  // test if data for relhumid are available; if not, value is set to -1.0
-  double relhumid = climateData.find(Climate::relhumid) == climateData.end()
-                      ? -1.0
-                      : climateData[Climate::relhumid];
-
+  const auto& climateData = currentStepClimateData();
+  double tmin = climateData.get(Climate::tmin);
+  double tmax = climateData.get(Climate::tmax);
+  double globrad = climateData.get(Climate::globrad);
 
   // test if simulated gw or measured values should be used
   auto gw_value_p = _groundwaterInformation.getGroundwaterInformation(date);
@@ -692,9 +724,8 @@ void MonicaModel::generalStep() {
                                                     leapYear);
 
   // first try to get CO2 concentration from climate data
-  auto co2it = climateData.find(Climate::co2);
-  if (co2it != climateData.end()) {
-    vw_AtmosphericCO2Concentration = co2it->second;
+  if (climateData.has(Climate::co2)) {
+    vw_AtmosphericCO2Concentration = climateData.values[Climate::co2];
   } else {
     // try to get yearly values from UserEnvironmentParameters
     auto co2sit = _envPs.p_AtmosphericCO2s.find(date.year());
@@ -723,7 +754,7 @@ void MonicaModel::generalStep() {
       && _currentCropModule->isWinterCrop()
       && julday == _simPs.p_JulianDayAutomaticFertilising) {
     _soilColumn->clearTopDressingParams();
-    debug() << "nMin fertilising winter crop" << endl;
+    MONICA_DEBUG("nMin fertilising winter crop" << endl);
     auto sps = _currentCropModule->speciesParameters();
     double fertilizerAmount = applyMineralFertiliserViaNMinMethod
       (_simPs.p_NMinFertiliserPartition,
@@ -731,18 +762,47 @@ void MonicaModel::generalStep() {
     addDailySumFertiliser(fertilizerAmount);
   }
 
-  _soilTemperature->step(tmin, tmax, globrad);
+  StepKernelTimer t(SOIL_TEMPERATURE_STEP, timedStepKernelTimes());
+  _soilTemperature->prepareStep(tmin, tmax, globrad);
+}
 
+void MonicaModel::midStep() {
+  {
+    StepKernelTimer t(SOIL_TEMPERATURE_STEP, timedStepKernelTimes());
+    _soilTemperature->finishStep();
+  }
+
+  const auto& climateData = currentStepClimateData();
+  double tmin = climateData.get(Climate::tmin, 0.0);
+  double tavg = climateData.get(Climate::tavg, 0.0);
+  double tmax = climateData.get(Climate::tmax, 0.0);
+  double precip = climateData.get(Climate::precip, 0.0);
+  double wind = climateData.get(Climate::wind, 0.0);
+  double globrad = climateData.get(Climate::globrad, 0.0);
+  double relhumid = climateData.get(Climate::relhumid, -1.0);
   // first try to get ReferenceEvapotranspiration from climate data
-  auto et0_it = climateData.find(Climate::et0);
-  double et0 = et0_it == climateData.end() ? -1.0 : et0_it->second;
+  double et0 = climateData.get(Climate::et0, -1.0);
 
-  _soilMoisture->step(vs_GroundwaterDepth, precip, tmax, tmin,
-                      (relhumid / 100.0), tavg, wind, _envPs.p_WindSpeedHeight, globrad,
-                      julday, et0);
+  {
+    StepKernelTimer t(SOIL_MOISTURE_STEP, timedStepKernelTimes());
+    _soilMoisture->step(vs_GroundwaterDepth, precip, tmax, tmin,
+                        (relhumid / 100.0), tavg, wind, _envPs.p_WindSpeedHeight, globrad,
+                        _currentStepDate.julianDay(), et0);
+  }
+  {
+    StepKernelTimer t(SOIL_ORGANIC_STEP, timedStepKernelTimes());
+    _soilOrganic->step(tavg, precip, wind);
+  }
+  StepKernelTimer t(SOIL_TRANSPORT_STEP, timedStepKernelTimes());
+  _soilTransport->prepareStep();
+}
 
-  _soilOrganic->step(tavg, precip, wind);
-  _soilTransport->step();
+void MonicaModel::endStep() {
+  {
+    StepKernelTimer t(SOIL_TRANSPORT_STEP, timedStepKernelTimes());
+    _soilTransport->finishStep();
+  }
+  _allocationsOfLastStep = threadAllocationCount() - _allocationCountAtStepStart;
 }
 
 pair<double, double> laiSunShade(double latitude, int doy, int hour, double lai) {
@@ -765,7 +825,7 @@ pair<double, double> laiSunShade(double latitude, int doy, int hour, double lai)
 
 void MonicaModel::cropStep() {
   auto date = _currentStepDate;
-  auto climateData = currentStepClimateData();
+  const auto& climateData = currentStepClimateData();
 
   // do nothing if there is no crop
   if (!_currentCropModule) return;
@@ -774,15 +834,14 @@ void MonicaModel::cropStep() {
 
   unsigned int julday = date.julianDay();
 
-  double tavg = climateData[Climate::tavg];
-  double tmax = climateData[Climate::tmax];
-  double tmin = climateData[Climate::tmin];
-  double globrad = climateData[Climate::globrad];
+  double tavg = climateData.get(Climate::tavg);
+  double tmax = climateData.get(Climate::tmax);
+  double tmin = climateData.get(Climate::tmin);
+  double globrad = climateData.get(Climate::globrad);
 
   // first try to get CO2 concentration from climate data
-  auto o3it = climateData.find(Climate::o3);
-  if (o3it != climateData.end()) {
-    vw_AtmosphericO3Concentration = o3it->second;
+  if (climateData.has(Climate::o3)) {
+    vw_AtmosphericO3Concentration = climateData.values[Climate::o3];
   } else {
     // try to get yearly values from UserEnvironmentParameters
     auto o3sit = _envPs.p_AtmosphericO3s.find(date.year());
@@ -795,37 +854,36 @@ void MonicaModel::cropStep() {
   }
 
   // test if data for sunhours are available; if not, value is set to -1.0
-  auto sunhit = climateData.find(Climate::sunhours);
-  double sunhours = sunhit == climateData.end() ? -1.0 : sunhit->second;
+  double sunhours = climateData.get(Climate::sunhours, -1.0);
 
   // test if data for relhumid are available; if not, value is set to -1.0
-  auto rhit = climateData.find(Climate::relhumid);
-  double relhumid = rhit == climateData.end() ? -1.0 : rhit->second;
+  double relhumid = climateData.get(Climate::relhumid, -1.0);
 
-  auto wind_it = climateData.find(Climate::wind);
-  double wind = wind_it == climateData.end() ? -1.0 : wind_it->second;
+  double wind = climateData.get(Climate::wind, -1.0);
 
-  double precip = climateData[Climate::precip];
+  double precip = climateData.get(Climate::precip);
 
   // check if reference evapotranspiration was provided via climate files
-  auto et0_it = climateData.find(Climate::et0);
-  double et0 = et0_it == climateData.end() ? -1.0 : et0_it->second;
+  double et0 = climateData.get(Climate::et0, -1.0);
 
   double vw_WindSpeedHeight = _envPs.p_WindSpeedHeight;
 
-  _currentCropModule->step(tavg,
-                           tmax,
-                           tmin,
-                           globrad,
-                           sunhours,
-                           date,
-                           (relhumid / 100.0),
-                           wind,
-                           vw_WindSpeedHeight,
-                           vw_AtmosphericCO2Concentration,
-                           vw_AtmosphericO3Concentration,
-                           precip,
-                           et0);
+  {
+    StepKernelTimer t(CROP_MODULE_STEP, timedStepKernelTimes());
+    _currentCropModule->step(tavg,
+                             tmax,
+                             tmin,
+                             globrad,
+                             sunhours,
+                             date,
+                             (relhumid / 100.0),
+                             wind,
+                             vw_WindSpeedHeight,
+                             vw_AtmosphericCO2Concentration,
+                             vw_AtmosphericO3Concentration,
+                             precip,
+                             et0);
+  }
   if (_simPs.p_UseAutomaticIrrigation
       && (!_simPs.p_AutoIrrigationParams.startDate.isValid() || _simPs.p_AutoIrrigationParams.startDate <= date)
       && (!_simPs.p_AutoIrrigationParams.endDate.isValid() || date <= _simPs.p_AutoIrrigationParams.endDate)) {
@@ -956,6 +1014,13 @@ double MonicaModel::GroundwaterDepthForDate(double maxGroundwaterDepth,
   return groundwaterDepth;
 }
 
+void MonicaModel::setCurrentStepClimateData(const ClimateStep& cd) {
+  _currentStepClimateData = cd;
+  // the number of days to serialize might have been changed since the last step
+  _climateHistory.requireDays(size_t(_simPs.noOfPreviousDaysSerializedClimateData));
+  _climateHistory.push(cd);
+}
+
 void MonicaModel::clearEvents() {
   _previousDaysEvents = _currentEvents;
   _currentEvents.clear();
@@ -48,6 +48,9 @@ Copyright (C) Leibniz Centre for Agricultural Landscape Research (ZALF)
 #include "soilmoisture.h"
 #include "crop-module.h"
 #include "soilcolumn.h"
+#include "climate-history.h"
+#include "event-registry.h"
+#include "step-timer.h"
 
 namespace monica {
 class Crop;
@@ -66,6 +69,20 @@ public:
 
   void generalStep();
 
+  //! heap allocations of the last step (begin to end), only counted if built with MONICA_COUNT_ALLOCATIONS
+  size_t allocationsOfLastStep() const { return _allocationsOfLastStep; }
+
+  //! time the step kernels of this model (e.g. for the perf-ns-* outputs), off by default
+  void setStepKernelsTimed(bool timed);
+  bool stepKernelsTimed() const { return _stepKernelsTimed; }
+
+  //! cumulative times of the step kernels since the model's creation, only timed if the model's step kernels are timed
+  const StepKernelTimes& stepKernelTimes() const { return _stepKernelTimes; }
+  StepKernelTimes& stepKernelTimesNC() { return _stepKernelTimes; }
+
+  //! the times the step kernel timers of this model add to, nullptr if the model isn't timed
+  StepKernelTimes* timedStepKernelTimes() { return _stepKernelsTimed ? &_stepKernelTimes : nullptr; }
+
   void cropStep();
 
   static double CO2ForDate(double year, double julianDay, bool isLeapYear,
@@ -175,15 +192,18 @@ public:
   Tools::Date currentStepDate() const { return _currentStepDate; }
   void setCurrentStepDate(Tools::Date d) { _currentStepDate = d; }
 
-  const std::map<Climate::ACD, double>& currentStepClimateData() const { return _climateData.back(); }
-  void setCurrentStepClimateData(const std::map<Climate::ACD, double>& cd) { _climateData.push_back(cd); }
+  const ClimateStep& currentStepClimateData() const { return _currentStepClimateData; }
+  void setCurrentStepClimateData(const ClimateStep& cd);
 
-  const std::vector<std::map<Climate::ACD, double>>& climateData() const { return _climateData; }
+  //! the climate data of the last days, worksteps looking back have to register the days they need
+  const ClimateHistory& climateHistory() const { return _climateHistory; }
+  ClimateHistory& climateHistoryNC() { return _climateHistory; }
 
-  void addEvent(std::string e) { _currentEvents.insert(e); }
+  void addEvent(const std::string& e) { _currentEvents.insert(e); }
+  void addEvent(EventId e) { _currentEvents.insert(e); }
   void clearEvents();
-  const std::set<std::string>& currentEvents() const { return _currentEvents; }
-  const std::set<std::string>& previousDaysEvents() const { return _previousDaysEvents; }
+  const EventSet& currentEvents() const { return _currentEvents; }
+  const EventSet& previousDaysEvents() const { return _previousDaysEvents; }
 
   int cultivationMethodCount() const { return _cultivationMethodCount; }
 
@@ -197,12 +217,22 @@ public:
   void setOtherCropHeightAndLAIt(double cropHeight, double lait);
 
 private:
+  //! step() split at the soil kernels:
+  //! beginStep(), soil temperature solve(), midStep(), soil transport transport(), endStep()
+  void beginStep();
+  void midStep();
+  void endStep();
+
+  //! generalStep() up to the prepared soil temperature equation system
+  void beginGeneralStep();
+
   SiteParameters _sitePs;
   EnvironmentParameters _envPs;
   CropModuleParameters _cropPs;
   SimulationParameters _simPs;
   MeasuredGroundwaterTableInformation _groundwaterInformation;
 
+  ScratchArena _scratchArena; //!< scratch buffers of the modules, valid for the current day
   kj::Own<SoilColumn> _soilColumn; //!< main soil data structure
   kj::Own<SoilTemperature> _soilTemperature; //!< temperature code
   kj::Own<SoilMoisture> _soilMoisture; //!< moisture code
@@ -229,12 +259,18 @@ private:
   double _optCarbonReturnedResidues{0.0};
 
   Tools::Date _currentStepDate;
-  std::vector<std::map<Climate::ACD, double>> _climateData;
-  std::set<std::string> _currentEvents;
-  std::set<std::string> _previousDaysEvents;
+  ClimateStep _currentStepClimateData;
+  ClimateHistory _climateHistory;
+  EventSet _currentEvents;
+  EventSet _previousDaysEvents;
 
   bool _clearCropUponNextDay{false};
 
+  size_t _allocationCountAtStepStart{0};
+  size_t _allocationsOfLastStep{0};
+  StepKernelTimes _stepKernelTimes;
+  bool _stepKernelsTimed{false};
+
   int p_daysWithCrop{0};
   double p_accuNStress{0.0};
   double p_accuWaterStress{0.0};
@@ -0,0 +1,53 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+* License, v. 2.0. If a copy of the MPL was not distributed with this
+* file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+/*
+Authors:
+Michael Berg <michael.berg@zalf.de>
+
+Maintainers:
+Currently maintained by the authors.
+
+This file is part of the MONICA model.
+Copyright (C) Leibniz Centre for Agricultural Landscape Research (ZALF)
+*/
+
+#include "scratch-arena.h"
+
+#include <algorithm>
+
+using namespace monica;
+using namespace std;
+
+double* ScratchArena::doubles(size_t n, double value) {
+  // find the next block with enough space left, the blocks are only added while warming up
+  while (_currentBlock < _blocks.size() && _offset + n > _blocks[_currentBlock].size) {
+    _currentBlock++;
+    _offset = 0;
+  }
+  if (_currentBlock == _blocks.size()) {
+    auto size = max(n, _blocks.empty() ? _initialSize : 2 * _blocks.back().size);
+    _blocks.push_back({make_unique<double[]>(size), size});
+    _offset = 0;
+  }
+
+  double* p = _blocks[_currentBlock].data.get() + _offset;
+  _offset += n;
+  _used += n;
+  fill_n(p, n, value);
+  return p;
+}
+
+void ScratchArena::reset() {
+  // a day needed more than one block, so replace them by a single block big enough for the whole day
+  if (_blocks.size() > 1) {
+    size_t size = 0;
+    for (const auto& b : _blocks) size += b.size;
+    _blocks.clear();
+    _blocks.push_back({make_unique<double[]>(size), size});
+  }
+  _currentBlock = 0;
+  _offset = 0;
+  _used = 0;
+}
@@ -0,0 +1,59 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+* License, v. 2.0. If a copy of the MPL was not distributed with this
+* file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+/*
+Authors:
+Michael Berg <michael.berg@zalf.de>
+
+Maintainers:
+Currently maintained by the authors.
+
+This file is part of the MONICA model.
+Copyright (C) Leibniz Centre for Agricultural Landscape Research (ZALF)
+*/
+
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+namespace monica {
+
+/*
+ * Bump allocator for the scratch buffers the kernels of one MonicaModel need during a day.
+ *
+ * Memory handed out stays valid until reset(), which MonicaModel::dailyReset() calls once per day.
+ * The memory is kept over reset(), so after the first days stepping doesn't allocate on the heap anymore.
+ */
+class ScratchArena {
+public:
+  explicit ScratchArena(size_t initialSize = 4096) : _initialSize(initialSize) {}
+
+  ScratchArena(const ScratchArena&) = delete;
+  ScratchArena& operator=(const ScratchArena&) = delete;
+
+  //! n doubles set to value
+  double* doubles(size_t n, double value = 0.0);
+
+  //! forget all buffers handed out since the last reset
+  void reset();
+
+  //! number of doubles handed out since the last reset
+  size_t used() const { return _used; }
+
+private:
+  struct Block {
+    std::unique_ptr<double[]> data;
+    size_t size{0};
+  };
+
+  size_t _initialSize{0};
+  std::vector<Block> _blocks;
+  size_t _currentBlock{0};
+  size_t _offset{0}; //!< position in the current block
+  size_t _used{0};
+};
+
+} // namespace monica
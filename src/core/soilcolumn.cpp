@@ -97,47 +97,89 @@ void AOM_Properties::serialize(mas::schema::model::monica::AOMProperties::Builde
 SoilLayer::SoilLayer(double vs_LayerThickness,
                      const SoilParameters& sps)
 : vs_LayerThickness(vs_LayerThickness)
-, vs_SoilNH4(sps.vs_SoilAmmonium)
-, vs_SoilNO3(sps.vs_SoilNitrate)
-, _sps(sps)
-, vs_SoilMoisture_m3(sps.vs_FieldCapacity * sps.vs_SoilMoisturePercentFC / 100.0)
-//, vs_SoilMoistureOld_m3(sps.vs_FieldCapacity * sps.vs_SoilMoisturePercentFC / 100.0)
-{}
+, _sps(sps) {
+  _hot[SOIL_NH4] = sps.vs_SoilAmmonium;
+  _hot[SOIL_NO3] = sps.vs_SoilNitrate;
+  _hot[SOIL_MOISTURE] = sps.vs_FieldCapacity * sps.vs_SoilMoisturePercentFC / 100.0;
+  //vs_SoilMoistureOld_m3 = sps.vs_FieldCapacity * sps.vs_SoilMoisturePercentFC / 100.0;
+}
+
+SoilLayer::SoilLayer(const SoilLayer& other) {
+  copyColdFrom(other);
+  for (int v = 0; v < _NO_OF_SOIL_LAYER_VARS_; v++) _hot[v] = other.hot(SoilLayerVar(v));
+}
+
+SoilLayer::SoilLayer(SoilLayer&& other) noexcept
+: vs_LayerThickness(other.vs_LayerThickness)
+, vs_SoilWaterFlux(other.vs_SoilWaterFlux)
+, vo_AOM_Pool(std::move(other.vo_AOM_Pool))
+, vs_SoilFrozen(other.vs_SoilFrozen)
+, _sps(std::move(other._sps))
+, _states(other._states)
+, _index(other._index) {
+  for (int v = 0; v < _NO_OF_SOIL_LAYER_VARS_; v++) _hot[v] = other._hot[v];
+}
+
+SoilLayer& SoilLayer::operator=(const SoilLayer& other) {
+  if (this == &other) return *this;
+  copyColdFrom(other);
+  for (int v = 0; v < _NO_OF_SOIL_LAYER_VARS_; v++) hot(SoilLayerVar(v)) = other.hot(SoilLayerVar(v));
+  return *this;
+}
+
+SoilLayer& SoilLayer::operator=(SoilLayer&& other) noexcept {
+  if (this == &other) return *this;
+  vs_LayerThickness = other.vs_LayerThickness;
+  vs_SoilWaterFlux = other.vs_SoilWaterFlux;
+  vo_AOM_Pool = std::move(other.vo_AOM_Pool);
+  vs_SoilFrozen = other.vs_SoilFrozen;
+  _sps = std::move(other._sps);
+  for (int v = 0; v < _NO_OF_SOIL_LAYER_VARS_; v++) hot(SoilLayerVar(v)) = other.hot(SoilLayerVar(v));
+  return *this;
+}
+
+void SoilLayer::copyColdFrom(const SoilLayer& other) {
+  vs_LayerThickness = other.vs_LayerThickness;
+  vs_SoilWaterFlux = other.vs_SoilWaterFlux;
+  vo_AOM_Pool = other.vo_AOM_Pool;
+  vs_SoilFrozen = other.vs_SoilFrozen;
+  _sps = other._sps;
+}
 
 void SoilLayer::deserialize(mas::schema::model::monica::SoilLayerState::Reader reader) {
   vs_LayerThickness = reader.getLayerThickness();
   vs_SoilWaterFlux = reader.getSoilWaterFlux();
   setFromComplexCapnpList(vo_AOM_Pool, reader.getVoAOMPool());
-  vs_SOM_Slow = reader.getSomSlow();
-  vs_SOM_Fast = reader.getSomFast();
-  vs_SMB_Slow = reader.getSmbSlow();
-  vs_SMB_Fast = reader.getSmbFast();
-  vs_SoilCarbamid = reader.getSoilCarbamid();
-  vs_SoilNH4 = reader.getSoilNH4();
-  vs_SoilNO2 = reader.getSoilNO2();
-  vs_SoilNO3 = reader.getSoilNO3();
+  hot(SOM_SLOW) = reader.getSomSlow();
+  hot(SOM_FAST) = reader.getSomFast();
+  hot(SMB_SLOW) = reader.getSmbSlow();
+  hot(SMB_FAST) = reader.getSmbFast();
+  hot(SOIL_CARBAMID) = reader.getSoilCarbamid();
+  hot(SOIL_NH4) = reader.getSoilNH4();
+  hot(SOIL_NO2) = reader.getSoilNO2();
+  hot(SOIL_NO3) = reader.getSoilNO3();
   vs_SoilFrozen = reader.getSoilFrozen();
   _sps.deserialize(reader.getSps());
-  vs_SoilMoisture_m3 = reader.getSoilMoistureM3();
-  vs_SoilTemperature = reader.getSoilTemperature();
+  hot(SOIL_MOISTURE) = reader.getSoilMoistureM3();
+  hot(SOIL_TEMPERATURE) = reader.getSoilTemperature();
 }
 
 void SoilLayer::serialize(mas::schema::model::monica::SoilLayerState::Builder builder) const {
   builder.setLayerThickness(vs_LayerThickness);
   builder.setSoilWaterFlux(vs_SoilWaterFlux);
   setComplexCapnpList(vo_AOM_Pool, builder.initVoAOMPool((capnp::uint)vo_AOM_Pool.size()));
-  builder.setSomSlow(vs_SOM_Slow);
-  builder.setSomFast(vs_SOM_Fast);
-  builder.setSmbSlow(vs_SMB_Slow);
-  builder.setSmbFast(vs_SMB_Fast);
-  builder.setSoilCarbamid(vs_SoilCarbamid);
-  builder.setSoilNH4(vs_SoilNH4);
-  builder.setSoilNO2(vs_SoilNO2);
-  builder.setSoilNO3(vs_SoilNO3);
+  builder.setSomSlow(hot(SOM_SLOW));
+  builder.setSomFast(hot(SOM_FAST));
+  builder.setSmbSlow(hot(SMB_SLOW));
+  builder.setSmbFast(hot(SMB_FAST));
+  builder.setSoilCarbamid(hot(SOIL_CARBAMID));
+  builder.setSoilNH4(hot(SOIL_NH4));
+  builder.setSoilNO2(hot(SOIL_NO2));
+  builder.setSoilNO3(hot(SOIL_NO3));
   builder.setSoilFrozen(vs_SoilFrozen);
   _sps.serialize(builder.initSps());
-  builder.setSoilMoistureM3(vs_SoilMoisture_m3);
-  builder.setSoilTemperature(vs_SoilTemperature);
+  builder.setSoilMoistureM3(hot(SOIL_MOISTURE));
+  builder.setSoilTemperature(hot(SOIL_TEMPERATURE));
 }
 
 /**
@@ -186,6 +228,7 @@ SoilColumn::SoilColumn(double ps_LayerThickness,
   //, pm_CriticalMoistureDepth(pm_CriticalMoistureDepth) {
   debug() << "Constructor: SoilColumn " << soilParams.size() << endl;
   for (const auto& sp : soilParams) push_back(SoilLayer(ps_LayerThickness, sp));
+  attachLayers();
 
   _vs_NumberOfOrganicLayers = calculateNumberOfOrganicLayers();
 }
@@ -206,6 +249,7 @@ void SoilColumn::deserialize(mas::schema::model::monica::SoilColumnState::Reader
   setFromComplexCapnpList(_delayedNMinApplications, reader.getDelayedNMinApplications());
   //pm_CriticalMoistureDepth = reader.getPmCriticalMoistureDepth();
   setFromComplexCapnpList(*this, reader.getLayers());
+  attachLayers();
 }
 
 void SoilColumn::serialize(mas::schema::model::monica::SoilColumnState::Builder builder) const {
@@ -228,6 +272,35 @@ void SoilColumn::serialize(mas::schema::model::monica::SoilColumnState::Builder
 }
 
 
+void SoilLayerStates::resize(size_t nols) {
+  for (auto& v : vars) v.resize(nols);
+  layerThickness.resize(nols);
+  fieldCapacity.resize(nols);
+  saturation.resize(nols);
+  permanentWiltingPoint.resize(nols);
+  lambda.resize(nols);
+}
+
+void SoilColumn::attachLayers() {
+  const auto nols = size();
+  // layers already referring to _layerStates keep their values, as resize preserves them
+  _layerStates.resize(nols);
+  for (size_t i = 0; i < nols; i++) {
+    auto& layer = at(i);
+    for (int v = 0; v < _NO_OF_SOIL_LAYER_VARS_; v++) {
+      _layerStates.vars[v][i] = layer.hot(SoilLayerVar(v));
+    }
+    layer._states = &_layerStates;
+    layer._index = i;
+
+    _layerStates.layerThickness[i] = layer.vs_LayerThickness;
+    _layerStates.fieldCapacity[i] = layer.vs_FieldCapacity();
+    _layerStates.saturation[i] = layer.vs_Saturation();
+    _layerStates.permanentWiltingPoint[i] = layer.vs_PermanentWiltingPoint();
+    _layerStates.lambda[i] = layer.vs_Lambda();
+  }
+}
+
 /**
  * @brief Calculates number of organic layers.
  *
@@ -264,7 +337,7 @@ double SoilColumn::applyMineralFertiliserViaNDemand(MineralFertilizerParameters
     depthCm += int(layerSize * 100.0);
 
     //convert [kg N m-3] to [kg N ha-1]
-    sumSoilNkgHa += (at(i).vs_SoilNO3 + at(i).vs_SoilNH4) * 10000.0 * layerSize;
+    sumSoilNkgHa += (at(i).vs_SoilNO3() + at(i).vs_SoilNH4()) * 10000.0 * layerSize;
 
     if (depthCm >= int(demandDepth * 100)) break;
 
@@ -321,8 +394,8 @@ applyMineralFertiliserViaNMinMethod(MineralFertilizerParameters fp,
   for (int i_Layer = 0;
        i_Layer < layerSamplingDepth /*(ceil(vf_SamplingDepth / at(i_Layer).vs_LayerThickness))*/; i_Layer++) {
     //vf_TargetLayer is in cm. We want number of layers
-    vf_SoilNO3Sum += at(i_Layer).vs_SoilNO3; //! [kg N m-3]
-    vf_SoilNH4Sum += at(i_Layer).vs_SoilNH4; //! [kg N m-3]
+    vf_SoilNO3Sum += at(i_Layer).vs_SoilNO3(); //! [kg N m-3]
+    vf_SoilNH4Sum += at(i_Layer).vs_SoilNH4(); //! [kg N m-3]
   }
 
   double vf_SoilNO3Sum30 = 0.0;
@@ -330,8 +403,8 @@ applyMineralFertiliserViaNMinMethod(MineralFertilizerParameters fp,
   // Same calculation for a depth of 30 cm
   /** @todo Must be adapted when using variable layer depth. */
   for (int i_Layer = 0; i_Layer < vf_Layer30cm; i_Layer++) {
-    vf_SoilNO3Sum30 += at(i_Layer).vs_SoilNO3; //! [kg N m-3]
-    vf_SoilNH4Sum30 += at(i_Layer).vs_SoilNH4; //! [kg N m-3]
+    vf_SoilNO3Sum30 += at(i_Layer).vs_SoilNO3(); //! [kg N m-3]
+    vf_SoilNH4Sum30 += at(i_Layer).vs_SoilNH4(); //! [kg N m-3]
   }
 
   // Converts [kg N ha-1] to [kg N m-3]
@@ -430,9 +503,9 @@ void SoilColumn::applyMineralFertiliser(MineralFertilizerParameters fp,
     << " amount: " << amount << endl;
   // [kg N ha-1 -> kg m-3]
   double kgHaTokgm3 = 10000.0 * at(0).vs_LayerThickness;
-  at(0).vs_SoilNO3 += amount * fp.getNO3() / kgHaTokgm3;
-  at(0).vs_SoilNH4 += amount * fp.getNH4() / kgHaTokgm3;
-  at(0).vs_SoilCarbamid += amount * fp.getCarbamid() / kgHaTokgm3;
+  at(0).vs_SoilNO3() += amount * fp.getNO3() / kgHaTokgm3;
+  at(0).vs_SoilNH4() += amount * fp.getNH4() / kgHaTokgm3;
+  at(0).vs_SoilCarbamid() += amount * fp.getCarbamid() / kgHaTokgm3;
 }
 
 
@@ -446,7 +519,13 @@ void SoilColumn::applyMineralFertiliser(MineralFertilizerParameters fp,
  * @author: Claas Nendel
  */
 void SoilColumn::deleteAOMPool() {
-  for (unsigned int i_AOMPool = 0; i_AOMPool < at(0).vo_AOM_Pool.size();) {
+  const auto noOfAOMPools = at(0).vo_AOM_Pool.size();
+  if (noOfAOMPools == 0) return;
+
+  // decide for every pool (over all organic layers) if it is kept
+  _keepAOMPool.assign(noOfAOMPools, true);
+  bool deleteAny = false;
+  for (size_t i_AOMPool = 0; i_AOMPool < noOfAOMPools; i_AOMPool++) {
     double vo_SumAOM_Slow = 0.0;
     double vo_SumAOM_Fast = 0.0;
 
@@ -458,16 +537,24 @@ void SoilColumn::deleteAOMPool() {
     //cout << "Pool " << i_AOMPool << " -> Slow: " << vo_SumAOM_Slow << "; Fast: " << vo_SumAOM_Fast << endl;
 
     if ((vo_SumAOM_Slow + vo_SumAOM_Fast) < 0.00001) {
-      for (int i_Layer = 0; i_Layer < _vs_NumberOfOrganicLayers; i_Layer++) {
-        auto it_AOMPool = at(i_Layer).vo_AOM_Pool.begin();
-        it_AOMPool += i_AOMPool;
-        at(i_Layer).vo_AOM_Pool.erase(it_AOMPool);
-      }
+      _keepAOMPool[i_AOMPool] = false;
+      deleteAny = true;
       //cout << "Pool " << i_AOMPool << " deleted" << endl;
-    } else {
-      i_AOMPool++;
     }
   }
+  if (!deleteAny) return;
+
+  // compact every layer's pools in a single pass, keeping the order of the remaining pools
+  for (int i_Layer = 0; i_Layer < _vs_NumberOfOrganicLayers; i_Layer++) {
+    auto& pools = at(i_Layer).vo_AOM_Pool;
+    size_t keptPools = 0;
+    for (size_t i_AOMPool = 0; i_AOMPool < noOfAOMPools; i_AOMPool++) {
+      if (!_keepAOMPool[i_AOMPool]) continue;
+      if (keptPools != i_AOMPool) pools[keptPools] = std::move(pools[i_AOMPool]);
+      keptPools++;
+    }
+    pools.resize(keptPools);
+  }
 }
 
 /**
@@ -526,7 +613,7 @@ std::pair<bool, double> SoilColumn::applyIrrigationViaTrigger(const AutomaticIrr
           aips.nitrateConcentration * // [mg dm-3]
           addedIrrigationWaterAtLayer / //[dm3 m-2]
           li.vs_LayerThickness / 1000000.0; // [m]
-        li.vs_SoilNO3 += nitrateAddedViaIrrigation;
+        li.vs_SoilNO3() += nitrateAddedViaIrrigation;
 
         layerDepthM += lti;
       }
@@ -559,7 +646,7 @@ void SoilColumn::applyIrrigation(double amount, double nitrateConcentration) {
     at(0).vs_LayerThickness / 1000000.0; // [m]
 
   // adding N from irrigation water to top soil nitrate pool
-  at(0).vs_SoilNO3 += nitrateAddedViaIrrigation;
+  at(0).vs_SoilNO3() += nitrateAddedViaIrrigation;
 }
 
 
@@ -592,14 +679,14 @@ void SoilColumn::applyTillage(double depth) {
     soil_temperature += at(i).get_Vs_SoilTemperature();
     soil_moisture += at(i).get_Vs_SoilMoisture_m3();
     //soil_moistureOld += at(i).vs_SoilMoistureOld_m3;
-    som_slow += at(i).vs_SOM_Slow;
-    som_fast += at(i).vs_SOM_Fast;
-    smb_slow += at(i).vs_SMB_Slow;
-    smb_fast += at(i).vs_SMB_Fast;
-    carbamid += at(i).vs_SoilCarbamid;
-    nh4 += at(i).vs_SoilNH4;
-    no2 += at(i).vs_SoilNO2;
-    no3 += at(i).vs_SoilNO3;
+    som_slow += at(i).vs_SOM_Slow();
+    som_fast += at(i).vs_SOM_Fast();
+    smb_slow += at(i).vs_SMB_Slow();
+    smb_fast += at(i).vs_SMB_Fast();
+    carbamid += at(i).vs_SoilCarbamid();
+    nh4 += at(i).vs_SoilNH4();
+    no2 += at(i).vs_SoilNO2();
+    no3 += at(i).vs_SoilNO3();
   }
 
   auto li = double(layer_index);
@@ -627,14 +714,14 @@ void SoilColumn::applyTillage(double depth) {
     at(i).set_Vs_SoilTemperature(soil_temperature);
     at(i).set_Vs_SoilMoisture_m3(soil_moisture);
     //at(i).vs_SoilMoistureOld_m3 = soil_moistureOld;
-    at(i).vs_SOM_Slow = som_slow;
-    at(i).vs_SOM_Fast = som_fast;
-    at(i).vs_SMB_Slow = smb_slow;
-    at(i).vs_SMB_Fast = smb_fast;
-    at(i).vs_SoilCarbamid = carbamid;
-    at(i).vs_SoilNH4 = nh4;
-    at(i).vs_SoilNO2 = no2;
-    at(i).vs_SoilNO3 = no3;
+    at(i).vs_SOM_Slow() = som_slow;
+    at(i).vs_SOM_Fast() = som_fast;
+    at(i).vs_SMB_Slow() = smb_slow;
+    at(i).vs_SMB_Fast() = smb_fast;
+    at(i).vs_SoilCarbamid() = carbamid;
+    at(i).vs_SoilNH4() = nh4;
+    at(i).vs_SoilNO2() = no2;
+    at(i).vs_SoilNO3() = no3;
   }
 
   // merge aom pool
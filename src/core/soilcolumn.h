@@ -95,6 +95,48 @@ struct AOM_Properties {
   bool noVolatilization{true}; //!< true means it's a crop residue and won't participate in vo_volatilisation()
 };
 
+//! the per layer state variables which change (nearly) every day and are touched by most per layer kernels
+enum SoilLayerVar {
+  SOIL_MOISTURE = 0, //!< [m3 m-3]
+  SOIL_TEMPERATURE, //!< [°C]
+  SOM_SLOW, //!< [kg C m-3]
+  SOM_FAST, //!< [kg C m-3]
+  SMB_SLOW, //!< [kg C m-3]
+  SMB_FAST, //!< [kg C m-3]
+  SOIL_CARBAMID, //!< [kg Carbamide-N m-3]
+  SOIL_NH4, //!< [kg NH4-N m-3]
+  SOIL_NO2, //!< [kg NO2-N m-3]
+  SOIL_NO3, //!< [kg NO3-N m-3]
+  _NO_OF_SOIL_LAYER_VARS_
+};
+
+/**
+ * @brief the hot state of all layers of a soil column, stored as one contiguous array per variable
+ *
+ * The layers of a soil column refer to these arrays, so the per layer accessors
+ * (e.g. soilColumn[i].get_Vs_SoilMoisture_m3()) and kernels working on the whole arrays
+ * (e.g. states[SOIL_NO3][i] in a loop over all layers) see the same values.
+ * The derived constants are copied from the layers' soil parameters when the column is built
+ * and are meant to be read only.
+ */
+struct SoilLayerStates {
+  void resize(size_t nols);
+
+  size_t size() const { return vars[SOIL_MOISTURE].size(); }
+
+  double* operator[](SoilLayerVar v) { return vars[v].data(); }
+  const double* operator[](SoilLayerVar v) const { return vars[v].data(); }
+
+  std::vector<double> vars[_NO_OF_SOIL_LAYER_VARS_];
+
+  // derived constants
+  std::vector<double> layerThickness; //!< [m]
+  std::vector<double> fieldCapacity; //!< [m3 m-3]
+  std::vector<double> saturation; //!< [m3 m-3]
+  std::vector<double> permanentWiltingPoint; //!< [m3 m-3]
+  std::vector<double> lambda; //!< []
+};
+
 /**
  * @author Claas Nendel, Michael Berg
  *
@@ -104,11 +146,24 @@ struct AOM_Properties {
  * Right now all layers are expected to be from the same size, but this code
  * allows different sizes for a layer, too.
  *
+ * The hot state (see SoilLayerVar) of a layer being part of a SoilColumn lives
+ * in the column's SoilLayerStates, a standalone layer (or a copy of a layer) keeps it itself.
  */
 class SoilLayer {
 public:
   SoilLayer() {}
 
+  //! the copy is a standalone layer holding the current values of other
+  SoilLayer(const SoilLayer& other);
+
+  //! keeps referring to the soil column other referred to
+  SoilLayer(SoilLayer&& other) noexcept;
+
+  //! assigns the values of other, this layer keeps its place (in a soil column)
+  SoilLayer& operator=(const SoilLayer& other);
+
+  SoilLayer& operator=(SoilLayer&& other) noexcept;
+
 //    SoilLayer(const UserInitialValues* initParams);
 
   SoilLayer(double vs_LayerThickness,
@@ -142,27 +197,62 @@ public:
   double vs_SoilMoisture_pF();
 
   //! soil ammonium content [kgN m-3]
-  double get_SoilNH4() const { return vs_SoilNH4; }
+  double get_SoilNH4() const { return hot(SOIL_NH4); }
 
   //! soil nitrite content [kgN m-3]
-  double get_SoilNO2() const { return vs_SoilNO2; }
+  double get_SoilNO2() const { return hot(SOIL_NO2); }
 
   //! soil nitrate content [kgN m-3]
-  double get_SoilNO3() const { return vs_SoilNO3; }
+  double get_SoilNO3() const { return hot(SOIL_NO3); }
 
   //! soil carbamide content [kgN m-3]
-  double get_SoilCarbamid() const { return vs_SoilCarbamid; }
+  double get_SoilCarbamid() const { return hot(SOIL_CARBAMID); }
 
   //! soil mineral N content [kg m-3]
-  double get_SoilNmin() const { return vs_SoilNO3 + vs_SoilNO2 + vs_SoilNH4; }
+  double get_SoilNmin() const { return hot(SOIL_NO3) + hot(SOIL_NO2) + hot(SOIL_NH4); }
+
+  //! Soil layer's moisture content [m3 m-3]
+  double get_Vs_SoilMoisture_m3() const { return hot(SOIL_MOISTURE); }
+
+  void set_Vs_SoilMoisture_m3(double ms) { hot(SOIL_MOISTURE) = ms; }
 
-  double get_Vs_SoilMoisture_m3() const { return vs_SoilMoisture_m3; }
+  //! Soil layer's temperature [°C]
+  double get_Vs_SoilTemperature() const { return hot(SOIL_TEMPERATURE); }
 
-  void set_Vs_SoilMoisture_m3(double ms) { vs_SoilMoisture_m3 = ms; }
+  void set_Vs_SoilTemperature(double st) { hot(SOIL_TEMPERATURE) = st; }
 
-  double get_Vs_SoilTemperature() const { return vs_SoilTemperature; }
+  //! C content of soil organic matter slow pool [kg C m-3]
+  double& vs_SOM_Slow() { return hot(SOM_SLOW); }
+  double vs_SOM_Slow() const { return hot(SOM_SLOW); }
 
-  void set_Vs_SoilTemperature(double st) { vs_SoilTemperature = st; }
+  //! C content of soil organic matter fast pool size [kg C m-3]
+  double& vs_SOM_Fast() { return hot(SOM_FAST); }
+  double vs_SOM_Fast() const { return hot(SOM_FAST); }
+
+  //! C content of soil microbial biomass slow pool size [kg C m-3]
+  double& vs_SMB_Slow() { return hot(SMB_SLOW); }
+  double vs_SMB_Slow() const { return hot(SMB_SLOW); }
+
+  //! C content of soil microbial biomass fast pool size [kg C m-3]
+  double& vs_SMB_Fast() { return hot(SMB_FAST); }
+  double vs_SMB_Fast() const { return hot(SMB_FAST); }
+
+  // anorganische Stickstoff-Formen
+  //! Soil layer's carbamide-N content [kg Carbamide-N m-3]
+  double& vs_SoilCarbamid() { return hot(SOIL_CARBAMID); }
+  double vs_SoilCarbamid() const { return hot(SOIL_CARBAMID); }
+
+  //! Soil layer's NH4-N content [kg NH4-N m-3]
+  double& vs_SoilNH4() { return hot(SOIL_NH4); }
+  double vs_SoilNH4() const { return hot(SOIL_NH4); }
+
+  //! Soil layer's NO2-N content [kg NO2-N m-3]
+  double& vs_SoilNO2() { return hot(SOIL_NO2); }
+  double vs_SoilNO2() const { return hot(SOIL_NO2); }
+
+  //! Soil layer's NO3-N content [kg NO3-N m-3]
+  double& vs_SoilNO3() { return hot(SOIL_NO3); }
+  double vs_SoilNO3() const { return hot(SOIL_NO3); }
 
   double vs_SoilSandContent() const { return _sps.vs_SoilSandContent; } //!< Soil layer's sand content [kg kg-1]
   double vs_SoilClayContent() const { return _sps.vs_SoilClayContent; } //!< Soil layer's clay content [kg kg-1] (Ton)
@@ -191,23 +281,22 @@ public:
 
   std::vector<AOM_Properties> vo_AOM_Pool; //!< List of different added organic matter pools in soil layer
 
-  double vs_SOM_Slow{0.0}; //!< C content of soil organic matter slow pool [kg C m-3]
-  double vs_SOM_Fast{0.0}; //!< C content of soil organic matter fast pool size [kg C m-3]
-  double vs_SMB_Slow{0.0}; //!< C content of soil microbial biomass slow pool size [kg C m-3]
-  double vs_SMB_Fast{0.0}; //!< C content of soil microbial biomass fast pool size [kg C m-3]
-
-  // anorganische Stickstoff-Formen
-  double vs_SoilCarbamid{0.0}; //!< Soil layer's carbamide-N content [kg Carbamide-N m-3]
-  double vs_SoilNH4{0.0001}; //!< Soil layer's NH4-N content [kg NH4-N m-3]
-  double vs_SoilNO2{0.001}; //!< Soil layer's NO2-N content [kg NO2-N m-3]
-  double vs_SoilNO3{0.0001}; //!< Soil layer's NO3-N content [kg NO3-N m-3]
   bool vs_SoilFrozen{false};
 
 private:
+  friend class SoilColumn;
+
+  double& hot(SoilLayerVar v) { return _states ? _states->vars[v][_index] : _hot[v]; }
+  double hot(SoilLayerVar v) const { return _states ? _states->vars[v][_index] : _hot[v]; }
+
+  void copyColdFrom(const SoilLayer& other);
+
   Soil::SoilParameters _sps;
 
-  double vs_SoilMoisture_m3{0.25}; //!< Soil layer's moisture content [m3 m-3]
-  double vs_SoilTemperature{0.0}; //!< Soil layer's temperature [°C]
+  //! the hot state of a standalone layer, in the order of SoilLayerVar
+  double _hot[_NO_OF_SOIL_LAYER_VARS_]{0.25, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0001, 0.001, 0.0001};
+  SoilLayerStates* _states{nullptr}; //!< the states of the soil column this layer is part of
+  size_t _index{0}; //!< index of this layer in _states
 };
 
 //----------------------------------------------------------------------------
@@ -234,6 +323,10 @@ public:
   SoilColumn(mas::schema::model::monica::SoilColumnState::Reader reader, CropModule *cropModule = nullptr)
       : cropModule(cropModule) { deserialize(reader); }
 
+  //! the layers refer to the column's layer states
+  SoilColumn(const SoilColumn&) = delete;
+  SoilColumn& operator=(const SoilColumn&) = delete;
+
   void deserialize(mas::schema::model::monica::SoilColumnState::Reader reader);
 
   void serialize(mas::schema::model::monica::SoilColumnState::Builder builder) const;
@@ -292,6 +385,10 @@ public:
 
   double sumSoilTemperature(int layers) const;
 
+  //! the hot state of all layers as contiguous per variable arrays
+  SoilLayerStates& layerStates() { return _layerStates; }
+  const SoilLayerStates& layerStates() const { return _layerStates; }
+
   double vs_SurfaceWaterStorage{0.0}; //!< Content of above-ground water storage [mm]
   double vs_InterceptionStorage{0.0}; //!< Amount of intercepted water on crop surface [mm]
   size_t vm_GroundwaterTableLayer{0}; //!< Layer of current groundwater table
@@ -305,6 +402,11 @@ public:
 private:
   int calculateNumberOfOrganicLayers();
 
+  //! move the hot state of all layers into _layerStates and let the layers refer to it
+  void attachLayers();
+
+  SoilLayerStates _layerStates;
+
   double ps_MaxMineralisationDepth{0.4};
 
   int _vs_NumberOfOrganicLayers{0}; //!< Number of organic layers.
@@ -330,6 +432,8 @@ private:
 
   std::list<DelayedNMinApplicationParams> _delayedNMinApplications;
 
+  std::vector<bool> _keepAOMPool; //!< scratch space of deleteAOMPool
+
   //double pm_CriticalMoistureDepth{0};
 };
 
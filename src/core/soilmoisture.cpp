@@ -20,6 +20,7 @@ Copyright (C) Leibniz Centre for Agricultural Landscape Research (ZALF)
 #include <algorithm> //for min, max
 #include <iostream>
 #include <cmath>
+#include <map>
 
 #include "frost-component.h"
 #include "snow-component.h"
@@ -267,15 +268,17 @@ void SoilMoisture::step(double vs_GroundwaterDepth,
                         double vw_GlobalRadiation,
                         int vs_JulianDay,
                         double vw_ReferenceEvapotranspiration) {
+  const auto& layerStates = soilColumn.layerStates();
+  const double* soilMoisture = layerStates[SOIL_MOISTURE];
   for (int i = 0; i < numberOfSoilLayers; i++) {
     // initialization with moisture values stored in the layer
-    vm_SoilMoisture[i] = soilColumn[i].get_Vs_SoilMoisture_m3();
+    vm_SoilMoisture[i] = soilMoisture[i];
     vm_WaterFlux[i] = 0.0;
-    vm_FieldCapacity[i] = soilColumn[i].vs_FieldCapacity();
-    vm_SoilPoreVolume[i] = soilColumn[i].vs_Saturation();
-    vm_PermanentWiltingPoint[i] = soilColumn[i].vs_PermanentWiltingPoint();
-    vm_LayerThickness[i] = soilColumn[i].vs_LayerThickness;
-    vm_Lambda[i] = soilColumn[i].vs_Lambda();
+    vm_FieldCapacity[i] = layerStates.fieldCapacity[i];
+    vm_SoilPoreVolume[i] = layerStates.saturation[i];
+    vm_PermanentWiltingPoint[i] = layerStates.permanentWiltingPoint[i];
+    vm_LayerThickness[i] = layerStates.layerThickness[i];
+    vm_Lambda[i] = layerStates.lambda[i];
   }
 
   vm_SoilMoisture[numberOfMoistureLayers - 1] = soilColumn[numberOfMoistureLayers - 2].get_Vs_SoilMoisture_m3();
@@ -351,8 +354,9 @@ void SoilMoisture::step(double vs_GroundwaterDepth,
 
   fm_CapillaryRise();
 
+  double* newSoilMoisture = soilColumn.layerStates()[SOIL_MOISTURE];
   for (int i_Layer = 0; i_Layer < numberOfSoilLayers; i_Layer++) {
-    soilColumn[i_Layer].set_Vs_SoilMoisture_m3(vm_SoilMoisture[i_Layer]);
+    newSoilMoisture[i_Layer] = vm_SoilMoisture[i_Layer];
     soilColumn[i_Layer].vs_SoilWaterFlux = vm_WaterFlux[i_Layer];
     //commented out because old calc_vs_SoilMoisture_pF algorithm is calcualted every time vs_SoilMoisture_pF is accessed
     //    soilColumn[i_Layer].calc_vs_SoilMoisture_pF();
@@ -542,6 +546,7 @@ void SoilMoisture::fm_CapillaryRise() {
 
   if (double(vm_GroundwaterDistance) * vm_LayerThickness[0] <= 2.70) { // [m]
     // Capillary rise rates in table defined only until 2.70 m
+    if (_capillaryRiseRates.empty()) initCapillaryRiseRates();
 
     for (int i_Layer = 0; i_Layer < numberOfSoilLayers; i_Layer++) {
       // Define capillary water and available water
@@ -557,9 +562,9 @@ void SoilMoisture::fm_CapillaryRise() {
     // Find first layer above groundwater with 70% available water
     auto vm_StartLayer = min(vm_GroundwaterTableLayer, (numberOfSoilLayers - 1));
     for (int i = int(vm_StartLayer); i >= 0; i--) {
-      std::string vs_SoilTexture = soilColumn[i].vs_SoilTexture();
-      assert(!vs_SoilTexture.empty());
-      double vm_CapillaryRiseRate = min(0.01, _params.getCapillaryRiseRate(vs_SoilTexture, vm_GroundwaterDistance));
+      double vm_CapillaryRiseRate = vm_GroundwaterDistance < _noOfCapillaryRiseDistances
+        ? _capillaryRiseRates[i * _noOfCapillaryRiseDistances + vm_GroundwaterDistance]
+        : min(0.01, _params.getCapillaryRiseRate(soilColumn[i].vs_SoilTexture(), vm_GroundwaterDistance));
       // [m d-1]
       if (vm_AvailableWater[i] < vm_CapillaryWater70[i]) {
         auto vm_WaterAddedFromCapillaryRise = vm_CapillaryRiseRate; // [m d-1]
@@ -573,6 +578,34 @@ void SoilMoisture::fm_CapillaryRise() {
   }
 }
 
+/**
+ * The capillary rise rates depend just on the layer's texture and the groundwater distance,
+ * so they are looked up once (per texture) instead of every day.
+ */
+void SoilMoisture::initCapillaryRiseRates() {
+  _noOfCapillaryRiseDistances = 1;
+  while (double(_noOfCapillaryRiseDistances) * vm_LayerThickness[0] <= 2.70) _noOfCapillaryRiseDistances++;
+  _capillaryRiseRates.assign(numberOfSoilLayers * _noOfCapillaryRiseDistances, 0.0);
+
+  map<string, size_t> texture2layer;
+  for (size_t i = 0; i < numberOfSoilLayers; i++) {
+    auto rates = _capillaryRiseRates.begin() + i * _noOfCapillaryRiseDistances;
+    std::string vs_SoilTexture = soilColumn[i].vs_SoilTexture();
+    assert(!vs_SoilTexture.empty());
+    auto it = texture2layer.find(vs_SoilTexture);
+    if (it != texture2layer.end()) {
+      auto from = _capillaryRiseRates.begin() + it->second * _noOfCapillaryRiseDistances;
+      copy(from, from + _noOfCapillaryRiseDistances, rates);
+      continue;
+    }
+    // distance 0 doesn't occur, the groundwater is at least one layer away
+    for (size_t d = 1; d < _noOfCapillaryRiseDistances; d++) {
+      rates[d] = min(0.01, _params.getCapillaryRiseRate(vs_SoilTexture, d));
+    }
+    texture2layer[vs_SoilTexture] = i;
+  }
+}
+
 /**
  * @brief Calculation of percolation with groundwater influence
   */
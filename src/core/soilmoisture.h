@@ -122,6 +122,9 @@ public:
 
   void fm_CapillaryRise();
 
+  //! resolve the layers' textures to their capillary rise rates for all groundwater distances of the table
+  void initCapillaryRiseRates();
+
   void fm_PercolationWithGroundwater(size_t oscillGroundwaterLayer);
 
   void fm_GroundwaterReplenishment();
@@ -253,6 +256,10 @@ private:
   kj::Own<SnowComponent> snowComponent;
   kj::Own<FrostComponent> frostComponent;
   CropModule* cropModule{nullptr};
+
+  //! capillary rise rate [m d-1] of layer i at groundwater distance d at [i * _noOfCapillaryRiseDistances + d]
+  std::vector<double> _capillaryRiseRates;
+  size_t _noOfCapillaryRiseDistances{0};
 };
 } // namespace monica
 
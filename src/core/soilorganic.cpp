@@ -128,24 +128,24 @@ SoilOrganic::SoilOrganic(SoilColumn &sc, SoilOrganicModuleParameters userParams)
     vo_SoilOrganicC[i] -= vo_InertSoilOrganicC[i]; // [kg C m-3]
 
     // Initialisation of pool SMB_Slow [kg C m-3], changed by konstantin.aiteew@thuenen.de
-    layer.vs_SMB_Slow = po_PartSOM_to_SMB_Slow * vo_SoilOrganicC[i];
+    layer.vs_SMB_Slow() = po_PartSOM_to_SMB_Slow * vo_SoilOrganicC[i];
     // Initialisation of pool SMB_Slow [kg C m-3]
-    //layer.vs_SMB_Slow = po_SOM_SlowUtilizationEfficiency * po_PartSOM_to_SMB_Slow * vo_SoilOrganicC[i];
+    //layer.vs_SMB_Slow() = po_SOM_SlowUtilizationEfficiency * po_PartSOM_to_SMB_Slow * vo_SoilOrganicC[i];
 
     // Initialisation of pool SMB_Fast [kg C m-3], changed by konstantin.aiteew@thuenen.de
-    layer.vs_SMB_Fast = po_PartSOM_to_SMB_Fast * vo_SoilOrganicC[i];
+    layer.vs_SMB_Fast() = po_PartSOM_to_SMB_Fast * vo_SoilOrganicC[i];
     // Initialisation of pool SMB_Fast [kg C m-3]
-    //layer.vs_SMB_Fast = po_SOM_FastUtilizationEfficiency * po_PartSOM_to_SMB_Fast * vo_SoilOrganicC[i];
+    //layer.vs_SMB_Fast() = po_SOM_FastUtilizationEfficiency * po_PartSOM_to_SMB_Fast * vo_SoilOrganicC[i];
 
     // Initialisation of pool SOM_Slow [kg C m-3]
-    layer.vs_SOM_Slow = vo_SoilOrganicC[i] / (1.0 + po_SOM_SlowDecCoeffStandard
+    layer.vs_SOM_Slow() = vo_SoilOrganicC[i] / (1.0 + po_SOM_SlowDecCoeffStandard
                                                     / (po_SOM_FastDecCoeffStandard * po_PartSOM_Fast_to_SOM_Slow));
 
     // Initialisation of pool SOM_Fast [kg C m-3]
-    layer.vs_SOM_Fast = vo_SoilOrganicC[i] - layer.vs_SOM_Slow;
+    layer.vs_SOM_Fast() = vo_SoilOrganicC[i] - layer.vs_SOM_Slow();
 
     // Soil Organic Matter pool update [kg C m-3]
-    vo_SoilOrganicC[i] -= layer.vs_SMB_Slow + layer.vs_SMB_Fast;
+    vo_SoilOrganicC[i] -= layer.vs_SMB_Slow() + layer.vs_SMB_Fast();
 
     layer.set_SoilOrganicCarbon
         ((vo_SoilOrganicC[i] + vo_InertSoilOrganicC[i])
@@ -393,7 +393,7 @@ void SoilOrganic::addOrganicMatter(const OrganicMatterParameters &params,
     for (const auto &p: layer2addedOrganicMatterAmount) {
       if (p.first < nools) {
         // kg N m-3 soil
-        soilColumn.at(p.first).vs_SoilCarbamid +=
+        soilColumn.at(p.first).vs_SoilCarbamid() +=
             p.second
             * params.vo_AOM_DryMatterContent
             * params.vo_AOM_CarbamidContent
@@ -489,9 +489,9 @@ void SoilOrganic::addOrganicMatter(const OrganicMatterParameters &params,
         * added_Corg_amount;
 
     // immediate top layer pool update
-    intoLayer.vs_SoilNH4 += soil_NH4_input;
-    intoLayer.vs_SoilNO3 += soil_NO3_input;
-    intoLayer.vs_SOM_Fast += SOM_FastInput;
+    intoLayer.vs_SoilNH4() += soil_NH4_input;
+    intoLayer.vs_SoilNO3() += soil_NO3_input;
+    intoLayer.vs_SOM_Fast() += SOM_FastInput;
 
     // store for further use
     vo_AOM_SlowInput[intoLayerIndex] += AOM_slow_input;
@@ -598,7 +598,7 @@ void SoilOrganic::fo_Urea(double vo_RainIrrigation) {
     auto &layer = soilColumn.at(i);
 
     // kmol urea m-3 soil
-    vo_SoilCarbamid_solid[i] = layer.vs_SoilCarbamid /
+    vo_SoilCarbamid_solid[i] = layer.vs_SoilCarbamid() /
                                OrganicConstants::po_UreaMolecularWeight /
                                OrganicConstants::po_Urea_to_N / 1000.0;
 
@@ -651,18 +651,18 @@ void SoilOrganic::fo_Urea(double vo_RainIrrigation) {
 
     if (vo_HydrolysisRate[i] >= vo_SoilCarbamid_aq[i]) {
 
-      layer.vs_SoilNH4 += layer.vs_SoilCarbamid;
-      layer.vs_SoilCarbamid = 0.0;
+      layer.vs_SoilNH4() += layer.vs_SoilCarbamid();
+      layer.vs_SoilCarbamid() = 0.0;
 
     } else {
 
       // kg N m soil-3
-      layer.vs_SoilCarbamid -= vo_HydrolysisRate[i] *
+      layer.vs_SoilCarbamid() -= vo_HydrolysisRate[i] *
                                OrganicConstants::po_UreaMolecularWeight *
                                OrganicConstants::po_Urea_to_N * 1000.0;
 
       // kg N m soil-3
-      layer.vs_SoilNH4 += vo_HydrolysisRate[i] *
+      layer.vs_SoilNH4() += vo_HydrolysisRate[i] *
                           OrganicConstants::po_UreaMolecularWeight *
                           OrganicConstants::po_Urea_to_N * 1000.0;
     }
@@ -681,7 +681,7 @@ void SoilOrganic::fo_Urea(double vo_RainIrrigation) {
                                            2.301));  // K1 in Sadeghi's program
 
       // kmol m-3, assuming that all NH4 is solved
-      vs_SoilNH4aq = layer0.vs_SoilNH4 / (OrganicConstants::po_NH4MolecularWeight * 1000.0);
+      vs_SoilNH4aq = layer0.vs_SoilNH4() / (OrganicConstants::po_NH4MolecularWeight * 1000.0);
 
       // kmol m-3
       vo_NH3aq = vs_SoilNH4aq / (1.0 + (vo_H3OIonConcentration / vo_NH3aq_EquilibriumConst));
@@ -692,11 +692,11 @@ void SoilOrganic::fo_Urea(double vo_RainIrrigation) {
       // kg N m-3 d-1
       vo_NH3_Volatilising = vo_NH3gas * OrganicConstants::po_NH3MolecularWeight * 1000.0;
 
-      if (vo_NH3_Volatilising >= layer0.vs_SoilNH4) {
-        vo_NH3_Volatilising = layer0.vs_SoilNH4;
-        layer0.vs_SoilNH4 = 0.0;
+      if (vo_NH3_Volatilising >= layer0.vs_SoilNH4()) {
+        vo_NH3_Volatilising = layer0.vs_SoilNH4();
+        layer0.vs_SoilNH4() = 0.0;
       } else {
-        layer0.vs_SoilNH4 -= vo_NH3_Volatilising;
+        layer0.vs_SoilNH4() -= vo_NH3_Volatilising;
       }
 
       // kg N m-2 d-1
@@ -861,20 +861,20 @@ void SoilOrganic::fo_MIT() {
 
     vo_SOM_SlowDecCoeff[i] = po_SOM_SlowDecCoeffStandard * tod * mod;
     vo_SOM_FastDecCoeff[i] = po_SOM_FastDecCoeffStandard * tod * mod;
-    vo_SOM_SlowDecRate[i] = vo_SOM_SlowDecCoeff[i] * layi.vs_SOM_Slow;
-    vo_SOM_FastDecRate[i] = vo_SOM_FastDecCoeff[i] * layi.vs_SOM_Fast;
+    vo_SOM_SlowDecRate[i] = vo_SOM_SlowDecCoeff[i] * layi.vs_SOM_Slow();
+    vo_SOM_FastDecRate[i] = vo_SOM_FastDecCoeff[i] * layi.vs_SOM_Fast();
 
     vo_SMB_SlowMaintRateCoeff[i] = po_SMB_SlowMaintRateStandard * cod * tod * mod;
 
     vo_SMB_FastMaintRateCoeff[i] = po_SMB_FastMaintRateStandard * cod * tod * mod;
     //vo_SMB_FastMaintRateCoeff[i] = po_SMB_FastMaintRateStandard * tod * mod; // prev code
 
-    vo_SMB_SlowMaintRate[i] = vo_SMB_SlowMaintRateCoeff[i] * layi.vs_SMB_Slow;
-    vo_SMB_FastMaintRate[i] = vo_SMB_FastMaintRateCoeff[i] * layi.vs_SMB_Fast;
+    vo_SMB_SlowMaintRate[i] = vo_SMB_SlowMaintRateCoeff[i] * layi.vs_SMB_Slow();
+    vo_SMB_FastMaintRate[i] = vo_SMB_FastMaintRateCoeff[i] * layi.vs_SMB_Fast();
     vo_SMB_SlowDeathRateCoeff[i] = po_SMB_SlowDeathRateStandard * tod * mod;
     vo_SMB_FastDeathRateCoeff[i] = po_SMB_FastDeathRateStandard * tod * mod;
-    vo_SMB_SlowDeathRate[i] = vo_SMB_SlowDeathRateCoeff[i] * layi.vs_SMB_Slow;
-    vo_SMB_FastDeathRate[i] = vo_SMB_FastDeathRateCoeff[i] * layi.vs_SMB_Fast;
+    vo_SMB_SlowDeathRate[i] = vo_SMB_SlowDeathRateCoeff[i] * layi.vs_SMB_Slow();
+    vo_SMB_FastDeathRate[i] = vo_SMB_FastDeathRateCoeff[i] * layi.vs_SMB_Fast();
 
     vo_SMB_SlowDecRate[i] = vo_SMB_SlowDeathRate[i] + vo_SMB_SlowMaintRate[i];
     vo_SMB_FastDecRate[i] = vo_SMB_FastDeathRate[i] + vo_SMB_FastMaintRate[i];
@@ -954,7 +954,7 @@ void SoilOrganic::fo_MIT() {
     //!Eq.6-9 in the DAISY manual
     vo_SOM_SlowDelta[i] = po_PartSOM_Fast_to_SOM_Slow * vo_SOM_FastDecRate[i] - vo_SOM_SlowDecRate[i];
 
-    if ((layi.vs_SOM_Slow + vo_SOM_SlowDelta[i]) < 0.0) vo_SOM_SlowDelta[i] = layi.vs_SOM_Slow;
+    if ((layi.vs_SOM_Slow() + vo_SOM_SlowDelta[i]) < 0.0) vo_SOM_SlowDelta[i] = layi.vs_SOM_Slow();
 
     // Eq.6-10 in the DAISY manual
     //vo_SOM_FastDelta[i] = po_PartSMB_Slow_to_SOM_Fast
@@ -965,7 +965,7 @@ void SoilOrganic::fo_MIT() {
                           + po_PartSMB_Fast_to_SOM_Fast * vo_SMB_FastDeathRate[i]
                           - vo_SOM_FastDecRate[i];
 
-    if ((layi.vs_SOM_Fast + vo_SOM_FastDelta[i]) < 0.0) vo_SOM_FastDelta[i] = layi.vs_SOM_Fast;
+    if ((layi.vs_SOM_Fast() + vo_SOM_FastDelta[i]) < 0.0) vo_SOM_FastDelta[i] = layi.vs_SOM_Fast();
 
     vo_AOM_SlowDeltaSum[i] = 0.0;
     vo_AOM_FastDeltaSum[i] = 0.0;
@@ -1010,8 +1010,8 @@ void SoilOrganic::fo_MIT() {
     double vo_CN_Ratio_SOM_Fast = vo_CN_Ratio_SOM_Slow;
 
     if (vo_NBalance[i] < 0.0) {
-      if (fabs(vo_NBalance[i]) >= ((layi.vs_SoilNH4 * po_ImmobilisationRateCoeffNH4)
-                                   + (layi.vs_SoilNO3 * po_ImmobilisationRateCoeffNO3))) {
+      if (fabs(vo_NBalance[i]) >= ((layi.vs_SoilNH4() * po_ImmobilisationRateCoeffNH4)
+                                   + (layi.vs_SoilNO3() * po_ImmobilisationRateCoeffNO3))) {
         vo_AOM_SlowDeltaSum[i] = 0.0;
         vo_AOM_FastDeltaSum[i] = 0.0;
 
@@ -1053,8 +1053,8 @@ void SoilOrganic::fo_MIT() {
                               //+ (po_AOM_FastUtilizationEfficiency * AOMfast_to_SMBslow)
                               - vo_SMB_SlowDecRate[i];
 
-        if ((layi.vs_SMB_Slow + vo_SMB_SlowDelta[i]) < 0.0) {
-          vo_SMB_SlowDelta[i] = layi.vs_SMB_Slow;
+        if ((layi.vs_SMB_Slow() + vo_SMB_SlowDelta[i]) < 0.0) {
+          vo_SMB_SlowDelta[i] = layi.vs_SMB_Slow();
         }
 
         vo_SMB_FastDelta[i] = (po_SMB_UtilizationEfficiency *
@@ -1065,8 +1065,8 @@ void SoilOrganic::fo_MIT() {
                               + (po_AOM_SlowUtilizationEfficiency * AOMslow_to_SMBfast[i])
                               - vo_SMB_FastDecRate[i];
 
-        if ((layi.vs_SMB_Fast + vo_SMB_FastDelta[i]) < 0.0) {
-          vo_SMB_FastDelta[i] = layi.vs_SMB_Fast;
+        if ((layi.vs_SMB_Fast() + vo_SMB_FastDelta[i]) < 0.0) {
+          vo_SMB_FastDelta[i] = layi.vs_SMB_Fast();
         }
 
         // Recalculation of N balance under conditions of immobilisation
@@ -1086,18 +1086,18 @@ void SoilOrganic::fo_MIT() {
         }
 
         // Update of Soil NH4 after recalculated N balance
-        layi.vs_SoilNH4 += fabs(vo_NBalance[i]);
+        layi.vs_SoilNH4() += fabs(vo_NBalance[i]);
       } else {
         // Bedarf kann durch Ammonium-Pool nicht gedeckt werden --> Nitrat wird verwendet
-        if (fabs(vo_NBalance[i]) >= (layi.vs_SoilNH4 * po_ImmobilisationRateCoeffNH4)) {
-          layi.vs_SoilNO3 -= fabs(vo_NBalance[i]) - (layi.vs_SoilNH4 * po_ImmobilisationRateCoeffNH4);
-          layi.vs_SoilNH4 -= layi.vs_SoilNH4 * po_ImmobilisationRateCoeffNH4;
+        if (fabs(vo_NBalance[i]) >= (layi.vs_SoilNH4() * po_ImmobilisationRateCoeffNH4)) {
+          layi.vs_SoilNO3() -= fabs(vo_NBalance[i]) - (layi.vs_SoilNH4() * po_ImmobilisationRateCoeffNH4);
+          layi.vs_SoilNH4() -= layi.vs_SoilNH4() * po_ImmobilisationRateCoeffNH4;
         } else {
-          layi.vs_SoilNH4 -= fabs(vo_NBalance[i]);
+          layi.vs_SoilNH4() -= fabs(vo_NBalance[i]);
         }
       }
     } else { //if (N_Balance[i]) < 0.0
-      layi.vs_SoilNH4 += fabs(vo_NBalance[i]);
+      layi.vs_SoilNH4() += fabs(vo_NBalance[i]);
     }
 
     auto &lay0 = soilColumn.at(0);
@@ -1221,15 +1221,15 @@ void SoilOrganic::fo_Volatilisation(bool vo_AOM_Addition, double vw_MeanAirTempe
       vo_N_PotVolatilisedSum += vo_N_PotVolatilised;
     }
 
-    if (lay0.vs_SoilNH4 > (vo_N_PotVolatilisedSum)) {
+    if (lay0.vs_SoilNH4() > (vo_N_PotVolatilisedSum)) {
       vo_N_ActVolatilised = vo_N_PotVolatilisedSum;
     } else {
-      vo_N_ActVolatilised = lay0.vs_SoilNH4;
+      vo_N_ActVolatilised = lay0.vs_SoilNH4();
     }
 
     // update NH4 content of top soil layer with volatilisation balance
 
-    lay0.vs_SoilNH4 -= (vo_N_ActVolatilised / lay0.vs_LayerThickness);
+    lay0.vs_SoilNH4() -= (vo_N_ActVolatilised / lay0.vs_LayerThickness);
   } else {
     vo_N_ActVolatilised = 0.0;
   }
@@ -1263,7 +1263,7 @@ void SoilOrganic::fo_Nitrification() {
 
   for (int i = 0; i < nools; i++) {
     auto &layi = soilColumn.at(i);
-    auto NH4i = layi.vs_SoilNH4;
+    auto NH4i = layi.vs_SoilNH4();
 
     // Calculate nitrification rate coefficients
     //  cout << "SO-2:\t" << layi.vs_SoilMoisture_pF() << endl;
@@ -1280,24 +1280,24 @@ void SoilOrganic::fo_Nitrification() {
         * fo_MoistOnNitrification(layi.vs_SoilMoisture_pF())
         * fo_NH3onNitriteOxidation(NH4i, layi.vs_SoilpH());
 
-    vo_ActNitrificationRate[i] = vo_NitriteOxidationRateCoeff[i] * layi.vs_SoilNO2;
+    vo_ActNitrificationRate[i] = vo_NitriteOxidationRateCoeff[i] * layi.vs_SoilNO2();
 
     // Update NH4, NO2 and NO3 content with nitrification balance
     // Stange, F., C. Nendel (2014): N.N., in preparation
     if (NH4i > vo_ActAmmoniaOxidationRate[i]) {
-      layi.vs_SoilNH4 -= vo_ActAmmoniaOxidationRate[i];
-      layi.vs_SoilNO2 += vo_ActAmmoniaOxidationRate[i];
+      layi.vs_SoilNH4() -= vo_ActAmmoniaOxidationRate[i];
+      layi.vs_SoilNO2() += vo_ActAmmoniaOxidationRate[i];
     } else {
-      layi.vs_SoilNO2 += NH4i;
-      layi.vs_SoilNH4 = 0.0;
+      layi.vs_SoilNO2() += NH4i;
+      layi.vs_SoilNH4() = 0.0;
     }
 
-    if (layi.vs_SoilNO2 > vo_ActNitrificationRate[i]) {
-      layi.vs_SoilNO2 -= vo_ActNitrificationRate[i];
-      layi.vs_SoilNO3 += vo_ActNitrificationRate[i];
+    if (layi.vs_SoilNO2() > vo_ActNitrificationRate[i]) {
+      layi.vs_SoilNO2() -= vo_ActNitrificationRate[i];
+      layi.vs_SoilNO3() += vo_ActNitrificationRate[i];
     } else {
-      layi.vs_SoilNO3 += layi.vs_SoilNO2;
-      layi.vs_SoilNO2 = 0.0;
+      layi.vs_SoilNO3() += layi.vs_SoilNO2();
+      layi.vs_SoilNO2() = 0.0;
     }
   }
 }
@@ -1327,11 +1327,11 @@ void SoilOrganic::fo_stics_Nitrification() {
         * mgN_per_kg_to_kgN_per_m3; // mg-N -> kg-N;
 
     if (NH4i > vo_ActNitrificationRate[i]) {
-      layi.vs_SoilNH4 -= vo_ActNitrificationRate[i];
-      layi.vs_SoilNO3 += vo_ActNitrificationRate[i];
+      layi.vs_SoilNH4() -= vo_ActNitrificationRate[i];
+      layi.vs_SoilNO3() += vo_ActNitrificationRate[i];
     } else {
-      layi.vs_SoilNO3 += NH4i;
-      layi.vs_SoilNH4 = 0.0;
+      layi.vs_SoilNO3() += NH4i;
+      layi.vs_SoilNH4() = 0.0;
     }
   }
 }
@@ -1348,7 +1348,7 @@ void SoilOrganic::fo_Denitrification() {
 
   for (int i = 0; i < nools; i++) {
     auto &layi = soilColumn.at(i);
-    auto NO3i = layi.vs_SoilNO3;
+    auto NO3i = layi.vs_SoilNO3();
 
     //Temperature function is the same as in Nitrification subroutine
     vo_PotDenitrificationRate[i] = po_SpecAnaerobDenitrification
@@ -1362,10 +1362,10 @@ void SoilOrganic::fo_Denitrification() {
 
     // update NO3 content of soil layer with denitrification balance [kg N m-3]
     if (NO3i > vo_ActDenitrificationRate[i]) {
-      layi.vs_SoilNO3 -= vo_ActDenitrificationRate[i];
+      layi.vs_SoilNO3() -= vo_ActDenitrificationRate[i];
     } else {
       vo_ActDenitrificationRate[i] = NO3i;
-      layi.vs_SoilNO3 = 0.0;
+      layi.vs_SoilNO3() = 0.0;
     }
 
     vo_TotalDenitrification += vo_ActDenitrificationRate[i] * layi.vs_LayerThickness; // [kg m-3] --> [kg m-2] ;
@@ -1400,10 +1400,10 @@ void SoilOrganic::fo_stics_Denitrification() {
 
     // update NO3 content of soil layer with denitrification balance [kg N m-3]
     if (NO3i > vo_ActDenitrificationRate[i]) {
-      layi.vs_SoilNO3 -= vo_ActDenitrificationRate[i];
+      layi.vs_SoilNO3() -= vo_ActDenitrificationRate[i];
     } else {
       vo_ActDenitrificationRate[i] = NO3i;
-      layi.vs_SoilNO3 = 0.0;
+      layi.vs_SoilNO3() = 0.0;
     }
     vo_TotalDenitrification += vo_ActDenitrificationRate[i] * lti; // [kg m-3] --> [kg m-2] ;
 
@@ -1424,7 +1424,7 @@ double SoilOrganic::fo_N2OProduction() {
   for (int i = 0; i < nools; i++) {
     auto &layi = soilColumn.at(i);
     auto pHi = layi.vs_SoilpH();
-    auto NO2i = layi.vs_SoilNO2;
+    auto NO2i = layi.vs_SoilNO2();
     auto lti = layi.vs_LayerThickness;
     auto tempi = layi.get_Vs_SoilTemperature();
 
@@ -1504,11 +1504,6 @@ void SoilOrganic::fo_PoolUpdate() {
       vo_AOM_FastSum[i] += pool.vo_AOM_Fast;
     }
 
-    layi.vs_SOM_Slow += vo_SOM_SlowDelta[i];
-    layi.vs_SOM_Fast += vo_SOM_FastDelta[i];
-    layi.vs_SMB_Slow += vo_SMB_SlowDelta[i];
-    layi.vs_SMB_Fast += vo_SMB_FastDelta[i];
-
     vo_CBalance[i] =
         vo_AOM_SlowInput[i]
         + vo_AOM_FastInput[i]
@@ -1537,6 +1532,18 @@ void SoilOrganic::fo_PoolUpdate() {
     //	 / OrganicConstants::po_SOM_to_C
     //	 / layi.vs_SoilBulkDensity());
   }
+
+  auto& layerStates = soilColumn.layerStates();
+  double* somSlow = layerStates[SOM_SLOW];
+  double* somFast = layerStates[SOM_FAST];
+  double* smbSlow = layerStates[SMB_SLOW];
+  double* smbFast = layerStates[SMB_FAST];
+  for (size_t i = 0; i < nools; i++) {
+    somSlow[i] += vo_SOM_SlowDelta[i];
+    somFast[i] += vo_SOM_FastDelta[i];
+    smbSlow[i] += vo_SMB_SlowDelta[i];
+    smbFast[i] += vo_SMB_FastDelta[i];
+  }
 }
 
 /**
@@ -1876,7 +1883,7 @@ double SoilOrganic::get_AOM_SlowSum(int i_Layer) const {
  * @return SMB fast
  */
 double SoilOrganic::get_SMB_Fast(int i_Layer) const {
-  return soilColumn.at(i_Layer).vs_SMB_Fast;
+  return soilColumn.at(i_Layer).vs_SMB_Fast();
 }
 
 /**
@@ -1884,7 +1891,7 @@ double SoilOrganic::get_SMB_Fast(int i_Layer) const {
  * @return SMB slow
  */
 double SoilOrganic::get_SMB_Slow(int i_Layer) const {
-  return soilColumn.at(i_Layer).vs_SMB_Slow;
+  return soilColumn.at(i_Layer).vs_SMB_Slow();
 }
 
 /**
@@ -1892,7 +1899,7 @@ double SoilOrganic::get_SMB_Slow(int i_Layer) const {
  * @return AOM fast
  */
 double SoilOrganic::get_SOM_Fast(int i_Layer) const {
-  return soilColumn.at(i_Layer).vs_SOM_Fast;
+  return soilColumn.at(i_Layer).vs_SOM_Fast();
 }
 
 /**
@@ -1900,7 +1907,7 @@ double SoilOrganic::get_SOM_Fast(int i_Layer) const {
  * @return SOM slow
  */
 double SoilOrganic::get_SOM_Slow(int i_Layer) const {
-  return soilColumn.at(i_Layer).vs_SOM_Slow;
+  return soilColumn.at(i_Layer).vs_SOM_Slow();
 }
 
 /**
@@ -268,9 +268,12 @@ void SoilTemperature::serialize(mas::schema::model::monica::SoilTemperatureModul
 
 //! Single calculation step
 void SoilTemperature::step(double tmin, double tmax, double globrad) {
-  const size_t groundLayer = _noOfTempLayers - 2;
-  const size_t bottomLayer = _noOfTempLayers - 1;
+  prepareStep(tmin, tmax, globrad);
+  solve();
+  finishStep();
+}
 
+void SoilTemperature::prepareStep(double tmin, double tmax, double globrad) {
   /////////////////////////////////////////////////////////////
   // Internal Subroutine Numerical Solution - Suckow,F. (1986)
   /////////////////////////////////////////////////////////////
@@ -287,6 +290,10 @@ void SoilTemperature::step(double tmin, double tmax, double globrad) {
         * _soilTemperature[i] + _heatFlow[i];
   }
   // end subroutine NumericalSolution
+}
+
+void SoilTemperature::solve() {
+  const size_t bottomLayer = _noOfTempLayers - 1;
 
   /////////////////////////////////////////////////////////////
   // Internal Subroutine Cholesky Solution Method
@@ -317,15 +324,21 @@ void SoilTemperature::step(double tmin, double tmax, double globrad) {
                    - (_matrixLowerTriangle[j_1] * _solution[j_1]);
   }
   // end subroutine CholeskyMethod
+}
+
+void SoilTemperature::finishStep() {
+  const size_t groundLayer = _noOfTempLayers - 2;
+  const size_t bottomLayer = _noOfTempLayers - 1;
 
   // Internal Subroutine Rearrangement
   for (size_t i = 0; i < _noOfTempLayers; i++) {
     _soilTemperature[i] = _solution[i];
   }
 
+  double* soilTemperature = _soilColumn.layerStates()[SOIL_TEMPERATURE];
   for (size_t i = 0; i < _noOfSoilLayers; i++) {
     _volumeMatrixOld[i] = _volumeMatrix[i];
-    soilColumn.at(i).set_Vs_SoilTemperature(_soilTemperature[i]);
+    soilTemperature[i] = _soilTemperature[i];
   }
 
   _volumeMatrixOld[groundLayer] = _volumeMatrix[groundLayer];
@@ -50,6 +50,11 @@ public:
 
   void step(double tmin, double tmax, double globrad);
 
+  //! the parts of step(), run one after another by MonicaModel
+  void prepareStep(double tmin, double tmax, double globrad);
+  void solve();
+  void finishStep();
+
   double calcSoilSurfaceTemperature(double prevSoilSurfaceTemperature, double tmin, double tmax, double globrad) const;
 
   double getSoilSurfaceTemperature() const { return _soilSurfaceTemperature; }
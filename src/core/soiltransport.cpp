@@ -39,9 +39,10 @@ using namespace Tools;
  *
  * @author Claas Nendel
  */
-SoilTransport::SoilTransport(SoilColumn& sc, const SiteParameters& sps, const SoilTransportModuleParameters& params,
-  double p_LeachingDepth, double p_timeStep, double pc_MinimumAvailableN)
+SoilTransport::SoilTransport(SoilColumn& sc, ScratchArena& scratch, const SiteParameters& sps,
+  const SoilTransportModuleParameters& params, double p_LeachingDepth, double p_timeStep, double pc_MinimumAvailableN)
   : soilColumn(sc)
+  , _scratch(scratch)
   , _params(params)
   //, vs_NumberOfLayers(sc.vs_NumberOfLayers()) //extern
   , vq_Convection(sc.vs_NumberOfLayers(), 0.0)
@@ -109,13 +110,20 @@ void SoilTransport::serialize(mas::schema::model::monica::SoilTransportModuleSta
  * @brief Computes a soil transport step
  */
 void SoilTransport::step() {
+  prepareStep();
+  transport();
+  finishStep();
+}
+
+void SoilTransport::prepareStep() {
   double minTimeStepFactor = 1.0; // [t t-1]
   const auto nols = soilColumn.vs_NumberOfLayers();
 
+  const double* soilNO3 = soilColumn.layerStates()[SOIL_NO3];
   for (size_t i = 0; i < nols; i++) {
     //vq_FieldCapacity[i] = soilColumn[i].vs_FieldCapacity();
     //vq_SoilMoisture[i] = soilColumn[i].get_Vs_SoilMoisture_m3();
-    vq_SoilNO3[i] = soilColumn[i].vs_SoilNO3;
+    vq_SoilNO3[i] = soilNO3[i];
 
     vc_NUptakeFromLayer[i] = cropModule ? cropModule->get_NUptakeFromLayer(i) : 0;
     if (i == nols - 1) 
@@ -138,21 +146,28 @@ void SoilTransport::step() {
     minTimeStepFactor = min(minTimeStepFactor, timeStepFactorCurrentLayer);
   }
 
+  _minTimeStepFactor = minTimeStepFactor;
+
   fq_NDeposition();
   fq_NUptake();
+}
 
+void SoilTransport::transport() {
   // Nitrate transport is called according to the set time step
   vq_LeachingAtBoundary = 0.0;
-  for (int i_TimeStep = 0; i_TimeStep < (1.0 / minTimeStepFactor); i_TimeStep++) 
-    fq_NTransport(vs_LeachingDepth, minTimeStepFactor);
-
-  for (int i = 0; i < nols; i++) {
-    vq_SoilNO3[i] = vq_SoilNO3_aq[i] * soilColumn[i].get_Vs_SoilMoisture_m3();
-
-    if (vq_SoilNO3[i] < 0.0) 
-      vq_SoilNO3[i] = 0.0;
+  for (int i_TimeStep = 0; i_TimeStep < (1.0 / _minTimeStepFactor); i_TimeStep++) 
+    fq_NTransport(vs_LeachingDepth, _minTimeStepFactor);
+}
 
-    soilColumn[i].vs_SoilNO3 = vq_SoilNO3[i];
+void SoilTransport::finishStep() {
+  const auto nols = soilColumn.vs_NumberOfLayers();
+  auto& layerStates = soilColumn.layerStates();
+  const double* soilMoisture = layerStates[SOIL_MOISTURE];
+  double* soilNO3 = layerStates[SOIL_NO3];
+  for (size_t i = 0; i < nols; i++) {
+    const auto no3 = vq_SoilNO3_aq[i] * soilMoisture[i];
+    vq_SoilNO3[i] = no3 < 0.0 ? 0.0 : no3;
+    soilNO3[i] = vq_SoilNO3[i];
   } 
 
 }
@@ -182,10 +197,12 @@ void SoilTransport::fq_NDeposition() {
  */
 void SoilTransport::fq_NUptake() {
   const auto nols = soilColumn.vs_NumberOfLayers();
+  const auto& layerStates = soilColumn.layerStates();
+  const double* soilMoisture = layerStates[SOIL_MOISTURE];
   double cropNUptake = 0.0;
   for (size_t i = 0; i < nols; i++) {
-    const auto lti = soilColumn[i].vs_LayerThickness;
-    const auto smi = soilColumn[i].get_Vs_SoilMoisture_m3();
+    const auto lti = layerStates.layerThickness[i];
+    const auto smi = soilMoisture[i];
 
     // Lower boundary for N exploitation per layer
     if (vc_NUptakeFromLayer[i] > ((vq_SoilNO3[i] * lti) - pc_MinimumAvailableN)) {
@@ -220,7 +237,7 @@ void SoilTransport::fq_NTransport(double leachingDepth, double timeStepFactor) {
   double soilProfile = 0.0;
   size_t leachingDepthLayerIndex = 0;
   const auto nols = soilColumn.vs_NumberOfLayers();
-  std::vector<double> soilMoistureGradient(nols, 0.0);
+  double* soilMoistureGradient = _scratch.doubles(nols);
 
   for (size_t i = 0; i < nols; i++) {
     soilProfile += soilColumn[i].vs_LayerThickness;
@@ -377,9 +394,9 @@ void SoilTransport::fq_NTransport(double leachingDepth, double timeStepFactor) {
 
   // Update of NO3 concentration
   // including transfomation back into [kg NO3-N m soil-3]
+  const double* soilMoisture = soilColumn.layerStates()[SOIL_MOISTURE];
   for (size_t i = 0; i < nols; i++) {
-    const auto smi = soilColumn[i].get_Vs_SoilMoisture_m3();
-    vq_SoilNO3_aq[i] += (vq_Dispersion[i] - vq_Convection[i]) / smi;
+    vq_SoilNO3_aq[i] += (vq_Dispersion[i] - vq_Convection[i]) / soilMoisture[i];
   }
 }
 
@@ -19,6 +19,7 @@ Copyright (C) Leibniz Centre for Agricultural Landscape Research (ZALF)
 
 #include <vector>
 #include "monica-parameters.h"
+#include "scratch-arena.h"
 
 namespace monica {
   
@@ -35,19 +36,26 @@ class CropModule;
 class SoilTransport {
 public:
   SoilTransport(SoilColumn& soilColumn,
+                ScratchArena& scratch,
                 const SiteParameters& sps,
                 const SoilTransportModuleParameters& params,
                 double p_LeachingDepth,
                 double p_timeStep,
                 double pc_MinimumAvailableN);
 
-  SoilTransport(SoilColumn& soilColumn, mas::schema::model::monica::SoilTransportModuleState::Reader reader, CropModule* cropModule = nullptr)
-    : soilColumn(soilColumn), cropModule(cropModule) { deserialize(reader); }
+  SoilTransport(SoilColumn& soilColumn, ScratchArena& scratch,
+                mas::schema::model::monica::SoilTransportModuleState::Reader reader, CropModule* cropModule = nullptr)
+    : soilColumn(soilColumn), _scratch(scratch), cropModule(cropModule) { deserialize(reader); }
   void deserialize(mas::schema::model::monica::SoilTransportModuleState::Reader reader);
   void serialize(mas::schema::model::monica::SoilTransportModuleState::Builder builder) const;
 
   void step();
 
+  //! the parts of step(), run one after another by MonicaModel
+  void prepareStep();
+  void transport();
+  void finishStep();
+
   //! calculates daily N deposition
   void fq_NDeposition();
 
@@ -71,6 +79,7 @@ public:
 
 private:
   SoilColumn& soilColumn;
+  ScratchArena& _scratch;
   SoilTransportModuleParameters _params;
   //const size_t vs_NumberOfLayers;
   std::vector<double> vq_Convection;
@@ -90,6 +99,7 @@ private:
   double vq_TimeStep{ 1.0 };
   std::vector<double> vq_TotalDispersion;
   std::vector<double> vq_PercolationRate; //!< Soil water flux from above [mm d-1]
+  double _minTimeStepFactor{1.0}; //!< of the current step, set in prepareStep() [t t-1]
 
   double pc_MinimumAvailableN{ 0.0 }; //! kg m-2
 
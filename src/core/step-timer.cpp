@@ -0,0 +1,51 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+* License, v. 2.0. If a copy of the MPL was not distributed with this
+* file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+/*
+Authors:
+Michael Berg <michael.berg@zalf.de>
+
+Maintainers:
+Currently maintained by the authors.
+
+This file is part of the MONICA model.
+Copyright (C) Leibniz Centre for Agricultural Landscape Research (ZALF)
+*/
+
+#include "step-timer.h"
+
+using namespace monica;
+
+namespace {
+
+thread_local StepKernelTimes* threadTimes = nullptr;
+
+} // namespace
+
+const char* monica::stepKernelName(StepKernel k) {
+  switch (k) {
+    case CROP_MODULE_STEP: return "CropModule::step";
+    case SOIL_TEMPERATURE_STEP: return "SoilTemperature::step";
+    case SOIL_MOISTURE_STEP: return "SoilMoisture::step";
+    case SOIL_ORGANIC_STEP: return "SoilOrganic::step";
+    case SOIL_TRANSPORT_STEP: return "SoilTransport::step";
+    case STORE_RESULTS: return "StoreData::storeResultsIfSpecApplies";
+    case HOURLY_FVCB_PHOTOSYNTHESIS: return "CropModule::step (hourly FvCB photosynthesis)";
+    case _NO_OF_STEP_KERNELS_:
+    default:;
+  }
+  return "undef";
+}
+
+bool monica::stepKernelTimersCompiled() {
+#ifdef MONICA_NO_STEP_TIMERS
+  return false;
+#else
+  return true;
+#endif
+}
+
+void monica::setThreadStepKernelTimes(StepKernelTimes* times) { threadTimes = times; }
+
+StepKernelTimes* monica::threadStepKernelTimes() { return threadTimes; }
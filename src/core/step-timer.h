@@ -0,0 +1,113 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+* License, v. 2.0. If a copy of the MPL was not distributed with this
+* file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+/*
+Authors:
+Michael Berg <michael.berg@zalf.de>
+
+Maintainers:
+Currently maintained by the authors.
+
+This file is part of the MONICA model.
+Copyright (C) Leibniz Centre for Agricultural Landscape Research (ZALF)
+*/
+
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+
+#include "allocation-counter.h"
+
+namespace monica {
+
+//! the parts of the daily step which are timed separately
+enum StepKernel {
+  CROP_MODULE_STEP = 0,
+  SOIL_TEMPERATURE_STEP,
+  SOIL_MOISTURE_STEP,
+  SOIL_ORGANIC_STEP,
+  SOIL_TRANSPORT_STEP,
+  STORE_RESULTS,
+  HOURLY_FVCB_PHOTOSYNTHESIS, //!< part of CROP_MODULE_STEP
+  _NO_OF_STEP_KERNELS_
+};
+
+//! e.g. "SoilMoisture::step"
+const char* stepKernelName(StepKernel k);
+
+/*
+ * Timing of the step kernels.
+ *
+ * A timer only runs if its model is timed (MonicaModel::setStepKernelsTimed, e.g. because a perf-ns-*
+ * output is requested) or the calling thread collects the times (setThreadStepKernelTimes, e.g. monica-bench),
+ * otherwise it just checks for both. So other models and threads of the process don't pay for the timing.
+ * Building with the cmake option MONICA_STEP_TIMERS=OFF (defines MONICA_NO_STEP_TIMERS)
+ * compiles the StepKernelTimers to nothing and all times stay 0.
+ */
+
+//! true if the step kernel timers are compiled in
+bool stepKernelTimersCompiled();
+
+//! time and heap allocations spent in the step kernels
+struct StepKernelTimes {
+  uint64_t ns[_NO_OF_STEP_KERNELS_]{};
+  size_t allocations[_NO_OF_STEP_KERNELS_]{};
+};
+
+//! the step kernels running on the calling thread add their times also to times, nullptr (the default) switches this off
+void setThreadStepKernelTimes(StepKernelTimes* times);
+
+StepKernelTimes* threadStepKernelTimes();
+
+#ifndef MONICA_NO_STEP_TIMERS
+
+//! adds the time between construction and destruction to kernel k of the model's times (nullptr if the model
+//! isn't timed) and of the calling thread's times (if there are any)
+//! a kernel split into several parts (e.g. the soil temperature's prepare, solve and finish) just uses several timers
+class StepKernelTimer {
+public:
+  StepKernelTimer(StepKernel k, StepKernelTimes* modelTimes)
+    : _modelTimes(modelTimes), _threadTimes(threadStepKernelTimes()), _kernel(k) {
+    if (_modelTimes || _threadTimes) {
+      _allocationsAtStart = threadAllocationCount();
+      _start = std::chrono::steady_clock::now();
+    }
+  }
+
+  ~StepKernelTimer() {
+    if (!_modelTimes && !_threadTimes) return;
+    auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - _start);
+    auto allocations = threadAllocationCount() - _allocationsAtStart;
+    for (auto times : {_modelTimes, _threadTimes}) {
+      if (times) {
+        times->ns[_kernel] += uint64_t(ns.count());
+        times->allocations[_kernel] += allocations;
+      }
+    }
+  }
+
+  StepKernelTimer(const StepKernelTimer&) = delete;
+  StepKernelTimer& operator=(const StepKernelTimer&) = delete;
+
+private:
+  StepKernelTimes* _modelTimes{nullptr};
+  StepKernelTimes* _threadTimes{nullptr};
+  StepKernel _kernel;
+  size_t _allocationsAtStart{0};
+  std::chrono::steady_clock::time_point _start;
+};
+
+#else
+
+class StepKernelTimer {
+public:
+  StepKernelTimer(StepKernel, StepKernelTimes*) {}
+};
+
+#endif
+
+} // namespace monica
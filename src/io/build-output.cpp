@@ -18,10 +18,13 @@ Copyright (C) Leibniz Centre for Agricultural Landscape Research (ZALF)
 
 #include <fstream>
 #include <algorithm>
+#include <atomic>
 #include <mutex>
 #include <numeric>
 #include <iterator>
 #include <climits>
+#include <type_traits>
+#include <utility>
 
 #include "json11/json11-helper.h"
 #include "tools/debug.h"
@@ -92,6 +95,98 @@ Json monica::applyOIdOP(OId::OP op, const vector<Json>& js) {
   return res;
 }
 
+void OIdAccumulator::Acc::add(OId::OP op, double v) {
+  if (n == 0) min = max = first = v;
+  else {
+    if (v < min) min = v;
+    if (max < v) max = v;
+  }
+  last = v;
+  sum += v;
+  if (op == OId::MEDIAN) values.push_back(v);
+  ++n;
+}
+
+double OIdAccumulator::Acc::result(OId::OP op) const {
+  if (n == 0) return 0.0;
+
+  switch (op) {
+  case OId::AVG: return sum / n;
+  case OId::MEDIAN: return median(values);
+  case OId::SUM: return sum;
+  case OId::MIN: return min;
+  case OId::MAX: return max;
+  case OId::FIRST: return first;
+  case OId::LAST:
+  case OId::NONE:
+  default: return last;
+  }
+}
+
+void OIdAccumulator::add(const Json& value) {
+  // the first value decides how the values are being aggregated (as in applyOIdOP)
+  if (_count == 0) {
+    if (value.is_string()) _kind = STRING;
+    else if (value.is_array()) {
+      _kind = NUMBERS;
+      _accs.resize(value.array_items().size());
+    } else {
+      _kind = NUMBER;
+      _accs.resize(1);
+    }
+  }
+
+  switch (_kind) {
+  case STRING:
+    if (_count == 0) _first = value;
+    _last = value;
+    break;
+  case NUMBERS: {
+    const auto& vs = value.array_items();
+    for (size_t i = 0, size = std::min(vs.size(), _accs.size()); i < size; ++i) _accs[i].add(_op, vs[i].number_value());
+    break;
+  }
+  case NUMBER:
+  default: _accs.front().add(_op, value.number_value());
+  }
+  ++_count;
+}
+
+void OIdAccumulator::add(double value) {
+  if (_count == 0) {
+    _kind = NUMBER;
+    _accs.resize(1);
+  } else if (_kind != NUMBER) return add(Json(value));
+
+  _accs.front().add(_op, value);
+  ++_count;
+}
+
+Json OIdAccumulator::result() const {
+  if (_count == 0) return Json();
+
+  switch (_kind) {
+  case STRING: return _op == OId::LAST ? _last : _first;
+  case NUMBERS: {
+    J11Array r;
+    for (const auto& acc : _accs) r.push_back(acc.result(_op));
+    return r;
+  }
+  case NUMBER:
+  default: return _accs.front().result(_op);
+  }
+}
+
+void OIdAccumulator::clear() {
+  for (auto& acc : _accs) {
+    acc.n = 0;
+    acc.sum = 0;
+    acc.values.clear();
+  }
+  _first = _last = Json();
+  _count = 0;
+}
+
 vector<OId> monica::parseOutputIds(const J11Array& oidArray) {
   vector<OId> outputIds;
 
@@ -197,12 +292,13 @@ vector<OId> monica::parseOutputIds(const J11Array& oidArray) {
 }
 
 template <typename T, typename Vector>
-void store(OId oid, Vector& into, function<T(int)> getValue, int roundToDigits = 0) {
+void store(const OId& oid, Vector& into, function<T(int)> getValue, int roundToDigits = 0) {
   Vector multipleValues;
   vector<double> vs;
-  if (oid.isOrgan()) oid.toLayer = oid.fromLayer = int(oid.organ);
+  int fromLayer = oid.isOrgan() ? int(oid.organ) : oid.fromLayer;
+  int toLayer = oid.isOrgan() ? int(oid.organ) : oid.toLayer;
 
-  for (int i = oid.fromLayer; i <= oid.toLayer; i++) {
+  for (int i = fromLayer; i <= toLayer; i++) {
     T v = 0;
     if (i < 0) debug() << "Error: " << oid.toString(true) << " has no or negative layer defined! Returning 0." << endl;
     else v = getValue(i);
@@ -215,12 +311,13 @@ void store(OId oid, Vector& into, function<T(int)> getValue, int roundToDigits =
 }
 
 template <typename T>
-Json getComplexValues(OId oid, function<T(int)> getValue, int roundToDigits = 0) {
+Json getComplexValues(const OId& oid, function<T(int)> getValue, int roundToDigits = 0) {
   J11Array multipleValues;
   vector<double> vs;
-  if (oid.isOrgan()) oid.toLayer = oid.fromLayer = int(oid.organ);
+  int fromLayer = oid.isOrgan() ? int(oid.organ) : oid.fromLayer;
+  int toLayer = oid.isOrgan() ? int(oid.organ) : oid.toLayer;
 
-  for (int i = oid.fromLayer; i <= oid.toLayer; i++) {
+  for (int i = fromLayer; i <= toLayer; i++) {
     T v = 0;
     if (i < 0) debug() << "Error: " << oid.toString(true) << " has no or negative layer defined! Returning 0." << endl;
     else v = getValue(i);
@@ -257,12 +354,19 @@ BOTRes& monica::buildOutputTable() {
 
   //map of output ids to outputfunction
   static BOTRes m;
-  static bool tableBuilt = false;
+  static atomic<bool> tableBuilt{false};
 
   typedef decltype(m.setfs)::mapped_type SETF_T;
   auto build = [&](OutputMetadata r,
-                   decltype(m.ofs)::mapped_type of,
-                   decltype(m.setfs)::mapped_type setf = SETF_T()) {
+                   auto of,
+                   SETF_T setf = SETF_T()) {
+    // outputs of a plain number or string get also a typed output function
+    typedef decltype(of(declval<const MonicaModel&>(), declval<const OId&>())) R;
+    if constexpr (is_arithmetic<R>::value && !is_same<R, bool>::value) {
+      m.numberOfs[r.id] = [of](const MonicaModel& monica, const OId& oid) { return double(of(monica, oid)); };
+    } else if constexpr (is_same<R, string>::value) {
+      m.stringOfs[r.id] = of;
+    }
     m.ofs[r.id] = of;
     if (setf) m.setfs[r.id] = setf;
     m.name2metadata[r.name] = r;
@@ -279,107 +383,107 @@ BOTRes& monica::buildOutputTable() {
       int id = 0;
 
       build({id++, "Count", "", "output 1 for counting things"},
-            [](const MonicaModel& monica, OId oid) {
+            [](const MonicaModel& monica, const OId& oid) {
               return 1;
             });
 
       build({id++, "CM-count", "", "output the order number of the current cultivation method"},
-            [](const MonicaModel& monica, OId oid) {
+            [](const MonicaModel& monica, const OId& oid) {
               return monica.cultivationMethodCount();
             });
 
       build({id++, "Date", "", "output current date"},
-            [](const MonicaModel& monica, OId oid) {
+            [](const MonicaModel& monica, const OId& oid) {
               return monica.currentStepDate().toIsoDateString();
             });
 
       build({id++, "days-since-start", "", "output number of days since simulation start"},
-            [](const MonicaModel& monica, OId oid) {
+            [](const MonicaModel& monica, const OId& oid) {
               return monica.currentStepDate() - monica.simulationParameters().startDate;
             });
 
       build({id++, "DOY", "", "output current day of year"},
-            [](const MonicaModel& monica, OId oid) {
+            [](const MonicaModel& monica, const OId& oid) {
               return int(monica.currentStepDate().dayOfYear());
             });
 
       build({id++, "Month", "", "output current Month"},
-            [](const MonicaModel& monica, OId oid) {
+            [](const MonicaModel& monica, const OId& oid) {
               return int(monica.currentStepDate().month());
             });
 
       build({id++, "Year", "", "output current Year"},
-            [](const MonicaModel& monica, OId oid) {
+            [](const MonicaModel& monica, const OId& oid) {
               return int(monica.currentStepDate().year());
             });
 
       build({id++, "Crop", "", "crop name"},
-            [](const MonicaModel& monica, OId oid) {
+            [](const MonicaModel& monica, const OId& oid) {
               return monica.cropGrowth() ? monica.cropGrowth()->get_CropName() : "";
             });
 
       build({id++, "TraDef", "0;1", "Transpiration deficit"},
-            [](const MonicaModel& monica, OId oid) {
+            [](const MonicaModel& monica, const OId& oid) {
               return monica.cropGrowth() ? round(monica.cropGrowth()->vc_TranspirationDeficit, 2) : 0.0;
             });
 
       build({id++, "PotTraDef", "0;1", "PotentialTranspirationDeficit"},
-            [](const MonicaModel& monica, OId oid) {
+            [](const MonicaModel& monica, const OId& oid) {
               return monica.cropGrowth() ? round(monica.cropGrowth()->vc_PotentialTranspirationDeficit, 2) : 0.0;
             });
 
       build({id++, "ActTraDef", "0;1", "ActualTranspirationDeficit"},
-            [](const MonicaModel& monica, OId oid) {
+            [](const MonicaModel& monica, const OId& oid) {
               return monica.cropGrowth() ? round(monica.cropGrowth()->vc_ActualTranspirationDeficit, 2) : 0.0;
             });
 
       build({id++, "Tra", "mm", "ActualTranspiration"},
-            [](const MonicaModel& monica, OId oid) {
+            [](const MonicaModel& monica, const OId& oid) {
               return monica.cropGrowth() ? round(monica.cropGrowth()->get_ActualTranspiration(), 2) : 0.0;
             });
 
       build({id++, "TraRed", "mm", "TranspirationReduced"},
-            [](const MonicaModel& monica, OId oid) {
+            [](const MonicaModel& monica, const OId& oid) {
               return monica.cropGrowth() ? round(monica.cropGrowth()->vc_TranspirationReduced, 2) : 0.0;
             });
 
       build({id++, "Ass", "kgDM ha-1", "Assimilates"},
-            [](const MonicaModel& monica, OId oid) {
+            [](const MonicaModel& monica, const OId& oid) {
               return monica.cropGrowth() ? round(monica.cropGrowth()->get_Assimilates(), 2) : 0.0;
             });
 
       build({id++, "NDef", "0;1", "CropNRedux"},
-            [](const MonicaModel& monica, OId oid) {
+            [](const MonicaModel& monica, const OId& oid) {
               return monica.cropGrowth() ? round(monica.cropGrowth()->get_CropNRedux(), 5) : 0.0;
             });
 
       build({id++, "RootNDef", "0;1", "Root nitrogen deficit"},
-            [](const MonicaModel& monica, OId oid) {
+            [](const MonicaModel& monica, const OId& oid) {
               return monica.cropGrowth() ? round(monica.cropGrowth()->rootNRedux, 2) : 0.0;
             });
 
       build({id++, "HeatRed", "0;1", " HeatStressRedux"},
-            [](const MonicaModel& monica, OId oid) {
+            [](const MonicaModel& monica, const OId& oid) {
               return monica.cropGrowth() ? round(monica.cropGrowth()->get_HeatStressRedux(), 2) : 0.0;
             });
 
       build({id++, "FrostRed", "0;1", "FrostStressRedux"},
-            [](const MonicaModel& monica, OId oid) {
+            [](const MonicaModel& monica, const OId& oid) {
               return monica.cropGrowth() ? round(monica.cropGrowth()->get_FrostStressRedux(), 2) : 0.0;
             });
 
       build({id++, "OxRed", "0;1", "OxygenDeficit"},
-            [](const MonicaModel& monica, OId oid) {
+            [](const MonicaModel& monica, const OId& oid) {
               return monica.cropGrowth() ? round(monica.cropGrowth()->get_OxygenDeficit(), 2) : 0.0;
             });
 
       build({id++, "TimeUnderAnoxia", "0;1", "TimeUnderAnoxia"},
-            [](const MonicaModel& monica, OId oid) {
+            [](const MonicaModel& monica, const OId& oid) {
               return monica.cropGrowth() ? round(monica.cropGrowth()->vc_TimeUnderAnoxia, 2) : 0.0;
             });
 
       build({id++, "Stage", "1-6/7", "DevelopmentalStage"},
-            [](const MonicaModel& monica, OId oid) {
+            [](const MonicaModel& monica, const OId& oid) {
               return monica.cropGrowth() ? int(monica.cropGrowth()->get_DevelopmentalStage()) + 1 : 0;
             },
             [](MonicaModel& monica, OId oid, Json value) {
@@ -389,57 +493,57 @@ BOTRes& monica::buildOutputTable() {
             });
 
       build({id++, "TempSum", "�Cd", "CurrentTemperatureSum"},
-            [](const MonicaModel& monica, OId oid) {
+            [](const MonicaModel& monica, const OId& oid) {
               return monica.cropGrowth() ? round(monica.cropGrowth()->get_CurrentTemperatureSum(), 1) : 0.0;
             });
 
       build({id++, "VernF", "0;1", "VernalisationFactor"},
-            [](const MonicaModel& monica, OId oid) {
+            [](const MonicaModel& monica, const OId& oid) {
               return monica.cropGrowth() ? round(monica.cropGrowth()->get_VernalisationFactor(), 2) : 0.0;
             });
 
       build({id++, "DaylF", "0;1", "DaylengthFactor"},
-            [](const MonicaModel& monica, OId oid) {
+            [](const MonicaModel& monica, const OId& oid) {
               return monica.cropGrowth() ? round(monica.cropGrowth()->get_DaylengthFactor(), 2) : 0.0;
             });
 
       build({id++, "IncRoot", "kg ha-1", "OrganGrowthIncrement root"},
-            [](const MonicaModel& monica, OId oid) {
+            [](const MonicaModel& monica, const OId& oid) {
               return monica.cropGrowth() ? round(monica.cropGrowth()->get_OrganGrowthIncrement(OId::ROOT), 2) : 0.0;
             });
 
       build({id++, "IncLeaf", "kg ha-1", "OrganGrowthIncrement leaf"},
-            [](const MonicaModel& monica, OId oid) {
+            [](const MonicaModel& monica, const OId& oid) {
               return monica.cropGrowth() ? round(monica.cropGrowth()->get_OrganGrowthIncrement(OId::LEAF), 2) : 0.0;
             });
 
       build({id++, "IncShoot", "kg ha-1", "OrganGrowthIncrement shoot"},
-            [](const MonicaModel& monica, OId oid) {
+            [](const MonicaModel& monica, const OId& oid) {
               return monica.cropGrowth() ? round(monica.cropGrowth()->get_OrganGrowthIncrement(OId::SHOOT), 2) : 0.0;
             });
 
       build({id++, "IncFruit", "kg ha-1", "OrganGrowthIncrement fruit"},
-            [](const MonicaModel& monica, OId oid) {
+            [](const MonicaModel& monica, const OId& oid) {
               return monica.cropGrowth() ? round(monica.cropGrowth()->get_OrganGrowthIncrement(OId::FRUIT), 2) : 0.0;
             });
 
       build({id++, "RelDev", "0;1", "RelativeTotalDevelopment"},
-            [](const MonicaModel& monica, OId oid) {
+            [](const MonicaModel& monica, const OId& oid) {
               return monica.cropGrowth() ? round(monica.cropGrowth()->get_RelativeTotalDevelopment(), 2) : 0.0;
             });
 
       build({id++, "LT50", "°C", "LT50"},
-            [](const MonicaModel& monica, OId oid) {
+            [](const MonicaModel& monica, const OId& oid) {
               return monica.cropGrowth() ? round(monica.cropGrowth()->get_LT50(), 1) : 0.0;
             });
 
       build({id++, "AbBiom", "kgDM ha-1", "AbovegroundBiomass"},
-            [](const MonicaModel& monica, OId oid) {
+            [](const MonicaModel& monica, const OId& oid) {
               return monica.cropGrowth() ? round(monica.cropGrowth()->get_AbovegroundBiomass(), 1) : 0.0;
             });
 
       build({id++, "OrgBiom", "kgDM ha-1", "get_OrganBiomass(i)"},
-            [](const MonicaModel& monica, OId oid) {
+            [](const MonicaModel& monica, const OId& oid) {
               if (oid.isOrgan()
                   && monica.cropGrowth()
                   && monica.cropGrowth()->get_NumberOfOrgans() > oid.organ)
@@ -448,7 +552,7 @@ BOTRes& monica::buildOutputTable() {
             });
 
       build({id++, "OrgGreenBiom", "kgDM ha-1", "get_OrganGreenBiomass(i)"},
-            [](const MonicaModel& monica, OId oid) {
+            [](const MonicaModel& monica, const OId& oid) {
               if (oid.isOrgan()
                   && monica.cropGrowth()
                   && monica.cropGrowth()->get_NumberOfOrgans() > oid.organ)
@@ -457,12 +561,12 @@ BOTRes& monica::buildOutputTable() {
             });
 
       build({id++, "Yield", "kgDM ha-1", "get_PrimaryCropYield"},
-            [](const MonicaModel& monica, OId oid) {
+            [](const MonicaModel& monica, const OId& oid) {
               return monica.cropGrowth() ? round(monica.cropGrowth()->get_PrimaryCropYield(), 1) : 0.0;
             });
 
       build({id++, "SecondaryYield", "kgDM ha-1", "get_SecondaryCropYield"},
-            [](const MonicaModel& monica, OId oid) {
+            [](const MonicaModel& monica, const OId& oid) {
               return monica.cropGrowth() ? round(monica.cropGrowth()->get_SecondaryCropYield(), 3) : 0.0;
             });
 
@@ -472,12 +576,12 @@ BOTRes& monica::buildOutputTable() {
               "kgDM ha-1",
               "return sum (across cuts) of exported cut biomass for current crop"
             },
-            [](const MonicaModel& monica, OId oid) {
+            [](const MonicaModel& monica, const OId& oid) {
               return monica.cropGrowth() ? round(monica.cropGrowth()->sumExportedCutBiomass(), 1) : 0.0;
             });
 
       build({id++, "exportedCutBiomass", "kgDM ha-1", "return exported cut biomass for current crop and cut"},
-            [](const MonicaModel& monica, OId oid) {
+            [](const MonicaModel& monica, const OId& oid) {
               return monica.cropGrowth() ? round(monica.cropGrowth()->exportedCutBiomass(), 1) : 0.0;
             });
 
@@ -487,12 +591,12 @@ BOTRes& monica::buildOutputTable() {
               "kgDM ha-1",
               "return sum (across cuts) of residue cut biomass for current crop"
             },
-            [](const MonicaModel& monica, OId oid) {
+            [](const MonicaModel& monica, const OId& oid) {
               return monica.cropGrowth() ? round(monica.cropGrowth()->sumResidueCutBiomass(), 1) : 0.0;
             });
 
       build({id++, "residueCutBiomass", "kgDM ha-1", "return residue cut biomass for current crop and cut"},
-            [](const MonicaModel& monica, OId oid) {
+            [](const MonicaModel& monica, const OId& oid) {
               return monica.cropGrowth() ? round(monica.cropGrowth()->residueCutBiomass(), 1) : 0.0;
             });
 
@@ -502,7 +606,7 @@ BOTRes& monica::buildOutputTable() {
               "kgDM ha-1",
               "return exported part of the residues according to optimal carbon balance"
             },
-            [](const MonicaModel& monica, OId oid) {
+            [](const MonicaModel& monica, const OId& oid) {
               return round(monica.optCarbonExportedResidues(), 1);
             });
 
@@ -512,7 +616,7 @@ BOTRes& monica::buildOutputTable() {
               "kgDM ha-1",
               "return returned to soil part of the residues according to optimal carbon balance"
             },
-            [](const MonicaModel& monica, OId oid) {
+            [](const MonicaModel& monica, const OId& oid) {
               return round(monica.optCarbonReturnedResidues(), 1);
             });
 
@@ -522,111 +626,111 @@ BOTRes& monica::buildOutputTable() {
               "Heq-NRW ha-1",
               "return humus balance carry over according to optimal carbon balance"
             },
-            [](const MonicaModel& monica, OId oid) {
+            [](const MonicaModel& monica, const OId& oid) {
               return round(monica.humusBalanceCarryOver(), 1);
             });
 
 
       build({id++, "GroPhot", "kgCH2O ha-1", "GrossPhotosynthesisHaRate"},
-            [](const MonicaModel& monica, OId oid) {
+            [](const MonicaModel& monica, const OId& oid) {
               return monica.cropGrowth() ? round(monica.cropGrowth()->get_GrossPhotosynthesisHaRate(), 4) : 0.0;
             });
 
       build({id++, "NetPhot", "kgCH2O ha-1", "NetPhotosynthesis"},
-            [](const MonicaModel& monica, OId oid) {
+            [](const MonicaModel& monica, const OId& oid) {
               return monica.cropGrowth() ? round(monica.cropGrowth()->get_NetPhotosynthesis(), 2) : 0.0;
             });
 
       build({id++, "MaintR", "kgCH2O ha-1", "MaintenanceRespirationAS"},
-            [](const MonicaModel& monica, OId oid) {
+            [](const MonicaModel& monica, const OId& oid) {
               return monica.cropGrowth() ? round(monica.cropGrowth()->get_MaintenanceRespirationAS(), 4) : 0.0;
             });
 
       build({id++, "GrowthR", "kgCH2O ha-1", "GrowthRespirationAS"},
-            [](const MonicaModel& monica, OId oid) {
+            [](const MonicaModel& monica, const OId& oid) {
               return monica.cropGrowth() ? round(monica.cropGrowth()->get_GrowthRespirationAS(), 4) : 0.0;
             });
 
       build({id++, "StomRes", "s m-1", "StomataResistance"},
-            [](const MonicaModel& monica, OId oid) {
+            [](const MonicaModel& monica, const OId& oid) {
               return monica.cropGrowth() ? round(monica.cropGrowth()->get_StomataResistance(), 2) : 0.0;
             });
 
       build({id++, "Height", "m", "CropHeight"},
-            [](const MonicaModel& monica, OId oid) {
+            [](const MonicaModel& monica, const OId& oid) {
               return monica.cropGrowth() ? round(monica.cropGrowth()->get_CropHeight(), 2) : 0.0;
             });
 
       build({id++, "LAI", "m2 m-2", "LeafAreaIndex"},
-            [](const MonicaModel& monica, OId oid) {
+            [](const MonicaModel& monica, const OId& oid) {
               return monica.cropGrowth() ? round(monica.cropGrowth()->get_LeafAreaIndex(), 4) : 0.0;
             });
 
       build({id++, "RootDep", "layer#", "RootingDepth"},
-            [](const MonicaModel& monica, OId oid) {
+            [](const MonicaModel& monica, const OId& oid) {
               return monica.cropGrowth() ? int(monica.cropGrowth()->get_RootingDepth()) : 0;
             });
 
       build({id++, "EffRootDep", "m", "Effective RootingDepth"},
-            [](const MonicaModel& monica, OId oid) {
+            [](const MonicaModel& monica, const OId& oid) {
               return monica.cropGrowth() ? round(monica.cropGrowth()->getEffectiveRootingDepth(), 2) : 0.0;
             });
 
       build({id++, "TotBiomN", "kgN ha-1", "TotalBiomassNContent"},
-            [](const MonicaModel& monica, OId oid) {
+            [](const MonicaModel& monica, const OId& oid) {
               return monica.cropGrowth() ? round(monica.cropGrowth()->get_TotalBiomassNContent(), 1) : 0.0;
             });
 
       build({id++, "AbBiomN", "kgN ha-1", "AbovegroundBiomassNContent"},
-            [](const MonicaModel& monica, OId oid) {
+            [](const MonicaModel& monica, const OId& oid) {
               return monica.cropGrowth() ? round(monica.cropGrowth()->get_AbovegroundBiomassNContent(), 1) : 0.0;
             });
 
       build({id++, "SumNUp", "kgN ha-1", "SumTotalNUptake"},
-            [](const MonicaModel& monica, OId oid) {
+            [](const MonicaModel& monica, const OId& oid) {
               return monica.cropGrowth() ? round(monica.cropGrowth()->get_SumTotalNUptake(), 2) : 0.0;
             });
 
       build({id++, "ActNup", "kgN ha-1", "ActNUptake"},
-            [](const MonicaModel& monica, OId oid) {
+            [](const MonicaModel& monica, const OId& oid) {
               return monica.cropGrowth() ? round(monica.cropGrowth()->get_ActNUptake(), 2) : 0.0;
             });
 
       build({id++, "RootWaUptak", "KgN ha-1", "RootWatUptakefromLayer"},
-            [](const MonicaModel& monica, OId oid) {
+            [](const MonicaModel& monica, const OId& oid) {
               return getComplexValues<double>(oid, [&](int i) {
                 return monica.cropGrowth() ? monica.cropGrowth()->get_Transpiration(i) : 0.0;
               }, 4);
             });
 
       build({id++, "PotNup", "kgN ha-1", "PotNUptake"},
-            [](const MonicaModel& monica, OId oid) {
+            [](const MonicaModel& monica, const OId& oid) {
               return monica.cropGrowth() ? round(monica.cropGrowth()->get_PotNUptake(), 2) : 0.0;
             });
 
       build({id++, "NFixed", "kgN ha-1", "NFixed"},
-            [](const MonicaModel& monica, OId oid) {
+            [](const MonicaModel& monica, const OId& oid) {
               return monica.cropGrowth() ? round(monica.cropGrowth()->get_BiologicalNFixation(), 2) : 0.0;
             });
 
       build({id++, "Target", "kgN ha-1", "TargetNConcentration"},
-            [](const MonicaModel& monica, OId oid) {
+            [](const MonicaModel& monica, const OId& oid) {
               return monica.cropGrowth() ? round(monica.cropGrowth()->get_TargetNConcentration(), 3) : 0.0;
             });
 
       build({id++, "CritN", "kgN ha-1", "CriticalNConcentration"},
-            [](const MonicaModel& monica, OId oid) {
+            [](const MonicaModel& monica, const OId& oid) {
               return monica.cropGrowth() ? round(monica.cropGrowth()->get_CriticalNConcentration(), 5) : 0.0;
             });
 
       build({id++, "AbBiomNc", "kgN ha-1", "AbovegroundBiomassNConcentration"},
-            [](const MonicaModel& monica, OId oid) {
+            [](const MonicaModel& monica, const OId& oid) {
               return monica.cropGrowth() ? round(monica.cropGrowth()->get_AbovegroundBiomassNConcentration(), 5) : 0.0;
             });
 
       build({id++, "Nstress", "-", "NitrogenStressIndex"}
 
-            , [](const MonicaModel& monica, OId oid) {
+            , [](const MonicaModel& monica, const OId& oid) {
               double Nstress = 0;
               double AbBiomNc = monica.cropGrowth()
                                   ? round(monica.cropGrowth()->get_AbovegroundBiomassNConcentration(), 5)
@@ -640,28 +744,28 @@ BOTRes& monica::buildOutputTable() {
             });
 
       build({id++, "YieldNc", "kgN ha-1", "PrimaryYieldNConcentration"},
-            [](const MonicaModel& monica, OId oid) {
+            [](const MonicaModel& monica, const OId& oid) {
               return monica.cropGrowth() ? round(monica.cropGrowth()->get_PrimaryYieldNConcentration(), 3) : 0.0;
             });
 
 
       build({id++, "YieldN", "kgN ha-1", "PrimaryYieldNContent"},
-            [](const MonicaModel& monica, OId oid) {
+            [](const MonicaModel& monica, const OId& oid) {
               return monica.cropGrowth() ? round(monica.cropGrowth()->get_PrimaryYieldNContent(), 3) : 0.0;
             });
 
       build({id++, "Protein", "kg kg-1", "RawProteinConcentration"},
-            [](const MonicaModel& monica, OId oid) {
+            [](const MonicaModel& monica, const OId& oid) {
               return monica.cropGrowth() ? round(monica.cropGrowth()->get_RawProteinConcentration(), 3) : 0.0;
             });
 
       build({id++, "NPP", "kgC ha-1", "NPP"},
-            [](const MonicaModel& monica, OId oid) {
+            [](const MonicaModel& monica, const OId& oid) {
               return monica.cropGrowth() ? round(monica.cropGrowth()->get_NetPrimaryProduction(), 5) : 0.0;
             });
 
       build({id++, "NPP-Organs", "kgC ha-1", "organ specific NPP"},
-            [](const MonicaModel& monica, OId oid) {
+            [](const MonicaModel& monica, const OId& oid) {
               if (oid.isOrgan()
                   && monica.cropGrowth()
                   && monica.cropGrowth()->get_NumberOfOrgans() > oid.organ)
@@ -670,27 +774,27 @@ BOTRes& monica::buildOutputTable() {
             });
 
       build({id++, "GPP", "kgC ha-1", "GPP"},
-            [](const MonicaModel& monica, OId oid) {
+            [](const MonicaModel& monica, const OId& oid) {
               return monica.cropGrowth() ? round(monica.cropGrowth()->get_GrossPrimaryProduction(), 5) : 0.0;
             });
 
       build({id++, "LightInterception1", "", "LightInterception of single crop or top layer of taller crop"},
-            [](const MonicaModel& monica, OId oid) {
+            [](const MonicaModel& monica, const OId& oid) {
               return monica.cropGrowth() ? round(monica.cropGrowth()->getFractionOfInterceptedRadiation1(), 5) : 0.0;
             });
 
       build({id++, "LightInterception2", "", "LightInterception of lower layer of taller crop"},
-            [](const MonicaModel& monica, OId oid) {
+            [](const MonicaModel& monica, const OId& oid) {
               return monica.cropGrowth() ? round(monica.cropGrowth()->getFractionOfInterceptedRadiation2(), 5) : 0.0;
             });
 
       build({id++, "Ra", "kgC ha-1", "autotrophic respiration"},
-            [](const MonicaModel& monica, OId oid) {
+            [](const MonicaModel& monica, const OId& oid) {
               return monica.cropGrowth() ? round(monica.cropGrowth()->get_AutotrophicRespiration(), 5) : 0.0;
             });
 
       build({id++, "Ra-Organs", "kgC ha-1", "organ specific autotrophic respiration"},
-            [](const MonicaModel& monica, OId oid) {
+            [](const MonicaModel& monica, const OId& oid) {
               if (oid.isOrgan()
                   && monica.cropGrowth()
                   && monica.cropGrowth()->get_NumberOfOrgans() > oid.organ)
@@ -699,7 +803,7 @@ BOTRes& monica::buildOutputTable() {
             });
 
       build({id++, "Mois", "m3 m-3", "Soil moisture content"},
-            [](const MonicaModel& monica, OId oid) {
+            [](const MonicaModel& monica, const OId& oid) {
               return getComplexValues<double>(oid, [&](int i) { return monica.soilMoisture().get_SoilMoisture(i); }, 3);
             },
             [](MonicaModel& monica, OId oid, Json value) {
@@ -709,7 +813,7 @@ BOTRes& monica::buildOutputTable() {
             });
 
       build({id++, "ActNupLayer", "KgN ha-1", "ActNUptakefromLayer"},
-            [](const MonicaModel& monica, OId oid) {
+            [](const MonicaModel& monica, const OId& oid) {
               return getComplexValues<double>(oid, [&](int i) {
                 return monica.cropGrowth() ? monica.cropGrowth()->get_NUptakeFromLayer(i) * 10000.0 : 0.0;
               }, 4);
@@ -717,71 +821,71 @@ BOTRes& monica::buildOutputTable() {
 
 
       build({id++, "Irrig", "mm", "Irrigation"},
-            [](const MonicaModel& monica, OId oid) {
+            [](const MonicaModel& monica, const OId& oid) {
               return round(monica.dailySumIrrigationWater(), 3);
             });
 
       build({id++, "Infilt", "mm", "Infiltration"},
-            [](const MonicaModel& monica, OId oid) {
+            [](const MonicaModel& monica, const OId& oid) {
               return round(monica.soilMoisture().get_Infiltration(), 1);
             });
 
       build({id++, "Surface", "mm", "Surface water storage"},
-            [](const MonicaModel& monica, OId oid) {
+            [](const MonicaModel& monica, const OId& oid) {
               return round(monica.soilMoisture().get_SurfaceWaterStorage(), 1);
             });
 
       build({id++, "RunOff", "mm", "Surface runoff of current day"},
-            [](const MonicaModel& monica, OId oid) {
+            [](const MonicaModel& monica, const OId& oid) {
               return round(monica.soilMoisture().get_SurfaceRunOff(), 1);
             });
 
       build({id++, "SnowD", "mm", "Snow depth"},
-            [](const MonicaModel& monica, OId oid) {
+            [](const MonicaModel& monica, const OId& oid) {
               return round(monica.soilMoisture().get_SnowDepth(), 1);
             });
 
       build({id++, "FrostD", "m", "Frost front depth in soil"},
-            [](const MonicaModel& monica, OId oid) {
+            [](const MonicaModel& monica, const OId& oid) {
               return round(monica.soilMoisture().get_FrostDepth(), 1);
             });
 
       build({id++, "ThawD", "m", "Thaw front depth in soil"},
-            [](const MonicaModel& monica, OId oid) {
+            [](const MonicaModel& monica, const OId& oid) {
               return round(monica.soilMoisture().get_ThawDepth(), 1);
             });
 
       build({id++, "PASW", "m3 m-3", "PASW"},
-            [](const MonicaModel& monica, OId oid) {
+            [](const MonicaModel& monica, const OId& oid) {
               return getComplexValues<double>(oid, [&](int i) {
                 return monica.soilMoisture().get_SoilMoisture(i) - monica.soilColumn().at(i).vs_PermanentWiltingPoint();
               }, 3);
             });
 
       build({id++, "SurfTemp", "�C", ""},
-            [](const MonicaModel& monica, OId oid) {
+            [](const MonicaModel& monica, const OId& oid) {
               return round(monica.soilTemperature().getSoilSurfaceTemperature(), 1);
             });
 
       build({id++, "STemp", "�C", ""},
-            [](const MonicaModel& monica, OId oid) {
+            [](const MonicaModel& monica, const OId& oid) {
               return getComplexValues<double>(oid, [&](int i) {
                 return monica.soilTemperature().getSoilTemperature(i);
               }, 1);
             });
 
       build({id++, "Act_Ev", "mm", "Actual evaporation"},
-            [](const MonicaModel& monica, OId oid) {
+            [](const MonicaModel& monica, const OId& oid) {
               return round(monica.soilMoisture().get_ActualEvaporation(), 1);
             });
 
       build({id++, "Pot_ET", "mm", "potential evapotranspiration = ET0 * Kc = the plants water use"}
-            , [](const MonicaModel& monica, OId oid) {
+            , [](const MonicaModel& monica, const OId& oid) {
               return round(monica.soilMoisture().get_PotentialEvapotranspiration(), 1);
             });
 
       build({id++, "Evaporated_from_surface", "mm", "evaporated from surface"},
-            [](const MonicaModel& monica, OId oid) {
+            [](const MonicaModel& monica, const OId& oid) {
               return round(monica.soilMoisture().vm_EvaporatedFromSurface, 1);
             });
 
@@ -791,7 +895,7 @@ BOTRes& monica::buildOutputTable() {
               "mm",
               "actual evapotranspiration = Act_Trans + Act_Ev + Evaporation_from_intercept + Evaporated_from_surface"
             },
-            [](const MonicaModel& monica, OId oid) {
+            [](const MonicaModel& monica, const OId& oid) {
               return round(monica.soilMoisture().get_ActualEvapotranspiration(), 1);
             });
 
@@ -802,101 +906,101 @@ BOTRes& monica::buildOutputTable() {
       //});
 
       build({id++, "ET0", "mm", "Reference evapotranspiration"},
-            [](const MonicaModel& monica, OId oid) {
+            [](const MonicaModel& monica, const OId& oid) {
               return round(monica.soilMoisture().get_ET0(), 1);
             });
 
       build({id++, "Kc", "", "plant coefficient to calculate with ET0 the plants water use (ET0 * Kc)"},
-            [](const MonicaModel& monica, OId oid) {
+            [](const MonicaModel& monica, const OId& oid) {
               return round(monica.soilMoisture().get_KcFactor(), 3);
             });
 
       build({id++, "Kcb", "", "Basal crop coefficient (FAO-56 Dual Kc)"},
-            [](const MonicaModel& monica, OId oid) {
+            [](const MonicaModel& monica, const OId& oid) {
               return monica.cropGrowth() ? round(monica.cropGrowth()->get_KcbFactor(), 3) : 0.0;
             });
 
       build({id++, "Ke", "", "Soil evaporation coefficient (FAO-56 Dual Kc)"},
-            [](const MonicaModel& monica, OId oid) {
+            [](const MonicaModel& monica, const OId& oid) {
               return round(monica.soilMoisture().get_KeFactor(), 3);
             });
 
       build({id++, "AtmCO2", "ppm", "Atmospheric CO2 concentration"},
-            [](const MonicaModel& monica, OId oid) {
+            [](const MonicaModel& monica, const OId& oid) {
               return round(monica.get_AtmosphericCO2Concentration(), 0);
             });
 
       build({id++, "AtmO3", "ppb", "Atmospheric O3 concentration"},
-            [](const MonicaModel& monica, OId oid) {
+            [](const MonicaModel& monica, const OId& oid) {
               return round(monica.get_AtmosphericO3Concentration(), 0);
             });
 
       build({id++, "Groundw", "m", "rounded according to interna usage"},
-            [](const MonicaModel& monica, OId oid) {
+            [](const MonicaModel& monica, const OId& oid) {
               return round(monica.get_GroundwaterDepth(), 2);
             });
 
       build({id++, "Recharge", "mm", "Groundwater recharge"},
-            [](const MonicaModel& monica, OId oid) {
+            [](const MonicaModel& monica, const OId& oid) {
               return round(monica.soilMoisture().get_GroundwaterRecharge(), 3);
             });
 
       build({id++, "NLeach", "kgN ha-1", "N leaching"},
-            [](const MonicaModel& monica, OId oid) {
+            [](const MonicaModel& monica, const OId& oid) {
               return round(monica.soilTransport().get_NLeaching(), 3);
             });
 
       build({id++, "NO3", "kgN m-3", ""},
-            [](const MonicaModel& monica, OId oid) {
+            [](const MonicaModel& monica, const OId& oid) {
               return getComplexValues<double>(oid, [&](int i) { return monica.soilColumn().at(i).get_SoilNO3(); }, 6);
             },
             [](MonicaModel& monica, OId oid, Json value) {
               setComplexValues(oid, [&](int i, Json j) {
-                if (j.is_number()) monica.soilColumnNC()[i].vs_SoilNO3 = j.number_value();
+                if (j.is_number()) monica.soilColumnNC()[i].vs_SoilNO3() = j.number_value();
               }, value);
             });
 
       build({id++, "Carb", "kgN m-3", "Soil Carbamid"},
-            [](const MonicaModel& monica, OId oid) {
+            [](const MonicaModel& monica, const OId& oid) {
               //return round(monica.soilColumn().at(0).get_SoilCarbamid(), 4);
               return getComplexValues<double>(oid, [&](int i) { return monica.soilColumn().at(i).get_SoilCarbamid(); },
                                               4);
             },
             [](MonicaModel& monica, OId oid, Json value) {
               setComplexValues(oid, [&](int i, Json j) {
-                if (j.is_number()) monica.soilColumnNC()[i].vs_SoilCarbamid = j.number_value();
+                if (j.is_number()) monica.soilColumnNC()[i].vs_SoilCarbamid() = j.number_value();
               }, value);
             });
 
       build({id++, "NH4", "kgN m-3", ""},
-            [](const MonicaModel& monica, OId oid) {
+            [](const MonicaModel& monica, const OId& oid) {
               return getComplexValues<double>(oid, [&](int i) { return monica.soilColumn().at(i).get_SoilNH4(); }, 6);
             },
             [](MonicaModel& monica, OId oid, Json value) {
               setComplexValues(oid, [&](int i, Json j) {
-                if (j.is_number()) monica.soilColumnNC()[i].vs_SoilNH4 = j.number_value();
+                if (j.is_number()) monica.soilColumnNC()[i].vs_SoilNH4() = j.number_value();
               }, value);
             });
 
       build({id++, "NO2", "kgN m-3", ""},
-            [](const MonicaModel& monica, OId oid) {
+            [](const MonicaModel& monica, const OId& oid) {
               return getComplexValues<double>(oid, [&](int i) { return monica.soilColumn().at(i).get_SoilNO2(); }, 6);
             },
             [](MonicaModel& monica, OId oid, Json value) {
               setComplexValues(oid, [&](int i, Json j) {
-                if (j.is_number()) monica.soilColumnNC()[i].vs_SoilNO2 = j.number_value();
+                if (j.is_number()) monica.soilColumnNC()[i].vs_SoilNO2() = j.number_value();
               }, value);
             });
 
       build({id++, "SOC", "kgC kg-1", "get soil organic carbon content"},
-            [](const MonicaModel& monica, OId oid) {
+            [](const MonicaModel& monica, const OId& oid) {
               return getComplexValues<double>(oid, [&](int i) {
                 return monica.soilColumn().at(i).vs_SoilOrganicCarbon();
               }, 6);
             });
 
       build({id++, "SOC-X-Y", "gC m-2", "SOC-X-Y"},
-            [](const MonicaModel& monica, OId oid) {
+            [](const MonicaModel& monica, const OId& oid) {
               return getComplexValues<double>(oid, [&](int i) {
                 return monica.soilColumn().at(i).vs_SoilOrganicCarbon()
                        * monica.soilColumn().at(i).vs_SoilBulkDensity()
@@ -906,7 +1010,7 @@ BOTRes& monica::buildOutputTable() {
             });
 
       build({id++, "OrgN", "kg N m-3", "get_Organic_N"},
-            [](const MonicaModel& monica, OId oid) {
+            [](const MonicaModel& monica, const OId& oid) {
               auto nools = int(monica.soilColumn().vs_NumberOfOrganicLayers());
               oid.fromLayer = min(oid.fromLayer, nools - 1);
               oid.toLayer = min(oid.toLayer, nools - 1);
@@ -914,7 +1018,7 @@ BOTRes& monica::buildOutputTable() {
             });
 
       build({id++, "AOMf", "kgC m-3", "get_AOM_FastSum"},
-            [](const MonicaModel& monica, OId oid) {
+            [](const MonicaModel& monica, const OId& oid) {
               auto nools = int(monica.soilColumn().vs_NumberOfOrganicLayers());
               oid.fromLayer = min(oid.fromLayer, nools - 1);
               oid.toLayer = min(oid.toLayer, nools - 1);
@@ -922,7 +1026,7 @@ BOTRes& monica::buildOutputTable() {
             });
 
       build({id++, "AOMs", "kgC m-3", "get_AOM_SlowSum"},
-            [](const MonicaModel& monica, OId oid) {
+            [](const MonicaModel& monica, const OId& oid) {
               auto nools = int(monica.soilColumn().vs_NumberOfOrganicLayers());
               oid.fromLayer = min(oid.fromLayer, nools - 1);
               oid.toLayer = min(oid.toLayer, nools - 1);
@@ -930,7 +1034,7 @@ BOTRes& monica::buildOutputTable() {
             });
 
       build({id++, "SMBf", "kgC m-3", "get_SMB_Fast"},
-            [](const MonicaModel& monica, OId oid) {
+            [](const MonicaModel& monica, const OId& oid) {
               auto nools = int(monica.soilColumn().vs_NumberOfOrganicLayers());
               oid.fromLayer = min(oid.fromLayer, nools - 1);
               oid.toLayer = min(oid.toLayer, nools - 1);
@@ -938,7 +1042,7 @@ BOTRes& monica::buildOutputTable() {
             });
 
       build({id++, "SMBs", "kgC m-3", "get_SMB_Slow"},
-            [](const MonicaModel& monica, OId oid) {
+            [](const MonicaModel& monica, const OId& oid) {
               auto nools = int(monica.soilColumn().vs_NumberOfOrganicLayers());
               oid.fromLayer = min(oid.fromLayer, nools - 1);
               oid.toLayer = min(oid.toLayer, nools - 1);
@@ -946,7 +1050,7 @@ BOTRes& monica::buildOutputTable() {
             });
 
       build({id++, "SOMf", "kgC m-3", "get_SOM_Fast"},
-            [](const MonicaModel& monica, OId oid) {
+            [](const MonicaModel& monica, const OId& oid) {
               auto nools = int(monica.soilColumn().vs_NumberOfOrganicLayers());
               oid.fromLayer = min(oid.fromLayer, nools - 1);
               oid.toLayer = min(oid.toLayer, nools - 1);
@@ -954,7 +1058,7 @@ BOTRes& monica::buildOutputTable() {
             });
 
       build({id++, "SOMs", "kgC m-3", "get_SOM_Slow"},
-            [](const MonicaModel& monica, OId oid) {
+            [](const MonicaModel& monica, const OId& oid) {
               auto nools = int(monica.soilColumn().vs_NumberOfOrganicLayers());
               oid.fromLayer = min(oid.fromLayer, nools - 1);
               oid.toLayer = min(oid.toLayer, nools - 1);
@@ -962,7 +1066,7 @@ BOTRes& monica::buildOutputTable() {
             });
 
       build({id++, "CBal", "kgC m-3", "get_CBalance"},
-            [](const MonicaModel& monica, OId oid) {
+            [](const MonicaModel& monica, const OId& oid) {
               auto nools = int(monica.soilColumn().vs_NumberOfOrganicLayers());
               oid.fromLayer = min(oid.fromLayer, nools - 1);
               oid.toLayer = min(oid.toLayer, nools - 1);
@@ -970,7 +1074,7 @@ BOTRes& monica::buildOutputTable() {
             });
 
       build({id++, "Nmin", "kgN ha-1", "NetNMineralisationRate"},
-            [](const MonicaModel& monica, OId oid) {
+            [](const MonicaModel& monica, const OId& oid) {
               auto nools = int(monica.soilColumn().vs_NumberOfOrganicLayers());
               oid.fromLayer = min(oid.fromLayer, nools - 1);
               oid.toLayer = min(oid.toLayer, nools - 1);
@@ -980,123 +1084,114 @@ BOTRes& monica::buildOutputTable() {
             });
 
       build({id++, "NetNmin", "kgN ha-1", "NetNmin"},
-            [](const MonicaModel& monica, OId oid) {
+            [](const MonicaModel& monica, const OId& oid) {
               return round(monica.soilOrganic().get_NetNMineralisation(), 5);
             });
 
       build({id++, "Denit", "kgN ha-1", "Denit"},
-            [](const MonicaModel& monica, OId oid) {
+            [](const MonicaModel& monica, const OId& oid) {
               return round(monica.soilOrganic().get_Denitrification(), 5);
             });
 
       build({id++, "N2O", "kgN ha-1", "N2O"},
-            [](const MonicaModel& monica, OId oid) {
+            [](const MonicaModel& monica, const OId& oid) {
               return round(monica.soilOrganic().get_N2O_Produced(), 5);
             });
       build({id++, "N2Onit", "kgN ha-1", "N2O from nitrification"},
-            [](const MonicaModel& monica, OId oid) {
+            [](const MonicaModel& monica, const OId& oid) {
               return round(monica.soilOrganic().get_N2O_Produced_Nit(), 5);
             });
       build({id++, "N2Odenit", "kgN ha-1", "N2O from denitrification"},
-            [](const MonicaModel& monica, OId oid) {
+            [](const MonicaModel& monica, const OId& oid) {
               return round(monica.soilOrganic().get_N2O_Produced_Denit(), 5);
             });
 
       build({id++, "SoilpH", "", "SoilpH"},
-            [](const MonicaModel& monica, OId oid) {
+            [](const MonicaModel& monica, const OId& oid) {
               return round(monica.soilColumn().at(0).get_SoilpH(), 1);
             });
 
       build({id++, "NEP", "kgC ha-1", "NEP"},
-            [](const MonicaModel& monica, OId oid) {
+            [](const MonicaModel& monica, const OId& oid) {
               return round(monica.soilOrganic().get_NetEcosystemProduction(), 5);
             });
 
       build({id++, "NEE", "kgC ha-", "NEE"},
-            [](const MonicaModel& monica, OId oid) {
+            [](const MonicaModel& monica, const OId& oid) {
               return round(monica.soilOrganic().get_NetEcosystemExchange(), 5);
             });
 
       build({id++, "Rh", "kgC ha-", "Rh"},
-            [](const MonicaModel& monica, OId oid) {
+            [](const MonicaModel& monica, const OId& oid) {
               return round(monica.soilOrganic().get_DecomposerRespiration(), 5);
             });
 
       build({id++, "Tmin", "", ""},
-            [](const MonicaModel& monica, OId oid) {
+            [](const MonicaModel& monica, const OId& oid) {
               const auto& cd = monica.currentStepClimateData();
-              auto ci = cd.find(Climate::tmin);
-              return ci == cd.end() ? 0.0 : round(ci->second, 4);
+              return cd.has(Climate::tmin) ? round(cd.values[Climate::tmin], 4) : 0.0;
             });
 
       build({id++, "Tavg", "", ""},
-            [](const MonicaModel& monica, OId oid) {
+            [](const MonicaModel& monica, const OId& oid) {
               const auto& cd = monica.currentStepClimateData();
-              auto ci = cd.find(Climate::tavg);
-              return ci == cd.end() ? 0.0 : round(ci->second, 4);
+              return cd.has(Climate::tavg) ? round(cd.values[Climate::tavg], 4) : 0.0;
             });
 
       build({id++, "Tmax", "", ""},
-            [](const MonicaModel& monica, OId oid) {
+            [](const MonicaModel& monica, const OId& oid) {
               const auto& cd = monica.currentStepClimateData();
-              auto ci = cd.find(Climate::tmax);
-              return ci == cd.end() ? 0.0 : round(ci->second, 4);
+              return cd.has(Climate::tmax) ? round(cd.values[Climate::tmax], 4) : 0.0;
             });
 
       build({id++, "Tmax>=40", "0|1", "if Tmax >= 40�C then 1 else 0"},
-            [](const MonicaModel& monica, OId oid) {
+            [](const MonicaModel& monica, const OId& oid) {
               const auto& cd = monica.currentStepClimateData();
-              auto ci = cd.find(Climate::tmax);
-              return ci == cd.end() ? 0 : (ci->second >= 40 ? 1 : 0);
+              return cd.has(Climate::tmax) ? (cd.values[Climate::tmax] >= 40 ? 1 : 0) : 0;
             });
 
       build({id++, "Precip", "mm", "Precipitation"},
-            [](const MonicaModel& monica, OId oid) {
+            [](const MonicaModel& monica, const OId& oid) {
               const auto& cd = monica.currentStepClimateData();
-              auto ci = cd.find(Climate::precip);
-              return ci == cd.end() ? 0.0 : round(ci->second, 4);
+              return cd.has(Climate::precip) ? round(cd.values[Climate::precip], 4) : 0.0;
             });
 
       build({id++, "Wind", "", ""},
-            [](const MonicaModel& monica, OId oid) {
+            [](const MonicaModel& monica, const OId& oid) {
               const auto& cd = monica.currentStepClimateData();
-              auto ci = cd.find(Climate::wind);
-              return ci == cd.end() ? 0.0 : round(ci->second, 4);
+              return cd.has(Climate::wind) ? round(cd.values[Climate::wind], 4) : 0.0;
             });
 
       build({id++, "Globrad", "", ""},
-            [](const MonicaModel& monica, OId oid) {
+            [](const MonicaModel& monica, const OId& oid) {
               const auto& cd = monica.currentStepClimateData();
-              auto ci = cd.find(Climate::globrad);
-              return ci == cd.end() ? 0.0 : round(ci->second, 4);
+              return cd.has(Climate::globrad) ? round(cd.values[Climate::globrad], 4) : 0.0;
             });
 
       build({id++, "Relhumid", "", ""},
-            [](const MonicaModel& monica, OId oid) {
+            [](const MonicaModel& monica, const OId& oid) {
               const auto& cd = monica.currentStepClimateData();
-              auto ci = cd.find(Climate::relhumid);
-              return ci == cd.end() ? 0.0 : round(ci->second, 4);
+              return cd.has(Climate::relhumid) ? round(cd.values[Climate::relhumid], 4) : 0.0;
             });
 
       build({id++, "Sunhours", "", ""},
-            [](const MonicaModel& monica, OId oid) {
+            [](const MonicaModel& monica, const OId& oid) {
               const auto& cd = monica.currentStepClimateData();
-              auto ci = cd.find(Climate::sunhours);
-              return ci == cd.end() ? 0.0 : round(ci->second, 4);
+              return cd.has(Climate::sunhours) ? round(cd.values[Climate::sunhours], 4) : 0.0;
             });
 
       build({id++, "BedGrad", "0;1", ""},
-            [](const MonicaModel& monica, OId oid) {
+            [](const MonicaModel& monica, const OId& oid) {
               return round(monica.soilMoisture().get_PercentageSoilCoverage(), 3);
             });
 
       build({id++, "N", "kgN m-3", ""},
-            [](const MonicaModel& monica, OId oid) {
+            [](const MonicaModel& monica, const OId& oid) {
               return getComplexValues<double>(oid, [&](int i) { return monica.soilColumn().at(i).get_SoilNmin(); }, 3);
             });
 
       build({id++, "Co", "kgC m-3", ""},
-            [](const MonicaModel& monica, OId oid) {
+            [](const MonicaModel& monica, const OId& oid) {
               auto nools = int(monica.soilColumn().vs_NumberOfOrganicLayers());
               oid.fromLayer = min(oid.fromLayer, nools - 1);
               oid.toLayer = min(oid.toLayer, nools - 1);
@@ -1104,33 +1199,33 @@ BOTRes& monica::buildOutputTable() {
             });
 
       build({id++, "NH3", "kgN ha-1", "NH3_Volatilised"},
-            [](const MonicaModel& monica, OId oid) {
+            [](const MonicaModel& monica, const OId& oid) {
               return round(monica.soilOrganic().get_NH3_Volatilised(), 3);
             });
 
       build({id++, "NFert", "kgN ha-1", "dailySumFertiliser"},
-            [](const MonicaModel& monica, OId oid) {
+            [](const MonicaModel& monica, const OId& oid) {
               return round(monica.dailySumFertiliser(), 1);
             });
 
       build({id++, "SumNFert", "kgN ha-1", "sum of N fertilizer applied during cropping period"},
-            [](const MonicaModel& monica, OId oid) {
+            [](const MonicaModel& monica, const OId& oid) {
               return round(monica.sumFertiliser(), 1);
             });
 
       build({id++, "NOrgFert", "kgN ha-1", "dailySumOrgFertiliser"},
-            [](const MonicaModel& monica, OId oid) {
+            [](const MonicaModel& monica, const OId& oid) {
               return round(monica.dailySumOrgFertiliser(), 1);
             });
 
       build({id++, "SumNOrgFert", "kgN ha-1", "sum of N of organic fertilizer applied during cropping period"},
-            [](const MonicaModel& monica, OId oid) {
+            [](const MonicaModel& monica, const OId& oid) {
               return round(monica.sumOrgFertiliser(), 1);
             });
 
 
       build({id++, "WaterContent", "fraction nFC", "soil water content in % of available soil water"},
-            [](const MonicaModel& monica, OId oid) {
+            [](const MonicaModel& monica, const OId& oid) {
               return getComplexValues<double>(oid, [&](int i) {
                 double smm3 = monica.soilMoisture().get_SoilMoisture(i);
                 double fc = monica.soilColumn().at(i).vs_FieldCapacity();
@@ -1140,7 +1235,7 @@ BOTRes& monica::buildOutputTable() {
             });
 
       build({id++, "AWC", "m3 m-3", "available water capacity"},
-            [](const MonicaModel& monica, OId oid) {
+            [](const MonicaModel& monica, const OId& oid) {
               return getComplexValues<double>(oid, [&](int i) {
                 double fc = monica.soilColumn().at(i).vs_FieldCapacity();
                 double pwp = monica.soilColumn().at(i).vs_PermanentWiltingPoint();
@@ -1149,20 +1244,20 @@ BOTRes& monica::buildOutputTable() {
             });
 
       build({id++, "CapillaryRise", "mm", "capillary rise"},
-            [](const MonicaModel& monica, OId oid) {
+            [](const MonicaModel& monica, const OId& oid) {
               return getComplexValues<double>(oid, [&](int i) {
                 return monica.soilMoisture().get_CapillaryRise(i);
               }, 3);
             });
 
       build({id++, "PercolationRate", "mm", "percolation rate"},
-            [](const MonicaModel& monica, OId oid) {
+            [](const MonicaModel& monica, const OId& oid) {
               return getComplexValues<double>(oid, [&](int i) { return monica.soilMoisture().get_PercolationRate(i); },
                                               3);
             });
 
       build({id++, "SMB-CO2-ER", "", "soilOrganic.get_SMB_CO2EvolutionRate"},
-            [](const MonicaModel& monica, OId oid) {
+            [](const MonicaModel& monica, const OId& oid) {
               auto nools = int(monica.soilColumn().vs_NumberOfOrganicLayers());
               oid.fromLayer = min(oid.fromLayer, nools - 1);
               oid.toLayer = min(oid.toLayer, nools - 1);
@@ -1172,62 +1267,62 @@ BOTRes& monica::buildOutputTable() {
             });
 
       build({id++, "Evapotranspiration", "mm", "Remaining evapotranspiration"},
-            [](const MonicaModel& monica, OId oid) {
+            [](const MonicaModel& monica, const OId& oid) {
               return monica.cropGrowth() ? round(monica.cropGrowth()->get_RemainingEvapotranspiration(), 1) : 0.0;
             });
 
       build({id++, "Evaporation_from_intercept", "mm", "Evaporation from intercepted water"},
-            [](const MonicaModel& monica, OId oid) {
+            [](const MonicaModel& monica, const OId& oid) {
               return monica.cropGrowth() ? round(monica.cropGrowth()->get_EvaporatedFromIntercept(), 1) : 0.0;
             });
 
       build({id++, "Evaporation", "mm", "Evaporation from intercepted water"},
-            [](const MonicaModel& monica, OId oid) {
+            [](const MonicaModel& monica, const OId& oid) {
               return monica.cropGrowth() ? round(monica.cropGrowth()->get_EvaporatedFromIntercept(), 1) : 0.0;
             });
 
       build({id++, "ETa/ETc", "", "Act_ET / Pot_ET"},
-            [](const MonicaModel& monica, OId oid) {
+            [](const MonicaModel& monica, const OId& oid) {
               auto potET = monica.soilMoisture().get_PotentialEvapotranspiration();
               auto actET = monica.soilMoisture().get_ActualEvapotranspiration();
               return potET > 0 ? round(actET / potET, 2) : 1.0;
             });
 
       build({id++, "Tra", "mm", "ActualTranspiration"},
-            [](const MonicaModel& monica, OId oid) {
+            [](const MonicaModel& monica, const OId& oid) {
               return monica.cropGrowth() ? round(monica.cropGrowth()->get_ActualTranspiration(), 2) : 0.0;
             });
 
       build({id++, "Act_Trans", "mm", "actual transpiration"},
-            [](const MonicaModel& monica, OId oid) {
+            [](const MonicaModel& monica, const OId& oid) {
               return monica.cropGrowth() ? round(monica.cropGrowth()->get_ActualTranspiration(), 1) : 0.0;
             });
 
       build({id++, "Transpiration", "mm", "actual transpiration"},
-            [](const MonicaModel& monica, OId oid) {
+            [](const MonicaModel& monica, const OId& oid) {
               return monica.cropGrowth() ? round(monica.cropGrowth()->get_ActualTranspiration(), 1) : 0.0;
             });
 
       build({id++, "GrainN", "kg ha-1", "get_FruitBiomassNContent"},
-            [](const MonicaModel& monica, OId oid) {
+            [](const MonicaModel& monica, const OId& oid) {
               return monica.cropGrowth() ? round(monica.cropGrowth()->get_FruitBiomassNContent(), 5) : 0.0;
             });
 
       build({id++, "Fc", "m3 m-3", "field capacity"},
-            [](const MonicaModel& monica, OId oid) {
+            [](const MonicaModel& monica, const OId& oid) {
               return getComplexValues<double>(oid, [&](int i) { return monica.soilColumn().at(i).vs_FieldCapacity(); },
                                               4);
             });
 
       build({id++, "Pwp", "m3 m-3", "permanent wilting point"},
-            [](const MonicaModel& monica, OId oid) {
+            [](const MonicaModel& monica, const OId& oid) {
               return getComplexValues<double>(oid, [&](int i) {
                 return monica.soilColumn().at(i).vs_PermanentWiltingPoint();
               }, 4);
             });
 
       build({id++, "Sat", "m3 m-3", "saturation"},
-            [](const MonicaModel& monica, OId oid) {
+            [](const MonicaModel& monica, const OId& oid) {
               return getComplexValues<double>(oid, [&](int i) { return monica.soilColumn().at(i).vs_Saturation(); }, 4);
             });
 
@@ -1237,7 +1332,7 @@ BOTRes& monica::buildOutputTable() {
               "umol m-2Ground d-1",
               "daily isoprene-emission of all species from Guenther model"
             },
-            [](const MonicaModel& monica, OId oid) {
+            [](const MonicaModel& monica, const OId& oid) {
               return monica.cropGrowth() ? round(monica.cropGrowth()->guentherEmissions().isoprene_emission, 5) : 0.0;
             });
 
@@ -1247,7 +1342,7 @@ BOTRes& monica::buildOutputTable() {
               "umol m-2Ground d-1",
               "daily monoterpene emission of all species from Guenther model"
             },
-            [](const MonicaModel& monica, OId oid) {
+            [](const MonicaModel& monica, const OId& oid) {
               return monica.cropGrowth()
                        ? round(monica.cropGrowth()->guentherEmissions().monoterpene_emission, 5)
                        : 0.0;
@@ -1259,7 +1354,7 @@ BOTRes& monica::buildOutputTable() {
               "umol m-2Ground d-1",
               "daily isoprene-emission of all species from JJV model"
             },
-            [](const MonicaModel& monica, OId oid) {
+            [](const MonicaModel& monica, const OId& oid) {
               return monica.cropGrowth() ? round(monica.cropGrowth()->jjvEmissions().isoprene_emission, 5) : 0.0;
             });
 
@@ -1269,87 +1364,87 @@ BOTRes& monica::buildOutputTable() {
               "umol m-2Ground d-1",
               "daily monoterpene emission of all species from JJV model"
             },
-            [](const MonicaModel& monica, OId oid) {
+            [](const MonicaModel& monica, const OId& oid) {
               return monica.cropGrowth() ? round(monica.cropGrowth()->jjvEmissions().monoterpene_emission, 5) : 0.0;
             });
 
       build({id++, "Nresid", "kg N ha-1", "Nitrogen content in crop residues"},
-            [](const MonicaModel& monica, OId oid) {
+            [](const MonicaModel& monica, const OId& oid) {
               return monica.cropGrowth() ? round(monica.cropGrowth()->get_ResiduesNContent(), 1) : 0.0;
             });
 
       build({id++, "Sand", "kg kg-1", "Soil sand content"},
-            [](const MonicaModel& monica, OId oid) {
+            [](const MonicaModel& monica, const OId& oid) {
               return getComplexValues<double>(oid, [&](int i) {
                 return monica.soilColumn().at(i).vs_SoilSandContent();
               }, 2);
             });
 
       build({id++, "Clay", "kg kg-1", "Soil clay content"},
-            [](const MonicaModel& monica, OId oid) {
+            [](const MonicaModel& monica, const OId& oid) {
               return getComplexValues<double>(oid, [&](int i) {
                 return monica.soilColumn().at(i).vs_SoilClayContent();
               }, 2);
             });
 
       build({id++, "Silt", "kg kg-1", "Soil silt content"},
-            [](const MonicaModel& monica, OId oid) {
+            [](const MonicaModel& monica, const OId& oid) {
               return getComplexValues<double>(oid, [&](int i) {
                 return monica.soilColumn().at(i).vs_SoilSiltContent();
               }, 2);
             });
 
       build({id++, "Stone", "kg kg-1", "Soil stone content"},
-            [](const MonicaModel& monica, OId oid) {
+            [](const MonicaModel& monica, const OId& oid) {
               return getComplexValues<double>(oid, [&](int i) {
                 return monica.soilColumn().at(i).vs_SoilStoneContent();
               }, 2);
             });
 
       build({id++, "pH", "kg kg-1", "Soil pH content"},
-            [](const MonicaModel& monica, OId oid) {
+            [](const MonicaModel& monica, const OId& oid) {
               return getComplexValues<double>(oid, [&](int i) { return monica.soilColumn().at(i).vs_SoilpH(); }, 2);
             });
 
       build({id++, "O3-short-damage", "unitless", "short term ozone induced reduction of Ac"},
-            [](const MonicaModel& monica, OId oid) {
+            [](const MonicaModel& monica, const OId& oid) {
               return monica.cropGrowth() ? round(monica.cropGrowth()->get_O3_shortTermDamage(), 2) : 0.0;
             });
 
       build({id++, "O3-long-damage", "unitless", "long term ozone induced senescence"},
-            [](const MonicaModel& monica, OId oid) {
+            [](const MonicaModel& monica, const OId& oid) {
               return monica.cropGrowth() ? round(monica.cropGrowth()->get_O3_longTermDamage(), 2) : 0.0;
             });
 
       build({id++, "O3-WS-gs-reduction", "unitless", "water stress impact on stomatal conductance"},
-            [](const MonicaModel& monica, OId oid) {
+            [](const MonicaModel& monica, const OId& oid) {
               return monica.cropGrowth() ? round(monica.cropGrowth()->get_O3_WStomatalClosure(), 2) : 0.0;
             });
 
       build({id++, "O3-total-uptake", "�mol m-2", "total O3 uptake"}, //TODO units are not correct
-            [](const MonicaModel& monica, OId oid) {
+            [](const MonicaModel& monica, const OId& oid) {
               return monica.cropGrowth() ? round(monica.cropGrowth()->get_O3_sumUptake(), 2) : 0.0;
             });
 
       build({id++, "NO3conv", "", "get_vq_Convection"},
-            [](const MonicaModel& monica, OId oid) {
+            [](const MonicaModel& monica, const OId& oid) {
               return getComplexValues<double>(oid, [&](int i) { return monica.soilTransport().get_vq_Convection(i); },
                                               8);
             });
 
       build({id++, "NO3disp", "", "get_vq_Dispersion"},
-            [](const MonicaModel& monica, OId oid) {
+            [](const MonicaModel& monica, const OId& oid) {
               return getComplexValues<double>(oid, [&](int i) { return monica.soilTransport().get_vq_Dispersion(i); },
                                               8);
             });
 
       build({id++, "noOfAOMPools", "", "number of AOM pools in existence currently"},
-            [](const MonicaModel& monica, OId oid) {
+            [](const MonicaModel& monica, const OId& oid) {
               return int(monica.soilColumn().at(0).vo_AOM_Pool.size());
             });
 
       build({id++, "CN_Ratio_AOM_Fast", "", "CN_Ratio_AOM_Fast"},
-            [](const MonicaModel& monica, OId oid) {
+            [](const MonicaModel& monica, const OId& oid) {
               return getComplexValues<double>(oid, [&](int i) {
                 const auto& layer = monica.soilColumn().at(i);
                 return layer.vo_AOM_Pool.empty() ? 0.0 : layer.vo_AOM_Pool.at(0).vo_CN_Ratio_AOM_Fast;
@@ -1357,7 +1452,7 @@ BOTRes& monica::buildOutputTable() {
             });
 
       build({id++, "AOM_Fast", "", "AOM_Fast"},
-            [](const MonicaModel& monica, OId oid) {
+            [](const MonicaModel& monica, const OId& oid) {
               return getComplexValues<double>(oid, [&](int i) {
                 const auto& layer = monica.soilColumn().at(i);
                 return layer.vo_AOM_Pool.empty() ? 0.0 : layer.vo_AOM_Pool.at(0).vo_AOM_Fast;
@@ -1365,7 +1460,7 @@ BOTRes& monica::buildOutputTable() {
             });
 
       build({id++, "AOM_Slow", "", "AOM_Slow"},
-            [](const MonicaModel& monica, OId oid) {
+            [](const MonicaModel& monica, const OId& oid) {
               return getComplexValues<double>(oid, [&](int i) {
                 const auto& layer = monica.soilColumn().at(i);
                 return layer.vo_AOM_Pool.empty() ? 0.0 : layer.vo_AOM_Pool.at(0).vo_AOM_Slow;
@@ -1373,11 +1468,11 @@ BOTRes& monica::buildOutputTable() {
             });
 
       build({id++, "rootNConcentration", "", "rootNConcentration"},
-            [](const MonicaModel& monica, OId oid) {
+            [](const MonicaModel& monica, const OId& oid) {
               return monica.cropGrowth() ? round(monica.cropGrowth()->rootNConcentration(), 4) : 0.0;
             });
       build({id++, "actammoxrate", "kgN/m3/d", "actual ammonia oxidation rate in layer"},
-            [](const MonicaModel& monica, OId oid) {
+            [](const MonicaModel& monica, const OId& oid) {
               auto nools = int(monica.soilColumn().vs_NumberOfOrganicLayers());
               oid.fromLayer = min(oid.fromLayer, nools - 1);
               oid.toLayer = min(oid.toLayer, nools - 1);
@@ -1387,7 +1482,7 @@ BOTRes& monica::buildOutputTable() {
             });
 
       build({id++, "actnitrate", "kgN/m3/d", "actual nitrification rate in layer"},
-            [](const MonicaModel& monica, OId oid) {
+            [](const MonicaModel& monica, const OId& oid) {
               auto nools = int(monica.soilColumn().vs_NumberOfOrganicLayers());
               oid.fromLayer = min(oid.fromLayer, nools - 1);
               oid.toLayer = min(oid.toLayer, nools - 1);
@@ -1396,7 +1491,7 @@ BOTRes& monica::buildOutputTable() {
             });
 
       build({id++, "actdenitrate", "kgN/m3/d", "actual denitrification rate in layer"},
-            [](const MonicaModel& monica, OId oid) {
+            [](const MonicaModel& monica, const OId& oid) {
               auto nools = int(monica.soilColumn().vs_NumberOfOrganicLayers());
               oid.fromLayer = min(oid.fromLayer, nools - 1);
               oid.toLayer = min(oid.toLayer, nools - 1);
@@ -1405,22 +1500,62 @@ BOTRes& monica::buildOutputTable() {
               }, 6);
             });
       build({id++, "rootDensity", "", "cropGrowth->vc_RootDensity"},
-            [](const MonicaModel& monica, OId oid) {
+            [](const MonicaModel& monica, const OId& oid) {
               return getComplexValues<double>(oid, [&](int i) {
                 return monica.cropGrowth() ? monica.cropGrowth()->getRootDensity(i) : 0.0;
               }, 4);
             });
       build({id++, "rootingZone", "", "cropGrowth->vc_RootingZone"},
-            [](const MonicaModel& monica, OId oid) {
+            [](const MonicaModel& monica, const OId& oid) {
               return monica.cropGrowth() ? monica.cropGrowth()->rootingZone() : 0.0;
             });
       build({id++, "WaterFlux", "mm/d", "waterflux in layer"},
-            [](const MonicaModel& monica, OId oid) {
+            [](const MonicaModel& monica, const OId& oid) {
               return getComplexValues<double>(oid, [&](int i) {
                 return monica.soilMoisture().waterFlux(i);
               }, 1);
             });
 
+      build({id++, "stepAllocations", "", "heap allocations of the day's step, needs a build with MONICA_COUNT_ALLOCATIONS"},
+            [](const MonicaModel& monica, const OId& oid) {
+              return int(monica.allocationsOfLastStep());
+            });
+
+      build({id++, "perf-ns-crop", "ns", "cumulative time of the crop module's steps, switches the step kernel timers on"},
+            [](const MonicaModel& monica, const OId& oid) {
+              return double(monica.stepKernelTimes().ns[CROP_MODULE_STEP]);
+            });
+
+      build({id++, "perf-ns-hourly-fvcb", "ns", "cumulative time of the hourly FvCB photosynthesis (part of perf-ns-crop), switches the step kernel timers on"},
+            [](const MonicaModel& monica, const OId& oid) {
+              return double(monica.stepKernelTimes().ns[HOURLY_FVCB_PHOTOSYNTHESIS]);
+            });
+
+      build({id++, "perf-ns-soiltemperature", "ns", "cumulative time of the soil temperature's steps, switches the step kernel timers on"},
+            [](const MonicaModel& monica, const OId& oid) {
+              return double(monica.stepKernelTimes().ns[SOIL_TEMPERATURE_STEP]);
+            });
+
+      build({id++, "perf-ns-soilmoisture", "ns", "cumulative time of the soil moisture's steps, switches the step kernel timers on"},
+            [](const MonicaModel& monica, const OId& oid) {
+              return double(monica.stepKernelTimes().ns[SOIL_MOISTURE_STEP]);
+            });
+
+      build({id++, "perf-ns-soilorganic", "ns", "cumulative time of the soil organic's steps, switches the step kernel timers on"},
+            [](const MonicaModel& monica, const OId& oid) {
+              return double(monica.stepKernelTimes().ns[SOIL_ORGANIC_STEP]);
+            });
+
+      build({id++, "perf-ns-soiltransport", "ns", "cumulative time of the soil transport's steps, switches the step kernel timers on"},
+            [](const MonicaModel& monica, const OId& oid) {
+              return double(monica.stepKernelTimes().ns[SOIL_TRANSPORT_STEP]);
+            });
+
+      build({id++, "perf-ns-output", "ns", "cumulative time of storing the results (up to the previous day), switches the step kernel timers on"},
+            [](const MonicaModel& monica, const OId& oid) {
+              return double(monica.stepKernelTimes().ns[STORE_RESULTS]);
+            });
+
       tableBuilt = true;
     }
   }
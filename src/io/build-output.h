@@ -44,11 +44,60 @@ namespace monica
 
   json11::Json applyOIdOP(OId::OP op, const std::vector<json11::Json>& js);
 
+  //! time aggregation of the values of an output id in a single pass, giving the same results as applyOIdOP
+  //! only MEDIAN has to keep the values, all other operations need constant memory per (layer) value
+  class OIdAccumulator
+  {
+  public:
+    OIdAccumulator() {}
+
+    explicit OIdAccumulator(OId::OP op) : _op(op) {}
+
+    void add(const json11::Json& value);
+
+    //! same as add(json11::Json(value)), without boxing the number
+    void add(double value);
+
+    bool empty() const { return _count == 0; }
+
+    //! the aggregated value (a number, an array of numbers for layers or the first/last string)
+    json11::Json result() const;
+
+    //! start a new aggregation, keeps the allocated memory
+    void clear();
+
+  private:
+    struct Acc
+    {
+      void add(OId::OP op, double v);
+      double result(OId::OP op) const;
+
+      size_t n{0};
+      double sum{0}, min{0}, max{0}, first{0}, last{0};
+      std::vector<double> values; //!< just for MEDIAN
+    };
+
+    enum Kind { NUMBER, NUMBERS, STRING };
+
+    OId::OP _op{OId::AVG};
+    Kind _kind{NUMBER};
+    size_t _count{0};
+    std::vector<Acc> _accs; //!< one for a number, one per element for arrays
+    json11::Json _first, _last; //!< for strings
+  };
+
   DLL_API std::vector<OId> parseOutputIds(const Tools::J11Array& oidArray);
 
+  //! the typed output functions, for the outputs returning a plain number or string
+  //! to store, compare or aggregate their values without boxing them into a json11::Json
+  typedef std::function<double(const MonicaModel&, const OId&)> NumberOutputFunction;
+  typedef std::function<std::string(const MonicaModel&, const OId&)> StringOutputFunction;
+
   struct DLL_API BOTRes
   {
-    std::map<int, std::function<json11::Json(const MonicaModel&, OId)>> ofs;
+    std::map<int, std::function<json11::Json(const MonicaModel&, const OId&)>> ofs;
+    std::map<int, NumberOutputFunction> numberOfs; //!< subset of ofs
+    std::map<int, StringOutputFunction> stringOfs; //!< subset of ofs
     std::map<int, std::function<void(MonicaModel&, OId, json11::Json)>> setfs;
     std::map<std::string, OutputMetadata> name2metadata;
   };
@@ -0,0 +1,193 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+* License, v. 2.0. If a copy of the MPL was not distributed with this
+* file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+/*
+Authors:
+Michael Berg <michael.berg@zalf.de>
+
+Maintainers:
+Currently maintained by the authors.
+
+This file is part of the MONICA model.
+Copyright (C) Leibniz Centre for Agricultural Landscape Research (ZALF)
+*/
+
+#include "climate-binary.h"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <vector>
+
+#include "tools/date.h"
+#include "climate-io-helper.h"
+
+using namespace monica;
+using namespace std;
+using namespace Tools;
+
+namespace {
+
+bool isLittleEndianHost() {
+  const uint16_t one = 1;
+  char first;
+  memcpy(&first, &one, 1);
+  return first == 1;
+}
+
+template<typename T>
+T fromLittleEndian(const char* p) {
+  char bytes[sizeof(T)];
+  memcpy(bytes, p, sizeof(T));
+  if (!isLittleEndianHost()) reverse(bytes, bytes + sizeof(T));
+  T value;
+  memcpy(&value, bytes, sizeof(T));
+  return value;
+}
+
+template<typename T>
+void appendLittleEndian(string& out, T value) {
+  char bytes[sizeof(T)];
+  memcpy(bytes, &value, sizeof(T));
+  if (!isLittleEndianHost()) reverse(bytes, bytes + sizeof(T));
+  out.append(bytes, sizeof(T));
+}
+
+//! copy noOfValues values of valueSize bytes starting at p into a vector of doubles
+vector<double> readColumn(const char* p, size_t noOfValues, uint32_t valueSize) {
+  vector<double> values(noOfValues);
+  if (valueSize == sizeof(double) && isLittleEndianHost()) {
+    memcpy(values.data(), p, noOfValues * sizeof(double));
+  } else if (valueSize == sizeof(double)) {
+    for (size_t i = 0; i < noOfValues; i++) values[i] = fromLittleEndian<double>(p + i * sizeof(double));
+  } else {
+    for (size_t i = 0; i < noOfValues; i++) values[i] = fromLittleEndian<float>(p + i * sizeof(float));
+  }
+  return values;
+}
+
+} // namespace
+
+bool monica::isClimateBinary(const char* begin, const char* end) {
+  return size_t(end - begin) >= CLIMATE_BINARY_HEADER_SIZE
+         && memcmp(begin, CLIMATE_BINARY_MAGIC, sizeof(CLIMATE_BINARY_MAGIC)) == 0;
+}
+
+EResult<bool> monica::writeClimateBinaryFile(const string& pathToFile, const ClimateCSVData& data, bool asFloat32) {
+  EResult<bool> res;
+  res.result = false;
+  if (data.columns.size() != data.acdNames.size() || data.columns.empty()) {
+    res.appendError("No climate data to write to '" + pathToFile + "'.");
+    return res;
+  }
+
+  auto noOfRows = data.columns.front().size();
+  string out;
+  out.append(CLIMATE_BINARY_MAGIC, sizeof(CLIMATE_BINARY_MAGIC));
+  appendLittleEndian(out, CLIMATE_BINARY_VERSION);
+  appendLittleEndian(out, uint32_t(asFloat32 ? sizeof(float) : sizeof(double)));
+  appendLittleEndian(out, int32_t(data.startYear));
+  appendLittleEndian(out, int32_t(data.startMonth));
+  appendLittleEndian(out, int32_t(data.startDay));
+  appendLittleEndian(out, uint32_t(noOfRows));
+  appendLittleEndian(out, uint32_t(data.columns.size()));
+  appendLittleEndian(out, uint32_t(0));
+  for (const auto& name : data.acdNames) {
+    char n[CLIMATE_BINARY_NAME_SIZE] = {};
+    memcpy(n, name.data(), min(name.size(), CLIMATE_BINARY_NAME_SIZE - 1));
+    out.append(n, CLIMATE_BINARY_NAME_SIZE);
+  }
+  for (const auto& column : data.columns) {
+    if (column.size() != noOfRows) {
+      res.appendError("The climate data to write to '" + pathToFile + "' have columns of different length.");
+      return res;
+    }
+    for (auto v : column) {
+      if (asFloat32) appendLittleEndian(out, float(v));
+      else appendLittleEndian(out, v);
+    }
+  }
+
+  ofstream ofs(pathToFile, ios::binary | ios::trunc);
+  if (!ofs.write(out.data(), streamsize(out.size()))) {
+    res.appendError("Couldn't write binary climate file '" + pathToFile + "'.");
+    return res;
+  }
+  res.result = true;
+  return res;
+}
+
+EResult<Climate::DataAccessor> monica::readClimateDataFromBinary(const char* begin, const char* end,
+                                                                 const string& startDate, const string& endDate) {
+  EResult<Climate::DataAccessor> res;
+  if (!isClimateBinary(begin, end)) {
+    res.appendError("Not a binary climate file.");
+    return res;
+  }
+  auto version = fromLittleEndian<uint32_t>(begin + 8);
+  auto valueSize = fromLittleEndian<uint32_t>(begin + 12);
+  int sy = fromLittleEndian<int32_t>(begin + 16);
+  int sm = fromLittleEndian<int32_t>(begin + 20);
+  int sd = fromLittleEndian<int32_t>(begin + 24);
+  size_t noOfRows = fromLittleEndian<uint32_t>(begin + 28);
+  size_t noOfColumns = fromLittleEndian<uint32_t>(begin + 32);
+  auto dataOffset = CLIMATE_BINARY_HEADER_SIZE + noOfColumns * CLIMATE_BINARY_NAME_SIZE;
+  if (version != CLIMATE_BINARY_VERSION
+      || (valueSize != sizeof(double) && valueSize != sizeof(float))
+      || !validDate(sy, sm, sd)
+      || noOfRows == 0
+      || size_t(end - begin) < dataOffset + noOfColumns * noOfRows * valueSize) {
+    res.appendError("Unsupported version or corrupt binary climate file.");
+    return res;
+  }
+
+  // the requested days as rows of the file
+  int fileStartDayNo = daysFromCivil(sy, sm, sd);
+  int startDayNo = fileStartDayNo, endDayNo = fileStartDayNo + int(noOfRows) - 1;
+  int y, m, d;
+  if (!startDate.empty()) {
+    if (!parseIsoDate(startDate, y, m, d)) {
+      res.appendError("Couldn't parse start-date '" + startDate + "'.");
+      return res;
+    }
+    startDayNo = daysFromCivil(y, m, d);
+  }
+  if (!endDate.empty()) {
+    if (!parseIsoDate(endDate, y, m, d)) {
+      res.appendError("Couldn't parse end-date '" + endDate + "'.");
+      return res;
+    }
+    endDayNo = daysFromCivil(y, m, d);
+  }
+  if (startDayNo < fileStartDayNo || endDayNo >= fileStartDayNo + int(noOfRows) || startDayNo > endDayNo) {
+    res.appendError("The requested time range isn't covered by the binary climate file.");
+    return res;
+  }
+  auto firstRow = size_t(startDayNo - fileStartDayNo);
+  auto noOfDays = size_t(endDayNo - startDayNo + 1);
+
+  civilFromDays(startDayNo, y, m, d);
+  Date start(d, m, y);
+  civilFromDays(endDayNo, y, m, d);
+  res.result = Climate::DataAccessor(start, Date(d, m, y));
+  for (size_t i = 0; i < noOfColumns; i++) {
+    auto namePtr = begin + CLIMATE_BINARY_HEADER_SIZE + i * CLIMATE_BINARY_NAME_SIZE;
+    auto acd = acdFromName(string(namePtr, strnlen(namePtr, CLIMATE_BINARY_NAME_SIZE)));
+    if (acd == Climate::skip) continue;
+    auto column = begin + dataOffset + (i * noOfRows + firstRow) * valueSize;
+    res.result.addClimateData(acd, readColumn(column, noOfDays, valueSize));
+  }
+  return res;
+}
+
+EResult<Climate::DataAccessor> monica::readClimateDataFromBinaryFile(const string& pathToFile,
+                                                                     const string& startDate, const string& endDate) {
+  MappedFile file(pathToFile, false);
+  if (!file.isOpen()) {
+    EResult<Climate::DataAccessor> res;
+    res.appendError("Couldn't open binary climate file '" + pathToFile + "'.");
+    return res;
+  }
+  return readClimateDataFromBinary(file.begin(), file.end(), startDate, endDate);
+}
@@ -0,0 +1,68 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+* License, v. 2.0. If a copy of the MPL was not distributed with this
+* file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+/*
+Authors:
+Michael Berg <michael.berg@zalf.de>
+
+Maintainers:
+Currently maintained by the authors.
+
+This file is part of the MONICA model.
+Copyright (C) Leibniz Centre for Agricultural Landscape Research (ZALF)
+*/
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+#include "climate/climate-common.h"
+#include "tools/helper.h"
+#include "climate-csv-reader.h"
+
+namespace monica {
+
+/*
+ * Binary columnar climate files, written by monica-climate-csv-to-binary from climate csv files.
+ *
+ * Layout, all numbers little endian:
+ *   0  char[8]   "MONICACB"
+ *   8  uint32    version (1)
+ *  12  uint32    size of a value, 8 (float64) or 4 (float32)
+ *  16  int32[3]  start date as year, month, day
+ *  28  uint32    number of rows (days)
+ *  32  uint32    number of columns
+ *  36  uint32    reserved (0)
+ *  40  char[16]  name of each column (e.g. "tmin"), zero padded
+ *  then the columns, each a contiguous array of one value per day
+ *
+ * Because every row is one day, the values of a date range are found without reading
+ * anything else, so a subrange of a long series is loaded by mapping the file and
+ * copying just the requested days.
+ */
+
+const char CLIMATE_BINARY_MAGIC[8] = {'M', 'O', 'N', 'I', 'C', 'A', 'C', 'B'};
+const uint32_t CLIMATE_BINARY_VERSION = 1;
+const size_t CLIMATE_BINARY_HEADER_SIZE = 40;
+const size_t CLIMATE_BINARY_NAME_SIZE = 16;
+
+//! @return true if [begin, end) starts like a binary climate file
+bool isClimateBinary(const char* begin, const char* end);
+
+//! write the columns read from a climate csv file as binary climate file
+Tools::EResult<bool> writeClimateBinaryFile(const std::string& pathToFile, const ClimateCSVData& data, bool asFloat32);
+
+//! create the climate data for the days from startDate to endDate (iso dates, empty means start/end of the file)
+//! from the binary climate file in [begin, end)
+Tools::EResult<Climate::DataAccessor> readClimateDataFromBinary(const char* begin, const char* end,
+                                                                const std::string& startDate = std::string(),
+                                                                const std::string& endDate = std::string());
+
+//! memory map the binary climate file and read the days from startDate to endDate
+Tools::EResult<Climate::DataAccessor> readClimateDataFromBinaryFile(const std::string& pathToFile,
+                                                                    const std::string& startDate = std::string(),
+                                                                    const std::string& endDate = std::string());
+
+} // namespace monica
@@ -0,0 +1,341 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+* License, v. 2.0. If a copy of the MPL was not distributed with this
+* file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+/*
+Authors:
+Michael Berg <michael.berg@zalf.de>
+
+Maintainers:
+Currently maintained by the authors.
+
+This file is part of the MONICA model.
+Copyright (C) Leibniz Centre for Agricultural Landscape Research (ZALF)
+*/
+
+#include "climate-csv-reader.h"
+
+#include <algorithm>
+#include <charconv>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define MONICA_CSV_SSE2
+#include <emmintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#endif
+
+#include "climate/climate-file-io.h"
+#include "tools/date.h"
+#include "climate-io-helper.h"
+#include "climate-binary.h"
+
+using namespace monica;
+using namespace std;
+using namespace Tools;
+
+namespace {
+
+inline int countTrailingZeros(uint32_t mask) {
+#ifdef _MSC_VER
+  unsigned long i;
+  _BitScanForward(&i, mask);
+  return int(i);
+#else
+  return __builtin_ctz(mask);
+#endif
+}
+
+//! delivers the positions of all separators and newlines in order, 16 bytes are classified at once
+class DelimiterScanner {
+public:
+  DelimiterScanner(const char* begin, const char* end, char separator)
+    : _block(begin), _end(end), _sep(separator) {
+    _mask = blockMask();
+  }
+
+  //! @return the next separator or newline, end if there is none
+  const char* next() {
+    while (_mask == 0) {
+      _block += 16;
+      if (_block >= _end) return _end;
+      _mask = blockMask();
+    }
+    auto pos = _block + countTrailingZeros(_mask);
+    _mask &= _mask - 1;
+    return pos;
+  }
+
+  //! continue scanning after pos
+  void restartAfter(const char* pos) {
+    _block = pos + 1;
+    _mask = _block < _end ? blockMask() : 0;
+  }
+
+private:
+  uint32_t blockMask() const {
+#ifdef MONICA_CSV_SSE2
+    if (_end - _block >= 16) {
+      auto chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(_block));
+      auto isDelimiter = _mm_or_si128(_mm_cmpeq_epi8(chunk, _mm_set1_epi8(_sep)),
+                                      _mm_cmpeq_epi8(chunk, _mm_set1_epi8('\n')));
+      return uint32_t(_mm_movemask_epi8(isDelimiter));
+    }
+#endif
+    uint32_t mask = 0;
+    for (int i = 0, size = int(min<ptrdiff_t>(16, _end - _block)); i < size; i++) {
+      if (_block[i] == _sep || _block[i] == '\n') mask |= uint32_t(1) << i;
+    }
+    return mask;
+  }
+
+  const char* _block;
+  const char* _end;
+  char _sep;
+  uint32_t _mask{0};
+};
+
+void trim(const char*& b, const char*& e) {
+  while (b < e && (*b == ' ' || *b == '\t')) ++b;
+  while (e > b && (e[-1] == ' ' || e[-1] == '\t' || e[-1] == '\r')) --e;
+}
+
+bool parseDouble(const char* b, const char* e, double& value) {
+  trim(b, e);
+  if (b < e && *b == '+') ++b;
+  if (b == e) return false;
+#if defined(__cpp_lib_to_chars) && __cpp_lib_to_chars >= 201611L
+  auto res = from_chars(b, e, value);
+  return res.ec == errc() && res.ptr == e;
+#else
+  char buf[64];
+  auto size = size_t(e - b);
+  if (size >= sizeof(buf)) return false;
+  memcpy(buf, b, size);
+  buf[size] = '\0';
+  char* parseEnd = nullptr;
+  value = strtod(buf, &parseEnd);
+  return parseEnd == buf + size;
+#endif
+}
+
+enum ColumnKind { SKIP_COLUMN, ISO_DATE_COLUMN, DE_DATE_COLUMN, DATA_COLUMN };
+
+struct Column {
+  ColumnKind kind{SKIP_COLUMN};
+  size_t dataIndex{0};
+  char convertOp{0};
+  double convertValue{0};
+};
+
+//! @return false if the fast reader can't read the csv data, otherwise the accessor
+bool createDataAccessor(const char* begin, const char* end, const json11::Json& options, Climate::DataAccessor& da) {
+  ClimateCSVOptions csvOptions;
+  if (!toClimateCSVOptions(options, csvOptions)) return false;
+  ClimateCSVData data;
+  if (!parseClimateCSV(begin, end, csvOptions, data)) return false;
+
+  da = Climate::DataAccessor(Date(data.startDay, data.startMonth, data.startYear),
+                             Date(data.endDay, data.endMonth, data.endYear));
+  for (size_t i = 0; i < data.acdNames.size(); i++) {
+    da.addClimateData(acdFromName(data.acdNames[i]), move(data.columns[i]));
+  }
+  return true;
+}
+
+} // namespace
+
+bool monica::toClimateCSVOptions(const json11::Json& options, ClimateCSVOptions& csvOptions) {
+  // without explicit separator and number of header lines rather use the default reader
+  const auto& sep = options["csv-separator"];
+  if (!sep.is_string() || sep.string_value().size() != 1) return false;
+  csvOptions.separator = sep.string_value().front();
+  if (csvOptions.separator == '\n' || csvOptions.separator == '\r') return false;
+
+  const auto& nohl = options["no-of-climate-file-header-lines"];
+  if (!nohl.is_number() || nohl.int_value() < 1) return false;
+  csvOptions.noOfHeaderLines = size_t(nohl.int_value());
+
+  for (auto& p : {make_pair("start-date", &csvOptions.startDate), make_pair("end-date", &csvOptions.endDate)}) {
+    const auto& d = options[p.first];
+    if (d.is_null()) continue;
+    if (!d.is_string()) return false;
+    *p.second = d.string_value();
+    int y, m, day;
+    if (!p.second->empty() && !parseIsoDate(*p.second, y, m, day)) return false;
+  }
+
+  const auto& h2a = options["header-to-acd-names"];
+  if (h2a.is_null()) return true;
+  if (!h2a.is_object()) return false;
+  for (const auto& p : h2a.object_items()) {
+    if (p.second.is_string()) csvOptions.headerName2acdName[p.first] = p.second.string_value();
+    else if (p.second.is_array()) {
+      const auto& a = p.second.array_items();
+      if (a.size() != 3 || !a[0].is_string() || !a[1].is_string() || !a[2].is_number()) return false;
+      auto op = a[1].string_value();
+      if (op != "*" && op != "/" && op != "+" && op != "-") return false;
+      csvOptions.headerName2acdName[p.first] = a[0].string_value();
+      csvOptions.headerName2conversion[p.first] = make_pair(op.front(), a[2].number_value());
+    } else return false;
+  }
+  return true;
+}
+
+bool monica::parseClimateCSV(const char* begin, const char* end, const ClimateCSVOptions& options, ClimateCSVData& data) {
+  data = ClimateCSVData();
+  DelimiterScanner scanner(begin, end, options.separator);
+
+  // the first header line names the columns
+  vector<Column> columns;
+  bool hasDateColumn = false;
+  const char* p = begin;
+  while (true) {
+    auto delim = scanner.next();
+    auto b = p, e = delim;
+    trim(b, e);
+    Column c;
+    string headerName(b, e);
+    auto it = options.headerName2acdName.find(headerName);
+    auto acdName = it == options.headerName2acdName.end() ? headerName : it->second;
+    if (acdName == "iso-date" || acdName == "de-date") {
+      if (hasDateColumn) return false;
+      c.kind = acdName == "iso-date" ? ISO_DATE_COLUMN : DE_DATE_COLUMN;
+      hasDateColumn = true;
+    } else if (acdFromName(acdName) != Climate::skip) {
+      for (const auto& n : data.acdNames) if (n == acdName) return false;
+      c.kind = DATA_COLUMN;
+      c.dataIndex = data.acdNames.size();
+      data.acdNames.push_back(acdName);
+      auto ci = options.headerName2conversion.find(headerName);
+      if (ci != options.headerName2conversion.end()) {
+        c.convertOp = ci->second.first;
+        c.convertValue = ci->second.second;
+      }
+    } else if (isStockOnlyClimateColumn(acdName)) {
+      // leave it to the stock reader instead of dropping the column
+      return false;
+    }
+    columns.push_back(c);
+    p = delim + 1;
+    if (delim == end) return false;
+    if (*delim == '\n') break;
+  }
+  if (!hasDateColumn || data.acdNames.empty()) return false;
+
+  // skip the other header lines (e.g. units)
+  for (size_t i = 1; i < options.noOfHeaderLines; i++) {
+    auto nl = static_cast<const char*>(memchr(p, '\n', size_t(end - p)));
+    if (!nl) return false;
+    p = nl + 1;
+  }
+  scanner.restartAfter(p - 1);
+
+  int startDayNo = 0, endDayNo = 0, y, m, d;
+  if (!options.startDate.empty()) {
+    parseIsoDate(options.startDate, y, m, d);
+    startDayNo = daysFromCivil(y, m, d);
+  }
+  if (!options.endDate.empty()) {
+    parseIsoDate(options.endDate, y, m, d);
+    endDayNo = daysFromCivil(y, m, d);
+  }
+
+  // a guess of the number of rows, to avoid reallocations
+  data.columns.resize(data.acdNames.size());
+  for (auto& c : data.columns) c.reserve(size_t(end - p) / max<size_t>(1, columns.size() * 4) + 1);
+
+  vector<double> rowValues(data.acdNames.size());
+  int prevDayNo = 0;
+  bool hasRows = false;
+  while (p < end) {
+    size_t col = 0;
+    size_t noOfDataValues = 0;
+    bool hasDate = false;
+    int dayNo = 0;
+    bool isEmptyLine = true;
+    const char* delim;
+    do {
+      delim = scanner.next();
+      auto b = p, e = delim;
+      if (col == 0 && (delim == end || *delim == '\n')) {
+        trim(b, e);
+        if (b == e) break;
+      }
+      isEmptyLine = false;
+      if (col < columns.size()) {
+        const auto& c = columns[col];
+        switch (c.kind) {
+          case ISO_DATE_COLUMN:
+          case DE_DATE_COLUMN:
+            if (!(c.kind == ISO_DATE_COLUMN ? parseIsoDate(b, e, y, m, d) : parseDeDate(b, e, y, m, d))) return false;
+            dayNo = daysFromCivil(y, m, d);
+            hasDate = true;
+            break;
+          case DATA_COLUMN: {
+            double v;
+            if (!parseDouble(b, e, v)) return false;
+            switch (c.convertOp) {
+              case '*': v *= c.convertValue; break;
+              case '/': v /= c.convertValue; break;
+              case '+': v += c.convertValue; break;
+              case '-': v -= c.convertValue; break;
+              default:;
+            }
+            rowValues[c.dataIndex] = v;
+            noOfDataValues++;
+            break;
+          }
+          default:;
+        }
+      }
+      col++;
+      p = delim + 1;
+    } while (delim != end && *delim != '\n');
+    if (isEmptyLine) {
+      p = delim + 1;
+      continue;
+    }
+
+    if (!hasDate || noOfDataValues != rowValues.size()) return false;
+    if (!options.startDate.empty() && dayNo < startDayNo) continue;
+    if (!options.endDate.empty() && dayNo > endDayNo) break;
+    // the days have to follow each other without gaps
+    if (hasRows && dayNo != prevDayNo + 1) return false;
+    if (!hasRows) {
+      data.startYear = y, data.startMonth = m, data.startDay = d;
+      if (!options.startDate.empty() && dayNo != startDayNo) return false;
+    }
+    data.endYear = y, data.endMonth = m, data.endDay = d;
+    for (size_t i = 0; i < rowValues.size(); i++) data.columns[i].push_back(rowValues[i]);
+    prevDayNo = dayNo;
+    hasRows = true;
+  }
+
+  return hasRows && (options.endDate.empty() || prevDayNo == endDayNo);
+}
+
+EResult<Climate::DataAccessor> monica::readClimateDataFromCSVFilesViaHeadersFast(const vector<string>& pathsToFiles,
+                                                                               const json11::Json& options) {
+  if (pathsToFiles.size() == 1 && pathsToFiles.front().find("capnp://") != 0) {
+    MappedFile file(pathsToFiles.front());
+    if (file.isOpen() && isClimateBinary(file.begin(), file.end())) {
+      return readClimateDataFromBinary(file.begin(), file.end(),
+                                       options["start-date"].string_value(), options["end-date"].string_value());
+    }
+    EResult<Climate::DataAccessor> res;
+    if (file.isOpen() && createDataAccessor(file.begin(), file.end(), options, res.result)) return res;
+  }
+  return Climate::readClimateDataFromCSVFilesViaHeaders(pathsToFiles, options);
+}
+
+EResult<Climate::DataAccessor> monica::readClimateDataFromCSVStringViaHeadersFast(const string& csvString,
+                                                                                const json11::Json& options) {
+  EResult<Climate::DataAccessor> res;
+  if (createDataAccessor(csvString.data(), csvString.data() + csvString.size(), options, res.result)) return res;
+  return Climate::readClimateDataFromCSVStringViaHeaders(csvString, options);
+}
@@ -0,0 +1,78 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+* License, v. 2.0. If a copy of the MPL was not distributed with this
+* file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+/*
+Authors:
+Michael Berg <michael.berg@zalf.de>
+
+Maintainers:
+Currently maintained by the authors.
+
+This file is part of the MONICA model.
+Copyright (C) Leibniz Centre for Agricultural Landscape Research (ZALF)
+*/
+
+#pragma once
+
+#include <cstddef>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "json11/json11.hpp"
+
+#include "climate/climate-common.h"
+#include "tools/helper.h"
+
+namespace monica {
+
+/*
+ * Fast reader for climate csv files.
+ *
+ * The file is memory mapped, separators and newlines are located 16 bytes at a time (SSE2)
+ * and the values are parsed with std::from_chars directly into the columns of the DataAccessor.
+ *
+ * It reads the common case: a header line naming the columns (further header lines are skipped),
+ * an iso-date or de-date column and one row per day without gaps. The csv options
+ * "csv-separator", "no-of-climate-file-header-lines", "start-date", "end-date" and
+ * "header-to-acd-names" (renames and conversions like ["globrad", "/", 100]) are honoured.
+ * Everything else (e.g. several files, gaps, unparsable values, missing options) is left
+ * to Climate::readClimateDataFromCSVFilesViaHeaders/readClimateDataFromCSVStringViaHeaders.
+ * A single binary climate file (see climate-binary.h) is read directly instead.
+ */
+
+//! the csv options the fast reader understands
+struct ClimateCSVOptions {
+  char separator{','};
+  size_t noOfHeaderLines{1};
+  std::string startDate, endDate; //!< iso dates, empty if not set
+  std::map<std::string, std::string> headerName2acdName;
+  std::map<std::string, std::pair<char, double>> headerName2conversion; //!< e.g. '/' 100
+};
+
+//! the columns read, named like the climate elements (e.g. "tmin")
+struct ClimateCSVData {
+  int startYear{0}, startMonth{0}, startDay{0};
+  int endYear{0}, endMonth{0}, endDay{0};
+  std::vector<std::string> acdNames;
+  std::vector<std::vector<double>> columns; //!< one value per day for each of acdNames
+};
+
+//! parse the csv data in [begin, end) and keep the columns of the known climate elements
+//! @return false if the data can't be read by the fast reader, also if it has a column only the stock reader knows
+bool parseClimateCSV(const char* begin, const char* end, const ClimateCSVOptions& options, ClimateCSVData& data);
+
+//! @return false if the options contain anything the fast reader doesn't understand
+bool toClimateCSVOptions(const json11::Json& options, ClimateCSVOptions& csvOptions);
+
+//! drop in replacement for Climate::readClimateDataFromCSVFilesViaHeaders, which is used for anything the fast reader can't read
+Tools::EResult<Climate::DataAccessor> readClimateDataFromCSVFilesViaHeadersFast(const std::vector<std::string>& pathsToFiles,
+                                                                             const json11::Json& options);
+
+//! drop in replacement for Climate::readClimateDataFromCSVStringViaHeaders
+Tools::EResult<Climate::DataAccessor> readClimateDataFromCSVStringViaHeadersFast(const std::string& csvString,
+                                                                              const json11::Json& options);
+
+} // namespace monica
@@ -0,0 +1,158 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+* License, v. 2.0. If a copy of the MPL was not distributed with this
+* file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+/*
+Authors:
+Michael Berg <michael.berg@zalf.de>
+
+Maintainers:
+Currently maintained by the authors.
+
+This file is part of the MONICA model.
+Copyright (C) Leibniz Centre for Agricultural Landscape Research (ZALF)
+*/
+
+#include "climate-io-helper.h"
+
+#include <charconv>
+#include <utility>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+using namespace monica;
+using namespace std;
+
+MappedFile::MappedFile(const string& path, bool sequentialAccess) {
+#ifdef _WIN32
+  auto file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                          sequentialAccess ? FILE_FLAG_SEQUENTIAL_SCAN : FILE_FLAG_RANDOM_ACCESS, nullptr);
+  if (file == INVALID_HANDLE_VALUE) return;
+  _file = file;
+  LARGE_INTEGER size;
+  if (!GetFileSizeEx(_file, &size) || size.QuadPart == 0) return;
+  _mapping = CreateFileMappingA(_file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+  if (!_mapping) return;
+  auto view = MapViewOfFile(_mapping, FILE_MAP_READ, 0, 0, 0);
+  if (!view) return;
+  _data = static_cast<const char*>(view);
+  _size = size_t(size.QuadPart);
+#else
+  _fd = open(path.c_str(), O_RDONLY);
+  if (_fd < 0) return;
+  struct stat st;
+  if (fstat(_fd, &st) != 0 || st.st_size == 0) return;
+  auto view = mmap(nullptr, size_t(st.st_size), PROT_READ, MAP_PRIVATE, _fd, 0);
+  if (view == MAP_FAILED) return;
+  madvise(view, size_t(st.st_size), sequentialAccess ? MADV_SEQUENTIAL : MADV_RANDOM);
+  _data = static_cast<const char*>(view);
+  _size = size_t(st.st_size);
+#endif
+}
+
+MappedFile::~MappedFile() {
+#ifdef _WIN32
+  if (_data) UnmapViewOfFile(_data);
+  if (_mapping) CloseHandle(_mapping);
+  if (_file) CloseHandle(_file);
+#else
+  if (_data) munmap(const_cast<char*>(_data), _size);
+  if (_fd >= 0) close(_fd);
+#endif
+}
+
+namespace {
+
+const pair<const char*, Climate::ACD> acdNames[] = {
+  {"tmin", Climate::tmin}, {"tavg", Climate::tavg}, {"tmax", Climate::tmax}, {"precip", Climate::precip},
+  {"globrad", Climate::globrad}, {"wind", Climate::wind}, {"sunhours", Climate::sunhours},
+  {"relhumid", Climate::relhumid}, {"co2", Climate::co2}, {"o3", Climate::o3}, {"et0", Climate::et0}
+};
+
+//! the other climate elements of Climate::ACD, which the stock readers take from the headers
+const char* stockOnlyColumnNames[] = {
+  "day", "month", "year", "precipOrig", "cloudamount", "airpress", "vaporpress", "dewpoint_temp"
+};
+
+} // namespace
+
+Climate::ACD monica::acdFromName(const string& name) {
+  for (const auto& p : acdNames) if (name == p.first) return p.second;
+  return Climate::skip;
+}
+
+string monica::acdName(Climate::ACD acd) {
+  for (const auto& p : acdNames) if (acd == p.second) return p.first;
+  return string();
+}
+
+bool monica::isStockOnlyClimateColumn(const string& name) {
+  for (auto n : stockOnlyColumnNames) if (name == n) return true;
+  return false;
+}
+
+int monica::daysFromCivil(int y, int m, int d) {
+  y -= m <= 2;
+  const int era = (y >= 0 ? y : y - 399) / 400;
+  const int yoe = y - era * 400;
+  const int doy = (153 * (m + (m > 2 ? -3 : 9)) + 2) / 5 + d - 1;
+  const int doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+  return era * 146097 + doe - 719468;
+}
+
+void monica::civilFromDays(int dayNo, int& y, int& m, int& d) {
+  dayNo += 719468;
+  const int era = (dayNo >= 0 ? dayNo : dayNo - 146096) / 146097;
+  const int doe = dayNo - era * 146097;
+  const int yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+  const int doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+  const int mp = (5 * doy + 2) / 153;
+  d = doy - (153 * mp + 2) / 5 + 1;
+  m = mp < 10 ? mp + 3 : mp - 9;
+  y = yoe + era * 400 + (m <= 2);
+}
+
+bool monica::validDate(int y, int m, int d) {
+  static const int daysInMonth[] = {31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
+  if (m < 1 || m > 12 || d < 1) return false;
+  bool leap = (y % 4 == 0 && y % 100 != 0) || y % 400 == 0;
+  return d <= daysInMonth[m - 1] + (m == 2 && leap ? 1 : 0);
+}
+
+namespace {
+
+void trimBlanks(const char*& b, const char*& e) {
+  while (b < e && (*b == ' ' || *b == '\t')) ++b;
+  while (e > b && (e[-1] == ' ' || e[-1] == '\t' || e[-1] == '\r')) --e;
+}
+
+bool parseInt(const char* b, const char* e, int& value) {
+  auto res = from_chars(b, e, value);
+  return res.ec == errc() && res.ptr == e;
+}
+
+} // namespace
+
+bool monica::parseIsoDate(const char* b, const char* e, int& y, int& m, int& d) {
+  trimBlanks(b, e);
+  return e - b == 10 && b[4] == '-' && b[7] == '-'
+         && parseInt(b, b + 4, y) && parseInt(b + 5, b + 7, m) && parseInt(b + 8, b + 10, d)
+         && validDate(y, m, d);
+}
+
+bool monica::parseDeDate(const char* b, const char* e, int& y, int& m, int& d) {
+  trimBlanks(b, e);
+  return e - b == 10 && b[2] == '.' && b[5] == '.'
+         && parseInt(b, b + 2, d) && parseInt(b + 3, b + 5, m) && parseInt(b + 6, b + 10, y)
+         && validDate(y, m, d);
+}
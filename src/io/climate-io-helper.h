@@ -0,0 +1,79 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+* License, v. 2.0. If a copy of the MPL was not distributed with this
+* file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+/*
+Authors:
+Michael Berg <michael.berg@zalf.de>
+
+Maintainers:
+Currently maintained by the authors.
+
+This file is part of the MONICA model.
+Copyright (C) Leibniz Centre for Agricultural Landscape Research (ZALF)
+*/
+
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+#include "climate/climate-common.h"
+
+namespace monica {
+
+//! read only memory mapping of a whole file
+class MappedFile {
+public:
+  explicit MappedFile(const std::string& path, bool sequentialAccess = true);
+  ~MappedFile();
+
+  MappedFile(const MappedFile&) = delete;
+  MappedFile& operator=(const MappedFile&) = delete;
+
+  const char* begin() const { return _data; }
+  const char* end() const { return _data + _size; }
+  size_t size() const { return _size; }
+  bool isOpen() const { return _data != nullptr; }
+
+private:
+#ifdef _WIN32
+  void* _file{nullptr}; //!< HANDLE
+  void* _mapping{nullptr}; //!< HANDLE
+#else
+  int _fd{-1};
+#endif
+  const char* _data{nullptr};
+  size_t _size{0};
+};
+
+//! @return the climate element named like the csv column headers (e.g. "tmin"), Climate::skip if unknown
+Climate::ACD acdFromName(const std::string& name);
+
+//! the inverse of acdFromName
+std::string acdName(Climate::ACD acd);
+
+//! @return true if name is a column the stock csv readers (Climate::readClimateDataFromCSV*ViaHeaders) read,
+//! but acdFromName doesn't know (e.g. separate day, month and year columns or cloud amount),
+//! so reading without it would silently drop data
+bool isStockOnlyClimateColumn(const std::string& name);
+
+//! days since 1970-01-01 of the proleptic gregorian calendar
+int daysFromCivil(int y, int m, int d);
+
+//! the inverse of daysFromCivil
+void civilFromDays(int dayNo, int& y, int& m, int& d);
+
+bool validDate(int y, int m, int d);
+
+//! yyyy-mm-dd, surrounding blanks are ignored
+bool parseIsoDate(const char* b, const char* e, int& y, int& m, int& d);
+
+inline bool parseIsoDate(const std::string& s, int& y, int& m, int& d) {
+  return parseIsoDate(s.data(), s.data() + s.size(), y, m, d);
+}
+
+//! dd.mm.yyyy, surrounding blanks are ignored
+bool parseDeDate(const char* b, const char* e, int& y, int& m, int& d);
+
+} // namespace monica
@@ -89,9 +89,52 @@ void monica::writeOutputHeaderRows(ostream& out,
     << oss4.str() << endl;
 }
 
+namespace
+{
+  void writeJsonValue(ostream& out, const Json& j, const string& csvSep, const char* csvSep_, const string& escapeTokens)
+  {
+    switch(j.type())
+    {
+    case Json::NUMBER: out << j.number_value() << csvSep_; break;
+    case Json::STRING: 
+      out 
+      << (j.string_value().find_first_of(escapeTokens) == string::npos 
+                               ? j.string_value() 
+                               : "\""_s + j.string_value() + "\""_s) 
+      << csvSep_; break;
+    case Json::BOOL: out << j.bool_value() << csvSep_; break;
+    case Json::ARRAY:
+    {
+      size_t jvi = 0;
+      auto jSize = j.array_items().size();
+      for(Json jv : j.array_items())
+      {
+        auto csvSep__ = jvi + 1 == jSize ? "" : csvSep;
+        switch(jv.type())
+        {
+        case Json::NUMBER: out << jv.number_value() << csvSep__; break;
+        case Json::STRING: 
+          out 
+            << (jv.string_value().find_first_of(escapeTokens) == string::npos
+                ? jv.string_value()
+                : "\""_s + jv.string_value() + "\""_s)
+            << csvSep__; break;
+        case Json::BOOL: out << jv.bool_value() << csvSep__; break;
+        default: out << "UNKNOWN" << csvSep__;
+        }
+        ++jvi;
+      }
+      out << csvSep_; 
+      break;
+    }
+    default: out << "UNKNOWN" << csvSep_;
+    }
+  }
+}
+
 void monica::writeOutput(ostream& out,
                          const vector<OId>& outputIds,
-                         const vector<J11Array>& values,
+                         const vector<ResultColumn>& values,
                          string csvSep)
 {
   //using namespace std::string_literals;
@@ -101,50 +144,31 @@ void monica::writeOutput(ostream& out,
   {
     for(size_t k = 0, size = values.begin()->size(); k < size; k++)
     {
-      size_t i = 0;
       auto oidsSize = outputIds.size();
-      for(auto oid : outputIds)
+      for(size_t i = 0; i < oidsSize; i++)
       {
-        auto csvSep_ = i + 1 ==  oidsSize ? "" : csvSep;
-        Json j = values.at(i).at(k);
-        switch(j.type())
+        auto csvSep_ = i + 1 ==  oidsSize ? "" : csvSep.c_str();
+        const auto& col = values.at(i);
+        switch(col.type())
         {
-        case Json::NUMBER: out << j.number_value() << csvSep_; break;
-        case Json::STRING: 
-          out 
-          << (j.string_value().find_first_of(escapeTokens) == string::npos 
-                                   ? j.string_value() 
-                                   : "\""_s + j.string_value() + "\""_s) 
-          << csvSep_; break;
-        case Json::BOOL: out << j.bool_value() << csvSep_; break;
-        case Json::ARRAY:
-        {
-          size_t jvi = 0;
-          auto jSize = j.array_items().size();
-          for(Json jv : j.array_items())
+        case ResultColumn::NUMBERS:
+          if(col.hasArrayRows())
           {
-            auto csvSep__ = jvi + 1 == jSize ? "" : csvSep;
-            switch(jv.type())
-            {
-            case Json::NUMBER: out << jv.number_value() << csvSep__; break;
-            case Json::STRING: 
-              out 
-                << (jv.string_value().find_first_of(escapeTokens) == string::npos
-                    ? jv.string_value()
-                    : "\""_s + jv.string_value() + "\""_s)
-                << csvSep__; break;
-            case Json::BOOL: out << jv.bool_value() << csvSep__; break;
-            default: out << "UNKNOWN" << csvSep__;
-            }
-            ++jvi;
+            for(size_t jvi = 0, jSize = col.width(); jvi < jSize; jvi++)
+              out << col.numberAt(k, jvi) << (jvi + 1 == jSize ? "" : csvSep);
+            out << csvSep_;
           }
-          out << csvSep_; 
+          else
+            out << col.numberAt(k) << csvSep_;
+          break;
+        case ResultColumn::STRINGS:
+        {
+          const auto& s = col.stringAt(k);
+          out << (s.find_first_of(escapeTokens) == string::npos ? s : "\""_s + s + "\""_s) << csvSep_;
           break;
         }
-        default: out << "UNKNOWN" << csvSep_;
+        default: writeJsonValue(out, col.at(k), csvSep, csvSep_, escapeTokens);
         }
-
-        ++i;
       }
       out << endl;
     }
@@ -152,6 +176,18 @@ void monica::writeOutput(ostream& out,
   out.flush();
 }
 
+void monica::writeOutputRow(ostream& out,
+                            const J11Array& values,
+                            string csvSep)
+{
+  //using namespace std::string_literals;
+  string escapeTokens = "\n\""_s + csvSep;
+
+  for(size_t i = 0, size = values.size(); i < size; i++)
+    writeJsonValue(out, values[i], csvSep, i + 1 == size ? "" : csvSep.c_str(), escapeTokens);
+  out << endl;
+}
+
 void monica::writeOutputObj(ostream& out,
                             const vector<OId>& outputIds,
                             const vector<J11Object>& values,
@@ -34,8 +34,12 @@ namespace monica {
 
   void writeOutput(std::ostream& out,
                    const std::vector<OId>& outputIds,
-                   const std::vector<Tools::J11Array>& values,
+                   const std::vector<ResultColumn>& values,
                    std::string csvSep);
+  //! write a single row, one value per output id
+  void writeOutputRow(std::ostream& out,
+                      const Tools::J11Array& values,
+                      std::string csvSep);
   void writeOutputObj(std::ostream& out,
                       const std::vector<OId>& outputIds,
                       const std::vector<Tools::J11Object>& values,
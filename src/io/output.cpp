@@ -137,6 +137,151 @@ std::string OId::outputName() const
   return outName;
 }
 
+//-----------------------------------------------------------------------------
+
+namespace
+{
+  bool isNumberArray(const Json& j)
+  {
+    if(!j.is_array())
+      return false;
+    for(const auto& v : j.array_items())
+      if(!v.is_number())
+        return false;
+    return true;
+  }
+}
+
+ResultColumn::ResultColumn(const J11Array& values)
+{
+  for(const auto& v : values)
+    push_back(v);
+}
+
+bool ResultColumn::fits(const Json& value) const
+{
+  switch(_type)
+  {
+  case NUMBERS:
+    return _arrayRows
+      ? isNumberArray(value) && value.array_items().size() == _width
+      : value.is_number();
+  case STRINGS: return value.is_string();
+  case JSONS: return true;
+  case EMPTY:
+  default:;
+  }
+  return false;
+}
+
+void ResultColumn::switchToJsons()
+{
+  J11Array js = toJsonArray();
+  _numbers.clear();
+  _numbers.shrink_to_fit();
+  _strings.clear();
+  _strings.shrink_to_fit();
+  _jsons = move(js);
+  _type = JSONS;
+  _arrayRows = false;
+  _width = 1;
+}
+
+void ResultColumn::push_back(const Json& value)
+{
+  //the first value decides the storage of the column
+  if(_type == EMPTY)
+  {
+    if(value.is_number())
+      _type = NUMBERS;
+    else if(value.is_string())
+      _type = STRINGS;
+    else if(isNumberArray(value))
+    {
+      _type = NUMBERS;
+      _arrayRows = true;
+      _width = value.array_items().size();
+    }
+    else
+      _type = JSONS;
+  }
+  else if(!fits(value))
+    switchToJsons();
+
+  switch(_type)
+  {
+  case NUMBERS:
+    if(_arrayRows)
+      for(const auto& v : value.array_items())
+        _numbers.push_back(v.number_value());
+    else
+      _numbers.push_back(value.number_value());
+    break;
+  case STRINGS: _strings.push_back(value.string_value()); break;
+  case JSONS: _jsons.push_back(value); break;
+  case EMPTY:
+  default:;
+  }
+  ++_rows;
+}
+
+void ResultColumn::push_back(double value)
+{
+  if(_type == EMPTY)
+    _type = NUMBERS;
+  else if(_type != NUMBERS || _arrayRows)
+    return push_back(Json(value));
+
+  _numbers.push_back(value);
+  ++_rows;
+}
+
+void ResultColumn::push_back(const string& value)
+{
+  if(_type == EMPTY)
+    _type = STRINGS;
+  else if(_type != STRINGS)
+    return push_back(Json(value));
+
+  _strings.push_back(value);
+  ++_rows;
+}
+
+Json ResultColumn::at(size_t row) const
+{
+  switch(_type)
+  {
+  case NUMBERS:
+    if(_arrayRows)
+    {
+      auto start = _numbers.begin() + row * _width;
+      return J11Array(start, start + _width);
+    }
+    return _numbers[row];
+  case STRINGS: return _strings[row];
+  case JSONS: return _jsons[row];
+  case EMPTY:
+  default:;
+  }
+  return Json();
+}
+
+J11Array ResultColumn::toJsonArray() const
+{
+  J11Array js;
+  js.reserve(_rows);
+  for(size_t r = 0; r < _rows; r++)
+    js.push_back(at(r));
+  return js;
+}
+
+void ResultColumn::clear()
+{
+  *this = ResultColumn();
+}
+
+//-----------------------------------------------------------------------------
+
 Output::Output(json11::Json j)
 {
   merge(j);
@@ -167,12 +312,12 @@ Errors Output::merge(json11::Json j)
 
   for(const auto& d : j["data"].array_items())
   {
-    vector<J11Array> vs;
+    vector<ResultColumn> vs;
     vector<J11Object> os;
     for(auto& j : d["results"].array_items())
     {
       if(j.is_array())
-        vs.push_back(j.array_items());
+        vs.emplace_back(j.array_items());
       else if(j.is_object())
         os.push_back(j.object_items());
     }
@@ -192,8 +337,8 @@ json11::Json Output::to_json() const
   {
     J11Array rs;
     if(!d.results.empty())
-      for(auto r : d.results)
-        rs.push_back(r);
+      for(const auto& r : d.results)
+        rs.push_back(r.toJsonArray());
     else if(!d.resultsObj.empty())
       for(auto o : d.resultsObj)
         rs.push_back(o);
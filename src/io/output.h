@@ -18,6 +18,7 @@ Copyright (C) Leibniz Centre for Agricultural Landscape Research (ZALF)
 #pragma once
 
 #include <string>
+#include <vector>
 
 #include "json11/json11.hpp"
 
@@ -94,6 +95,66 @@ namespace monica {
 
   //---------------------------------------------------------------------------
 
+  //! the results of one output id, one row per stored value
+  //! numbers (also fixed width layer ranges) and strings are kept unboxed in typed storage,
+  //! everything else (or a column mixing types) falls back to keeping the json11::Json values
+  class DLL_API ResultColumn
+  {
+  public:
+    enum Type { EMPTY, NUMBERS, STRINGS, JSONS };
+
+    ResultColumn() {}
+
+    explicit ResultColumn(const Tools::J11Array& values);
+
+    void push_back(const json11::Json& value);
+
+    //! same as push_back(json11::Json(value)), without boxing the value
+    void push_back(double value);
+    void push_back(const std::string& value);
+
+    //! the value of a row converted back to json
+    json11::Json at(size_t row) const;
+
+    json11::Json to_json() const { return toJsonArray(); }
+
+    Tools::J11Array toJsonArray() const;
+
+    size_t size() const { return _rows; }
+
+    bool empty() const { return _rows == 0; }
+
+    void clear();
+
+    Type type() const { return _type; }
+
+    //! true if every row is an array of width() numbers (e.g. a non aggregated layer range)
+    bool hasArrayRows() const { return _arrayRows; }
+
+    size_t width() const { return _width; }
+
+    double numberAt(size_t row, size_t i = 0) const { return _numbers[row * _width + i]; }
+
+    const std::string& stringAt(size_t row) const { return _strings[row]; }
+
+    const json11::Json& jsonAt(size_t row) const { return _jsons[row]; }
+
+  private:
+    bool fits(const json11::Json& value) const;
+
+    void switchToJsons();
+
+    Type _type{EMPTY};
+    bool _arrayRows{false};
+    size_t _width{1};
+    size_t _rows{0};
+    std::vector<double> _numbers;
+    std::vector<std::string> _strings;
+    std::vector<json11::Json> _jsons;
+  };
+
+  //---------------------------------------------------------------------------
+
   struct DLL_API Output : public Tools::Json11Serializable
   {
     Output() {}
@@ -113,7 +174,7 @@ namespace monica {
     {
       std::string origSpec;
       std::vector<OId> outputIds;
-      std::vector<Tools::J11Array> results;
+      std::vector<ResultColumn> results; //!< one column per output id
       std::vector<Tools::J11Object> resultsObj;
     };
     std::vector<Data> data;
@@ -0,0 +1,143 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+* License, v. 2.0. If a copy of the MPL was not distributed with this
+* file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+/*
+Authors:
+Michael Berg <michael.berg@zalf.de>
+
+Maintainers:
+Currently maintained by the authors.
+
+This file is part of the MONICA model.
+Copyright (C) Leibniz Centre for Agricultural Landscape Research (ZALF)
+*/
+
+#include "result-sink.h"
+
+#include <cstdint>
+#include <iostream>
+
+#include "tools/helper.h"
+#include "csv-format.h"
+
+using namespace monica;
+using namespace Tools;
+using namespace std;
+using namespace json11;
+
+CsvFileResultSink::CsvFileResultSink(string pathToOutputDir, string fileNamePrefix, Json csvOptions)
+  : _pathToOutputDir(move(pathToOutputDir))
+  , _fileNamePrefix(move(fileNamePrefix))
+  , _csvOptions(move(csvOptions))
+  , _csvSep(_csvOptions["csv-separator"].string_value()) {
+  if (!_pathToOutputDir.empty() && !ensureDirExists(_pathToOutputDir)) {
+    cerr << "Error failed to create path: '" << _pathToOutputDir << "'." << endl;
+  }
+}
+
+void CsvFileResultSink::beginSection(size_t section, const string& origSpec, const vector<OId>& outputIds) {
+  auto sanitizedFileName = replace(origSpec, "\"", "");
+  sanitizedFileName = replace(sanitizedFileName, "*", "_star_");
+  sanitizedFileName = replace(sanitizedFileName, "?", "_qm_");
+  sanitizedFileName = replace(sanitizedFileName, "|", "_bar_");
+  sanitizedFileName = replace(sanitizedFileName, "<", "_lb_");
+  sanitizedFileName = replace(sanitizedFileName, ">", "_rb_");
+  sanitizedFileName = replace(sanitizedFileName, ":", "_colon_");
+  // the sections of an intercropping run's second model might have the same spec
+  if (!_sanitizedSpecs.insert(sanitizedFileName).second) sanitizedFileName += "_" + to_string(section);
+  auto pathToFile = fixSystemSeparator((_pathToOutputDir.empty() ? "" : _pathToOutputDir + "/")
+                                       + _fileNamePrefix + "_section_" + sanitizedFileName + ".csv");
+
+  auto& out = _files[section];
+  out.open(pathToFile);
+  if (out.fail()) {
+    cerr << "Error while opening output file \"" << pathToFile << "\"" << endl;
+    return;
+  }
+  writeOutputHeaderRows(out, outputIds, _csvSep,
+                        _csvOptions["include-header-row"].bool_value(),
+                        _csvOptions["include-units-row"].bool_value(),
+                        _csvOptions["include-aggregation-rows"].bool_value());
+}
+
+void CsvFileResultSink::row(size_t section, const J11Array& values) {
+  auto it = _files.find(section);
+  if (it != _files.end() && it->second.good()) writeOutputRow(it->second, values, _csvSep);
+}
+
+void CsvFileResultSink::finish() {
+  for (auto& p : _files) p.second.close();
+  _files.clear();
+}
+
+//-----------------------------------------------------------------------------
+
+namespace {
+
+enum BinaryValueTag : uint8_t { NULL_VALUE = 0, DOUBLE_VALUE, STRING_VALUE, DOUBLES_VALUE, JSON_VALUE };
+
+void writeUInt8(ostream& out, uint8_t v) { out.write(reinterpret_cast<const char*>(&v), sizeof(v)); }
+
+void writeUInt32(ostream& out, uint32_t v) { out.write(reinterpret_cast<const char*>(&v), sizeof(v)); }
+
+void writeDouble(ostream& out, double v) { out.write(reinterpret_cast<const char*>(&v), sizeof(v)); }
+
+void writeString(ostream& out, const string& s) {
+  writeUInt32(out, uint32_t(s.size()));
+  out.write(s.data(), s.size());
+}
+
+bool isNumberArray(const Json& j) {
+  if (!j.is_array()) return false;
+  for (const auto& v : j.array_items()) if (!v.is_number()) return false;
+  return true;
+}
+
+} // namespace
+
+BinaryFileResultSink::BinaryFileResultSink(const string& pathToFile)
+  : _out(pathToFile, ios::binary) {
+  if (_out.fail()) {
+    cerr << "Error while opening output file \"" << pathToFile << "\"" << endl;
+    return;
+  }
+  _out.write("MONICARS", 8);
+  writeUInt32(_out, 1);
+}
+
+void BinaryFileResultSink::beginSection(size_t section, const string& origSpec, const vector<OId>& outputIds) {
+  if (!isOpen()) return;
+  writeUInt8(_out, 'S');
+  writeUInt32(_out, uint32_t(section));
+  writeString(_out, origSpec);
+  writeString(_out, Json(toJsonArray(outputIds)).dump());
+}
+
+void BinaryFileResultSink::row(size_t section, const J11Array& values) {
+  if (!isOpen()) return;
+  writeUInt8(_out, 'R');
+  writeUInt32(_out, uint32_t(section));
+  writeUInt32(_out, uint32_t(values.size()));
+  for (const auto& v : values) {
+    if (v.is_null()) writeUInt8(_out, NULL_VALUE);
+    else if (v.is_number()) {
+      writeUInt8(_out, DOUBLE_VALUE);
+      writeDouble(_out, v.number_value());
+    } else if (v.is_string()) {
+      writeUInt8(_out, STRING_VALUE);
+      writeString(_out, v.string_value());
+    } else if (isNumberArray(v)) {
+      writeUInt8(_out, DOUBLES_VALUE);
+      writeUInt32(_out, uint32_t(v.array_items().size()));
+      for (const auto& d : v.array_items()) writeDouble(_out, d.number_value());
+    } else {
+      writeUInt8(_out, JSON_VALUE);
+      writeString(_out, v.dump());
+    }
+  }
+}
+
+void BinaryFileResultSink::finish() {
+  if (_out.is_open()) _out.close();
+}
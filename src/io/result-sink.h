@@ -0,0 +1,94 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+* License, v. 2.0. If a copy of the MPL was not distributed with this
+* file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+/*
+Authors:
+Michael Berg <michael.berg@zalf.de>
+
+Maintainers:
+Currently maintained by the authors.
+
+This file is part of the MONICA model.
+Copyright (C) Leibniz Centre for Agricultural Landscape Research (ZALF)
+*/
+
+#pragma once
+
+#include <fstream>
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "json11/json11.hpp"
+#include "json11/json11-helper.h"
+
+#include "output.h"
+
+namespace monica {
+
+//! receives the results of a run as soon as they are final, instead of collecting them in an Output
+//! a section corresponds to one event spec of the "events" section (one Output::Data)
+class ResultSink {
+public:
+  virtual ~ResultSink() = default;
+
+  //! called once per section, before any row of that section
+  virtual void beginSection(size_t section, const std::string& origSpec, const std::vector<OId>& outputIds) {}
+
+  //! a final row of a section, one value per output id (null if the output id couldn't be resolved)
+  virtual void row(size_t section, const Tools::J11Array& values) = 0;
+
+  //! all rows of the run have been pushed
+  virtual void finish() {}
+};
+
+//-----------------------------------------------------------------------------
+
+//! writes every section into its own csv file, named like monica-run names multiple output files
+//! <pathToOutputDir>/<fileNamePrefix>_section_<sanitized origSpec>.csv
+class CsvFileResultSink : public ResultSink {
+public:
+  CsvFileResultSink(std::string pathToOutputDir, std::string fileNamePrefix, json11::Json csvOptions);
+
+  void beginSection(size_t section, const std::string& origSpec, const std::vector<OId>& outputIds) override;
+
+  void row(size_t section, const Tools::J11Array& values) override;
+
+  void finish() override;
+
+private:
+  std::string _pathToOutputDir;
+  std::string _fileNamePrefix;
+  json11::Json _csvOptions;
+  std::string _csvSep;
+  std::map<size_t, std::ofstream> _files;
+  std::set<std::string> _sanitizedSpecs;
+};
+
+//-----------------------------------------------------------------------------
+
+//! writes all sections into a single binary file, as a sequence of records (native byte order)
+//! file:    "MONICARS" uint32 version
+//! section: uint8 'S' uint32 section, string origSpec, string outputIds (as json)
+//! row:     uint8 'R' uint32 section, uint32 noOfValues, values
+//! value:   uint8 tag, 0 = null | 1 = double | 2 = string | 3 = uint32 n + n doubles | 4 = string (other json)
+//! string:  uint32 length + bytes
+class BinaryFileResultSink : public ResultSink {
+public:
+  explicit BinaryFileResultSink(const std::string& pathToFile);
+
+  bool isOpen() const { return _out.is_open() && _out.good(); }
+
+  void beginSection(size_t section, const std::string& origSpec, const std::vector<OId>& outputIds) override;
+
+  void row(size_t section, const Tools::J11Array& values) override;
+
+  void finish() override;
+
+private:
+  std::ofstream _out;
+};
+
+} // namespace monica
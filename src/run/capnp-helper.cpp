@@ -74,6 +74,15 @@ std::map<ACD, double> monica::dailyClimateDataToDailyClimateMap(
   return res;
 }
 
+ClimateStep monica::dailyClimateDataToClimateStep(
+  const capnp::List<mas::schema::model::monica::Params::DailyWeather::KV>::Reader& dailyData) {
+  ClimateStep res;
+  for (const auto& kv : dailyData) {
+    auto acd = climateElementToACD(kv.getKey());
+    if (acd != ACD::skip) res.set(acd, kv.getValue());
+  }
+  return res;
+}
 
 DataAccessor monica::fromCapnpData(
     const Tools::Date &startDate,
@@ -18,6 +18,7 @@ Copyright (C) Leibniz Centre for Agricultural Landscape Research (ZALF)
 #include "tools/date.h"
 #include "climate/climate-common.h"
 #include "json11/json11-helper.h"
+#include "../core/climate-step.h"
 
 #include "soil.capnp.h"
 #include "climate.capnp.h"
@@ -34,6 +35,9 @@ std::map<Climate::ACD, double> dailyClimateDataToDailyClimateMap(
 std::map<Climate::ACD, double> dailyClimateDataToDailyClimateMap(
   const capnp::List<mas::schema::model::monica::Params::DailyWeather::KV>::Reader& dailyData);
 
+ClimateStep dailyClimateDataToClimateStep(
+  const capnp::List<mas::schema::model::monica::Params::DailyWeather::KV>::Reader& dailyData);
+
 Climate::DataAccessor fromCapnpData(
     const Tools::Date &startDate,
     const Tools::Date &endDate,
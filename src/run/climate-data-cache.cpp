@@ -0,0 +1,136 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+* License, v. 2.0. If a copy of the MPL was not distributed with this
+* file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+/*
+Authors:
+Michael Berg <michael.berg@zalf.de>
+
+Maintainers:
+Currently maintained by the authors.
+
+This file is part of the MONICA model.
+Copyright (C) Leibniz Centre for Agricultural Landscape Research (ZALF)
+*/
+
+#include "climate-data-cache.h"
+
+#include <filesystem>
+#include <list>
+#include <mutex>
+#include <unordered_map>
+
+#include "../io/climate-csv-reader.h"
+
+using namespace monica;
+using namespace std;
+using namespace Tools;
+namespace fs = std::filesystem;
+
+namespace {
+
+struct CacheEntry {
+  string key;
+  SharedClimateData data;
+  size_t bytes{0};
+};
+
+struct ClimateDataCache {
+  mutex lock;
+  size_t capacity{size_t(512) * 1024 * 1024};
+  list<CacheEntry> lru; //!< most recently used first
+  unordered_map<string, list<CacheEntry>::iterator> key2entry;
+  ClimateDataCacheStats stats;
+
+  void evictUntil(size_t maxBytes) {
+    while (!lru.empty() && stats.bytes > maxBytes) {
+      stats.bytes -= lru.back().bytes;
+      key2entry.erase(lru.back().key);
+      lru.pop_back();
+    }
+    stats.entries = lru.size();
+  }
+};
+
+ClimateDataCache& cache() {
+  static ClimateDataCache c;
+  return c;
+}
+
+//! build the key from the files' identities and the options
+//! @return false if a file can't be part of a key (time series or not found)
+bool createKey(const vector<string>& pathsToFiles, const json11::Json& options, string& key, size_t& bytes) {
+  key = options.dump();
+  bytes = 0;
+  for (const auto& path : pathsToFiles) {
+    if (path.find("capnp://") == 0) return false;
+    error_code ec;
+    auto canonicalPath = fs::canonical(path, ec);
+    if (ec) return false;
+    auto size = fs::file_size(canonicalPath, ec);
+    if (ec) return false;
+    auto mtime = fs::last_write_time(canonicalPath, ec);
+    if (ec) return false;
+    key += "|" + canonicalPath.string()
+           + "|" + to_string(mtime.time_since_epoch().count())
+           + "|" + to_string(size);
+    bytes += size_t(size);
+  }
+  return true;
+}
+
+} // namespace
+
+SharedClimateData monica::readClimateDataFromCSVFilesViaHeadersCached(const vector<string>& pathsToFiles,
+                                                                     const json11::Json& options) {
+  auto& c = cache();
+  string key;
+  size_t bytes = 0;
+  bool cacheable = createKey(pathsToFiles, options, key, bytes);
+  if (cacheable) {
+    lock_guard<mutex> lock(c.lock);
+    cacheable = bytes <= c.capacity;
+    if (cacheable) {
+      auto it = c.key2entry.find(key);
+      if (it != c.key2entry.end()) {
+        c.lru.splice(c.lru.begin(), c.lru, it->second);
+        c.stats.hits++;
+        return it->second->data;
+      }
+      c.stats.misses++;
+    }
+  }
+
+  // parse without holding the lock, concurrent misses of the same files might parse them twice
+  auto data = make_shared<const EResult<Climate::DataAccessor>>(
+    readClimateDataFromCSVFilesViaHeadersFast(pathsToFiles, options));
+  if (!cacheable || data->failure()) return data;
+
+  lock_guard<mutex> lock(c.lock);
+  auto it = c.key2entry.find(key);
+  if (it != c.key2entry.end()) return it->second->data;
+  c.lru.push_front({key, data, bytes});
+  c.key2entry[key] = c.lru.begin();
+  c.stats.bytes += bytes;
+  c.evictUntil(c.capacity);
+  return data;
+}
+
+void monica::setClimateDataCacheCapacity(size_t bytes) {
+  auto& c = cache();
+  lock_guard<mutex> lock(c.lock);
+  c.capacity = bytes;
+  c.evictUntil(bytes);
+}
+
+size_t monica::climateDataCacheCapacity() {
+  auto& c = cache();
+  lock_guard<mutex> lock(c.lock);
+  return c.capacity;
+}
+
+ClimateDataCacheStats monica::climateDataCacheStats() {
+  auto& c = cache();
+  lock_guard<mutex> lock(c.lock);
+  return c.stats;
+}
@@ -0,0 +1,61 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+* License, v. 2.0. If a copy of the MPL was not distributed with this
+* file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+/*
+Authors:
+Michael Berg <michael.berg@zalf.de>
+
+Maintainers:
+Currently maintained by the authors.
+
+This file is part of the MONICA model.
+Copyright (C) Leibniz Centre for Agricultural Landscape Research (ZALF)
+*/
+
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "json11/json11.hpp"
+
+#include "climate/climate-common.h"
+#include "tools/helper.h"
+
+namespace monica {
+
+/*
+ * Process wide LRU cache of climate data read from csv files, so the many jobs sharing
+ * the same weather files parse every file just once.
+ *
+ * The key are the canonical paths together with the files' modification times and sizes
+ * and the csv options (e.g. start/end date), so changed files are read again.
+ * The cache is bounded by the size of the cached csv files.
+ */
+
+typedef std::shared_ptr<const Tools::EResult<Climate::DataAccessor>> SharedClimateData;
+
+//! like Climate::readClimateDataFromCSVFilesViaHeaders, but returns the cached data if the files have been read before
+//! the returned data are shared with the cache (and other jobs), so they must not be modified
+//! paths to time series (capnp://) and files which can't be found are never cached
+SharedClimateData readClimateDataFromCSVFilesViaHeadersCached(const std::vector<std::string>& pathsToFiles,
+                                                             const json11::Json& options);
+
+//! set the max size of the cached csv files in bytes, 0 disables caching
+void setClimateDataCacheCapacity(size_t bytes);
+
+size_t climateDataCacheCapacity();
+
+//! the cache's statistics since the start of the process
+struct ClimateDataCacheStats {
+  size_t hits{0};
+  size_t misses{0};
+  size_t entries{0};
+  size_t bytes{0};
+};
+ClimateDataCacheStats climateDataCacheStats();
+
+} // namespace monica
@@ -17,12 +17,14 @@ Copyright (C) Leibniz Centre for Agricultural Landscape Research (ZALF)
 #include <fstream>
 #include <string>
 #include <set>
+#include <tuple>
 
 #include "create-env-from-json-config.h"
 #include "tools/debug.h"
 #include "json11/json11-helper.h"
 #include "tools/helper.h"
 #include "climate/climate-file-io.h"
+#include "climate-data-cache.h"
 #include "soil/conversion.h"
 #include "../io/output.h"
 #include "capnp-helper.h"
@@ -373,6 +375,10 @@ Json monica::createEnvJsonFromJsonStrings(std::map<std::string, std::string> par
 }
 
 Json monica::createEnvJsonFromJsonObjects(std::map<std::string, json11::Json> params) {
+  return createEnvJsonFromJsonObjects(kj::mv(params), nullptr);
+}
+
+Json monica::createEnvJsonFromJsonObjects(std::map<std::string, json11::Json> params, SharedClimateData* climateData) {
   vector<Json> cropSiteSim;
   for (auto name : { "crop", "site", "sim" }) cropSiteSim.push_back(params[name]);
 
@@ -444,19 +450,63 @@ Json monica::createEnvJsonFromJsonObjects(std::map<std::string, json11::Json> pa
   csvos["latitude"] = double_valueD(sitej["SiteParameters"], "Latitude", 0.0);
   env["csvViaHeaderOptions"] = csvos;
 
+  SharedClimateData sda;
   if(simj["climate.csv"].is_string() && !simj["climate.csv"].string_value().empty()) {
     if (simj["climate.csv"].string_value().find("capnp://") == string::npos) {
-      env["climateData"] = printPossibleErrors(readClimateDataFromCSVFileViaHeaders(simj["climate.csv"].string_value(),
-                                                                                    env["csvViaHeaderOptions"]));
+      sda = readClimateDataFromCSVFilesViaHeadersCached({simj["climate.csv"].string_value()}, env["csvViaHeaderOptions"]);
     }
   } else if(simj["climate.csv"].is_array() && !simj["climate.csv"].array_items().empty()) {
-    env["climateData"] = printPossibleErrors(readClimateDataFromCSVFilesViaHeaders(toStringVector(simj["climate.csv"].array_items()),
-                                                               env["csvViaHeaderOptions"]));
+    sda = readClimateDataFromCSVFilesViaHeadersCached(toStringVector(simj["climate.csv"].array_items()),
+                                                      env["csvViaHeaderOptions"]);
+  }
+  if (sda) {
+    // the (possibly cached) data are handed out directly, so they don't take the way through json
+    if (climateData) {
+      for (const auto& e : sda->errors) cerr << e << endl;
+      if (sda->success()) *climateData = sda;
+    } else env["climateData"] = printPossibleErrors(EResult<DataAccessor>(*sda));
   }
 
   return env;
 }
 
+Json monica::createEnvJsonFromSimJsonFile(const string& pathToSimJson) {
+  string pathOfSimJson, simFileName;
+  tie(pathOfSimJson, simFileName) = splitPathToFile(pathToSimJson);
+
+  auto simj = readAndParseJsonFile(pathToSimJson);
+  if (simj.failure()) {
+    for (const auto& e : simj.errors) cerr << e << endl;
+    return Json();
+  }
+  auto simm = simj.result.object_items();
+  simm["sim.json"] = pathToSimJson;
+
+  auto makeAbsolute = [&](const string& path) { return isAbsolutePath(path) ? path : pathOfSimJson + path; };
+  simm["crop.json"] = makeAbsolute(simm["crop.json"].string_value());
+  simm["site.json"] = makeAbsolute(simm["site.json"].string_value());
+  if (simm["climate.csv"].is_string()) simm["climate.csv"] = makeAbsolute(simm["climate.csv"].string_value());
+  else if (simm["climate.csv"].is_array()) {
+    vector<string> ps;
+    for (const auto& j : simm["climate.csv"].array_items()) ps.push_back(makeAbsolute(j.string_value()));
+    simm["climate.csv"] = toPrimJsonArray(ps);
+  }
+
+  map<string, Json> ps;
+  ps["sim"] = Json(simm);
+  ps["crop"] = printPossibleErrors(parseJsonString(printPossibleErrors(readFile(simm["crop.json"].string_value()),
+                                                                       true)), true);
+  ps["site"] = printPossibleErrors(parseJsonString(printPossibleErrors(readFile(simm["site.json"].string_value()),
+                                                                       true)), true);
+  if (ps["crop"].is_null() || ps["site"].is_null()) return Json();
+  if (ps["site"]["SiteParameters"]["SoilProfileParameters"].is_string()) {
+    cerr << "Error: soil profile sturdy refs in '" << simm["site.json"].string_value() << "' are not supported." << endl;
+    return Json();
+  }
+
+  return createEnvJsonFromJsonObjects(ps);
+}
+
 Env monica::createEnvFromJsonConfigFiles(std::map<std::string, std::string> params) {
   Env env;
   if(!Tools::printPossibleErrors(env.merge(createEnvJsonFromJsonStrings(kj::mv(params))), Tools::activateDebug))
@@ -466,11 +516,14 @@ Env monica::createEnvFromJsonConfigFiles(std::map<std::string, std::string> para
 
 Env monica::createEnvFromJsonObjects(std::map<std::string, json11::Json> params) {
   Env env;
-  if(!Tools::printPossibleErrors(env.merge(createEnvJsonFromJsonObjects(kj::mv(params))), Tools::activateDebug))
+  if(!Tools::printPossibleErrors(updateEnvFromJsonObjects(env, kj::mv(params)), Tools::activateDebug))
     return {};
   return env;
 }
 
 Errors monica::updateEnvFromJsonObjects(Env &env, std::map<std::string, json11::Json> params) {
-  return env.merge(createEnvJsonFromJsonObjects(kj::mv(params)));
+  SharedClimateData climateData;
+  auto errors = env.merge(createEnvJsonFromJsonObjects(kj::mv(params), &climateData));
+  if (climateData) env.climateData = climateData->result;
+  return errors;
 }
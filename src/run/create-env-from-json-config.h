@@ -19,6 +19,7 @@ Copyright (C) Leibniz Centre for Agricultural Landscape Research (ZALF)
 
 #include "tools/date.h"
 #include "run-monica.h"
+#include "climate-data-cache.h"
 #include "json11/json11.hpp"
 #include "json11/json11-helper.h"
 
@@ -31,10 +32,19 @@ json11::Json createEnvJsonFromJsonStrings(std::map<std::string, std::string> par
 
 json11::Json createEnvJsonFromJsonObjects(std::map<std::string, json11::Json> params);
 
+//! the climate data read from the csv files aren't put into the returned json, but returned as climateData,
+//! to be assigned to Env::climateData after merging (so cached data aren't converted to json and back for every env)
+json11::Json createEnvJsonFromJsonObjects(std::map<std::string, json11::Json> params, SharedClimateData* climateData);
+
+//! read sim.json and the crop.json, site.json and climate csv files it refers to (relative paths are relative to sim.json)
+//! @return the json to merge an Env from, null json if something couldn't be read
+json11::Json createEnvJsonFromSimJsonFile(const std::string& pathToSimJson);
+
 Env createEnvFromJsonConfigFiles(std::map<std::string, std::string> params);
 
 Env createEnvFromJsonObjects(std::map<std::string, json11::Json> params);
 
+//! merge the env json created from params into env, climate data read from csv files are assigned directly
 Tools::Errors updateEnvFromJsonObjects(Env &env, std::map<std::string, json11::Json> params);
 
 }
@@ -92,7 +92,8 @@ Workstep::Workstep(const Tools::Date& d)
 
 Workstep::Workstep(int noOfDaysAfterEvent, const std::string& afterEvent)
 : _applyNoOfDaysAfterEvent(noOfDaysAfterEvent)
-, _afterEvent(afterEvent) {}
+, _afterEvent(afterEvent)
+, _afterEventId(afterEvent.empty() ? NO_EVENT_ID : lookupEvent(afterEvent)) {}
 
 Workstep::Workstep(json11::Json j) {
   _errors.append(Workstep::merge(kj::mv(j)));
@@ -110,6 +111,7 @@ Errors Workstep::merge(json11::Json j) {
   }
   set_int_value(_applyNoOfDaysAfterEvent, j, "days");
   set_string_value(_afterEvent, j, "after");
+  _afterEventId = _afterEvent.empty() ? NO_EVENT_ID : lookupEvent(_afterEvent);
   set_bool_value(_runAtStartOfDay, j, "runAtStartOfDay");
 
   return res;
@@ -127,11 +129,18 @@ json11::Json Workstep::to_json() const {
 }
 
 bool Workstep::apply(MonicaModel* model) {
+  if (_attachedTo != model) attachTo(model);
   model->addEvent("Workstep");
   return true;
 }
 
+void Workstep::attachTo(MonicaModel* model) {
+  registerClimateHistoryNeeds(model->climateHistoryNC());
+  _attachedTo = model;
+}
+
 bool Workstep::applyWithPossibleCondition(MonicaModel* model) {
+  if (_attachedTo != model) attachTo(model);
   bool workstepFinished = false;
   if (isActive()) {
     if (isDynamicWorkstep()) workstepFinished = condition(model) ? apply(model) : false;
@@ -149,10 +158,13 @@ bool Workstep::condition(MonicaModel* model) {
   const auto& currEvents = model->currentEvents();
   const auto& prevEvents = model->previousDaysEvents();
 
-  auto ceit = currEvents.find(_afterEvent);
+  // names which aren't built-in events have to be compared as strings
+  bool afterEventHappened = _afterEventId == NO_EVENT_ID
+                            ? currEvents.contains(_afterEvent) || prevEvents.contains(_afterEvent)
+                            : currEvents.contains(_afterEventId) || prevEvents.contains(_afterEventId);
   if (_daysAfterEventCountActivated) {
     _daysAfterEventCount++;
-  } else if (ceit != currEvents.end() || prevEvents.find(_afterEvent) != prevEvents.end()) {
+  } else if (afterEventHappened) {
     _daysAfterEventCountActivated = true;
   }
 
@@ -319,16 +331,15 @@ bool isSoilMoistureOk(MonicaModel* model,
   return soilMoistureOk;
 }
 
-bool isPrecipitationOk(const std::vector<std::map<Climate::ACD, double>>& climateData,
+bool isPrecipitationOk(const ClimateHistory& climateHistory,
                        double max3dayPrecipSum,
                        double maxCurrentDayPrecipSum) {
   bool precipOk = false;
-  double psum3d = accumulate(climateData.rbegin(), climateData.rbegin() + 3, 0.0,
-                             [](double acc, const map<ACD, double>& d) {
-                               auto it = d.find(Climate::precip);
-                               return acc + (it == d.end() ? 0 : it->second);
-                             });
-  double currentp = climateData.back().at(Climate::precip);
+  double psum3d = 0.0;
+  for (size_t i = 0, size = min(size_t(3), climateHistory.size()); i < size; i++) {
+    psum3d += climateHistory.daysAgo(i).get(Climate::precip);
+  }
+  double currentp = climateHistory.back().at(Climate::precip);
   precipOk = psum3d <= max3dayPrecipSum && currentp <= maxCurrentDayPrecipSum;
 
   return precipOk;
@@ -393,15 +404,15 @@ bool AutomaticSowing::condition(MonicaModel* model) {
     if (!isSoilTemperatureOk(_getAvgSoilTemps(), _daysInSoilTempWindow, _sowingIfAboveAvgSoilTemp)) return false;
   }
 
-  const auto& cd = model->climateData();
-  auto currentCd = cd.back();
+  const auto& cd = model->climateHistory();
+  const auto& currentCd = cd.back();
 
   auto avg = [&](Climate::ACD acd) {
-    return accumulate(cd.rbegin(), cd.rbegin() + std::min(int(cd.size()), _daysInTempWindow),
-                      0.0, [acd](double acc, const map<ACD, double>& d) {
-                        auto it = d.find(acd);
-                        return acc + (it == d.end() ? 0 : it->second);
-                      }) / min(int(cd.size()), _daysInTempWindow);
+    double sum = 0.0;
+    for (size_t i = 0, size = min(cd.size(), size_t(max(0, _daysInTempWindow))); i < size; i++) {
+      sum += cd.daysAgo(i).get(acd);
+    }
+    return sum / min(int(cd.size()), _daysInTempWindow);
   };
 
   //check temperature
@@ -412,7 +423,7 @@ bool AutomaticSowing::condition(MonicaModel* model) {
   } else {
     double avgTmin = avg(Climate::tmin);
     bool avgTminOk = avgTmin >= _minTempThreshold;
-    bool TminOk = currentCd[Climate::tmin] >= _minTempThreshold;
+    bool TminOk = currentCd.get(Climate::tmin) >= _minTempThreshold;
     Tok = avgTminOk && TminOk;
   }
 
@@ -425,17 +436,18 @@ bool AutomaticSowing::condition(MonicaModel* model) {
   if (!isPrecipitationOk(cd, _max3dayPrecipSum, _maxCurrentDayPrecipSum)) return false;
 
   //check temperature sum
-  double baseTemp = _baseTemp;
-  double tempSum = accumulate(cd.begin(), cd.end(), 0.0,
-                              [baseTemp](double acc, const map<ACD, double>& d) {
-                                auto it = d.find(Climate::tavg);
-                                return acc + (it == d.end() ? 0 : max(0.0, it->second - baseTemp));
-                              });
+  double tempSum = model->climateHistoryNC().tavgSumAboveBaseTemp(_baseTemp);
   if (tempSum < _tempSumAboveBaseTemp) return false;
 
   return true;
 }
 
+void AutomaticSowing::registerClimateHistoryNeeds(ClimateHistory& history) const {
+  // temperature window and 3 days of precipitation, the temperature sum is over the whole run
+  history.requireDays(max(_daysInTempWindow, 3));
+  history.trackTavgSumAboveBaseTemp(_baseTemp);
+}
+
 bool AutomaticSowing::reinit(Tools::Date date, bool addYear, bool forceInitYear) {
   Workstep::reinit(date, addYear);
 
@@ -703,11 +715,16 @@ bool AutomaticHarvest::condition(MonicaModel* model) {
       || (_harvestTime == "maturity"
           && model->cropGrowth()->maturityReached() //has maturity been reached
           && isSoilMoistureOk(model, _minPercentASW, _maxPercentASW) //check soil moisture
-          && isPrecipitationOk(model->climateData(), _max3dayPrecipSum, _maxCurrentDayPrecipSum)); //check precipitation
+          && isPrecipitationOk(model->climateHistory(), _max3dayPrecipSum, _maxCurrentDayPrecipSum)); //check precipitation
 
   return conditionMet;
 }
 
+void AutomaticHarvest::registerClimateHistoryNeeds(ClimateHistory& history) const {
+  // 3 days of precipitation
+  history.requireDays(3);
+}
+
 bool AutomaticHarvest::reinit(Tools::Date date, bool addYear, bool forceInitYear) {
   Workstep::reinit(date, addYear);
 
@@ -1132,6 +1149,10 @@ json11::Json SaveMonicaState::to_json() const {
   };
 }
 
+void SaveMonicaState::registerClimateHistoryNeeds(ClimateHistory& history) const {
+  if (_noOfPreviousDaysSerializedClimateData > 0) history.requireDays(size_t(_noOfPreviousDaysSerializedClimateData));
+}
+
 bool SaveMonicaState::apply(MonicaModel* model) {
   Workstep::apply(model);
 
@@ -1491,6 +1512,10 @@ void CultivationMethod::apply(MonicaModel* model, bool runOnlyAtStartOfDayWorkst
                        }), udws.end());
 }
 
+void CultivationMethod::attachTo(MonicaModel* model) const {
+  for (const auto& ws : _allWorksteps) ws->attachTo(model);
+}
+
 Date CultivationMethod::nextDate(const Date& date) const {
   //auto ci = _allWorksteps.upper_bound(date);
   //return ci != _allWorksteps.end() ? ci->first : Date();
@@ -34,10 +34,12 @@ Copyright (C) Leibniz Centre for Agricultural Landscape Research (ZALF)
 #include "soil/soil.h"
 #include "../core/monica-parameters.h"
 #include "../core/crop.h"
+#include "../core/event-registry.h"
 #include "../io/output.h"
 
 namespace monica {
 class MonicaModel;
+class ClimateHistory;
 
 class DLL_API Workstep : public Tools::Json11Serializable {
 public:
@@ -99,6 +101,14 @@ public:
     return std::function<double(MonicaModel*)>();
   };
 
+  //! the model keeps only a bounded climate history, so worksteps looking back have to register what they need
+  virtual void registerClimateHistoryNeeds(ClimateHistory& history) const {}
+
+  //! register what the workstep needs of model (e.g. its climate history), as soon as the workstep belongs to model
+  //! apply() and applyWithPossibleCondition() attach on their first use at model, which might be too late
+  //! for worksteps looking back (e.g. the temperature sum of automatic sowing starts then)
+  void attachTo(MonicaModel* model);
+
   bool runAtStartOfDay() const { return _runAtStartOfDay; }
 
   Tools::Errors& errors() { return _errors; }
@@ -108,11 +118,13 @@ protected:
   Tools::Date _absDate;
   int _applyNoOfDaysAfterEvent{0};
   std::string _afterEvent;
+  EventId _afterEventId{NO_EVENT_ID}; //!< id of _afterEvent, if it is a built-in event
   int _daysAfterEventCount{0};
   bool _daysAfterEventCountActivated{false};
   bool _isActive{true};
   bool _runAtStartOfDay{true};
   Tools::Errors _errors;
+  const MonicaModel* _attachedTo{nullptr};
 };
 
 typedef std::shared_ptr<Workstep> WSPtr;
@@ -197,6 +209,8 @@ public:
   std::function<double(MonicaModel*)>
   registerDailyFunction(std::function<std::vector<double> &()> getDailyValues) override;
 
+  void registerClimateHistoryNeeds(ClimateHistory& history) const override;
+
 private:
   Tools::Date _absEarliestDate;
   Tools::Date _earliestDate;
@@ -368,6 +382,8 @@ public:
 
   Tools::Date absLatestDate() const override { return _absLatestDate; }
 
+  void registerClimateHistoryNeeds(ClimateHistory& history) const override;
+
 private:
   std::string _harvestTime; //!< Harvest time parameter
   Tools::Date _latestDate;
@@ -589,6 +605,8 @@ public:
 
   std::string pathToSerializedStateFile() const { return _pathToFile; }
 
+  void registerClimateHistoryNeeds(ClimateHistory& history) const override;
+
 private:
   std::string _pathToFile;
   bool _toJson{false};
@@ -685,6 +703,9 @@ public:
 
   void apply(MonicaModel* model, bool runOnlyAtStartOfDayWorksteps);
 
+  //! attach all worksteps to model (see Workstep::attachTo)
+  void attachTo(MonicaModel* model) const;
+
   Tools::Date nextDate(const Tools::Date& date) const;
 
   Tools::Date nextAbsDate(const Tools::Date& date) const;
@@ -33,7 +33,9 @@ Copyright (C) Leibniz Centre for Agricultural Landscape Research (ZALF)
 
 #include "run-monica-capnp.h"
 #include "run-monica.h"
+#include "../core/debug-log.h"
 #include "capnp-helper.h"
+#include "pwp-fc-sat-functions.h"
 #include "channel.h"
 #include "PortConnector.h"
 #include "climate-file-io.h"
@@ -202,7 +204,7 @@ public:
 
 
   void runMonica() { //vector<Workstep> dailyWorksteps) {
-    debug() << "currentDate: " << monica->currentStepDate().toString() << endl;
+    MONICA_DEBUG("currentDate: " << monica->currentStepDate().toString() << endl);
 
     monica->dailyReset();
 
@@ -281,15 +283,7 @@ public:
             const json11::Json& envJson = json11::Json::parse(stEnv.getValue().cStr(), err);
             auto envJsonStr = envJson.dump();
             //cout << "runMonica: " << envJson["customId"].dump() << endl;
-            auto pathToSoilDir = fixSystemSeparator(replaceEnvVars("${MONICA_PARAMETERS}/soil/"));
-            env.params.siteParameters.calculateAndSetPwpFcSatFunctions["Wessolek2009"] =
-              Soil::getInitializedUpdateUnsetPwpFcSatfromKA5textureClassFunction(pathToSoilDir);
-            env.params.siteParameters.calculateAndSetPwpFcSatFunctions["VanGenuchten"] =
-              Soil::updateUnsetPwpFcSatFromVanGenuchtenVereecken;
-            env.params.siteParameters.calculateAndSetPwpFcSatFunctions["VanGenuchtenVereecken"] =
-              Soil::updateUnsetPwpFcSatFromVanGenuchtenVereecken;
-            env.params.siteParameters.calculateAndSetPwpFcSatFunctions["Toth"] =
-              Soil::updateUnsetPwpFcSatFromToth;
+            env.params.siteParameters.calculateAndSetPwpFcSatFunctions = pwpFcSatFunctions();
             auto errors = env.merge(envJson);
             monica = nullptr;
             monica = kj::heap<MonicaModel>(env.params);
@@ -389,7 +383,7 @@ public:
                 if (event.getParams().isNull() || !event.isAt()) continue;
                 KJ_LOG(INFO, "received weather data at", eventDate.toIsoDateString());
                 auto dw = event.getParams().getAs<mas::schema::model::monica::Params::DailyWeather>();
-                auto climateData = dailyClimateDataToDailyClimateMap(dw.getData());
+                auto climateData = dailyClimateDataToClimateStep(dw.getData());
                 monica->setCurrentStepDate(eventDate);
                 monica->setCurrentStepClimateData(climateData);
                 runMonica();
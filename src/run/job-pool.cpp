@@ -0,0 +1,106 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+* License, v. 2.0. If a copy of the MPL was not distributed with this
+* file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+/*
+Authors:
+Michael Berg <michael.berg@zalf.de>
+
+Maintainers:
+Currently maintained by the authors.
+
+This file is part of the MONICA model.
+Copyright (C) Leibniz Centre for Agricultural Landscape Research (ZALF)
+*/
+
+#include "job-pool.h"
+
+#include <algorithm>
+#include <iostream>
+
+using namespace monica;
+using namespace std;
+
+JobPool::JobPool(size_t noOfThreads) {
+  noOfThreads = max(size_t(1), noOfThreads);
+  for (size_t i = 0; i < noOfThreads; i++) _queues.push_back(make_unique<Queue>());
+  for (size_t i = 0; i < noOfThreads; i++) _threads.emplace_back([this, i] { work(i); });
+}
+
+JobPool::~JobPool() {
+  {
+    lock_guard<mutex> lock(_mutex);
+    _stop = true;
+  }
+  _jobAvailable.notify_all();
+  for (auto& t : _threads) t.join();
+}
+
+void JobPool::submit(function<void()> job) {
+  // count the job before it becomes visible, so a worker taking it right away can't underflow the counters
+  {
+    lock_guard<mutex> lock(_mutex);
+    _queuedJobs++;
+    _unfinishedJobs++;
+  }
+  auto& q = *_queues[_nextQueue++ % _queues.size()];
+  {
+    lock_guard<mutex> lock(q.mutex);
+    q.jobs.push_back(std::move(job));
+  }
+  _jobAvailable.notify_one();
+}
+
+void JobPool::waitForAll() {
+  unique_lock<mutex> lock(_mutex);
+  _allDone.wait(lock, [this] { return _unfinishedJobs == 0; });
+}
+
+bool JobPool::tryPop(size_t threadIndex, function<void()>& job) {
+  auto& q = *_queues[threadIndex];
+  lock_guard<mutex> lock(q.mutex);
+  if (q.jobs.empty()) return false;
+  job = std::move(q.jobs.back());
+  q.jobs.pop_back();
+  return true;
+}
+
+bool JobPool::trySteal(size_t threadIndex, function<void()>& job) {
+  for (size_t k = 1, size = _queues.size(); k < size; k++) {
+    auto& q = *_queues[(threadIndex + k) % size];
+    lock_guard<mutex> lock(q.mutex);
+    if (q.jobs.empty()) continue;
+    job = std::move(q.jobs.front());
+    q.jobs.pop_front();
+    return true;
+  }
+  return false;
+}
+
+void JobPool::work(size_t threadIndex) {
+  while (true) {
+    function<void()> job;
+    if (tryPop(threadIndex, job) || trySteal(threadIndex, job)) {
+      {
+        lock_guard<mutex> lock(_mutex);
+        _queuedJobs--;
+      }
+      try {
+        job();
+      } catch (const exception& e) {
+        cerr << "Error: uncaught exception in job pool worker " << threadIndex << ": " << e.what() << endl;
+      } catch (...) {
+        cerr << "Error: uncaught unknown exception in job pool worker " << threadIndex << endl;
+      }
+      {
+        lock_guard<mutex> lock(_mutex);
+        if (--_unfinishedJobs == 0) _allDone.notify_all();
+      }
+      continue;
+    }
+
+    unique_lock<mutex> lock(_mutex);
+    _jobAvailable.wait(lock, [this] { return _stop || _queuedJobs > 0; });
+    if (_stop && _queuedJobs == 0) return;
+  }
+}
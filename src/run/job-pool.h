@@ -0,0 +1,77 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+* License, v. 2.0. If a copy of the MPL was not distributed with this
+* file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+/*
+Authors:
+Michael Berg <michael.berg@zalf.de>
+
+Maintainers:
+Currently maintained by the authors.
+
+This file is part of the MONICA model.
+Copyright (C) Leibniz Centre for Agricultural Landscape Research (ZALF)
+*/
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace monica {
+
+/**
+ * @brief Fixed size pool of worker threads with one job queue per worker.
+ *
+ * Submitted jobs are distributed round robin onto the workers' queues. A worker takes
+ * jobs from the back of its own queue and, if that is empty, steals from the front of
+ * the other workers' queues, so long running jobs (e.g. whole MONICA runs) don't leave
+ * threads idle while other queues still hold work.
+ */
+class JobPool {
+public:
+  explicit JobPool(size_t noOfThreads = std::thread::hardware_concurrency());
+
+  ~JobPool();
+
+  JobPool(const JobPool&) = delete;
+  JobPool& operator=(const JobPool&) = delete;
+
+  void submit(std::function<void()> job);
+
+  //! block until all submitted jobs have been run
+  void waitForAll();
+
+  size_t noOfThreads() const { return _threads.size(); }
+
+private:
+  struct Queue {
+    std::mutex mutex;
+    std::deque<std::function<void()>> jobs;
+  };
+
+  bool tryPop(size_t threadIndex, std::function<void()>& job);
+
+  bool trySteal(size_t threadIndex, std::function<void()>& job);
+
+  void work(size_t threadIndex);
+
+  std::vector<std::unique_ptr<Queue>> _queues;
+  std::vector<std::thread> _threads;
+
+  std::mutex _mutex;
+  std::condition_variable _jobAvailable;
+  std::condition_variable _allDone;
+  std::atomic<size_t> _nextQueue{0};
+  size_t _queuedJobs{0}; //!< jobs waiting in a queue, guarded by _mutex
+  size_t _unfinishedJobs{0}; //!< jobs queued or running, guarded by _mutex
+  bool _stop{false};
+};
+
+} // namespace monica
@@ -0,0 +1,312 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+* License, v. 2.0. If a copy of the MPL was not distributed with this
+* file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+/*
+Authors:
+Michael Berg <michael.berg@zalf.de>
+
+Maintainers:
+Currently maintained by the authors.
+
+This file is part of the MONICA model.
+Copyright (C) Leibniz Centre for Agricultural Landscape Research (ZALF)
+*/
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <string>
+#include <vector>
+
+#include "json11/json11.hpp"
+#include "json11/json11-helper.h"
+
+#include "tools/helper.h"
+#include "tools/debug.h"
+#include "run-monica.h"
+#include "create-env-from-json-config.h"
+#include "pwp-fc-sat-functions.h"
+#include "../core/allocation-counter.h"
+#include "../core/step-timer.h"
+#include "../io/build-output.h"
+#include "resource/version.h"
+
+using namespace std;
+using namespace monica;
+using namespace Tools;
+using namespace json11;
+
+string appName = "monica-bench";
+string version = VER_FILE_VERSION_STR;
+
+#ifndef MONICA_BENCH_DEFAULT_SIM_JSON
+#define MONICA_BENCH_DEFAULT_SIM_JSON "./sim.json"
+#endif
+
+namespace {
+
+uint64_t nsSince(chrono::steady_clock::time_point start) {
+  return uint64_t(chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - start).count());
+}
+
+//! time and allocations of one part of the benchmark, averaged over the measured repeats
+struct Measurement {
+  uint64_t sumNs{0};
+  size_t sumAllocations{0};
+  uint64_t bestNs{numeric_limits<uint64_t>::max()};
+  size_t noOfRepeats{0};
+
+  void add(uint64_t ns, size_t allocations) {
+    sumNs += ns;
+    sumAllocations += allocations;
+    bestNs = min(bestNs, ns);
+    noOfRepeats++;
+  }
+
+  double avgAllocations() const { return noOfRepeats > 0 ? double(sumAllocations) / noOfRepeats : 0.0; }
+
+  Json to_json(double perNo, const string& per) const {
+    auto n = double(max(noOfRepeats, size_t(1))) * perNo;
+    return J11Object{{"ns/" + per, double(sumNs) / n}, {"best-ns/" + per, double(bestNs) / perNo},
+                     {"allocations/" + per, double(sumAllocations) / n}};
+  }
+};
+
+struct BenchResult {
+  bool hourlyFvCB{false};
+  size_t noOfDays{0};
+  Measurement envMerge;
+  Measurement run;
+  Measurement kernels[_NO_OF_STEP_KERNELS_];
+  vector<double> stepAllocationsPerDay; //!< of the model's step on every day, only if checked
+
+  //! allocations of the model's step on the median day, which is a day without sowing, harvest and the like
+  double medianStepAllocations() const {
+    if (stepAllocationsPerDay.empty()) return 0;
+    auto as = stepAllocationsPerDay;
+    auto mid = as.begin() + as.size() / 2;
+    nth_element(as.begin(), mid, as.end());
+    return *mid;
+  }
+
+  //! forget the warm-up runs, keeps the configuration
+  void resetMeasurements() {
+    envMerge = run = Measurement();
+    for (auto& k : kernels) k = Measurement();
+  }
+
+  Json to_json() const {
+    J11Object ks;
+    for (int k = 0; k < _NO_OF_STEP_KERNELS_; k++) {
+      ks[stepKernelName(StepKernel(k))] = kernels[k].to_json(double(noOfDays), "day");
+    }
+    J11Object res
+      {{"__enable_hourly_FvCB_photosynthesis__", hourlyFvCB}
+      ,{"days", int(noOfDays)}
+      ,{"repeats", int(run.noOfRepeats)}
+      ,{"Env::merge", envMerge.to_json(1, "call")}
+      ,{"run", run.to_json(double(noOfDays), "day")}
+      ,{"kernels", ks}
+      };
+    if (!stepAllocationsPerDay.empty()) {
+      auto daysWithAllocations = count_if(stepAllocationsPerDay.begin(), stepAllocationsPerDay.end(),
+                                          [](double a) { return a > 0; });
+      res["step-allocations"] = J11Object
+        {{"median/day", medianStepAllocations()}
+        ,{"max/day", *max_element(stepAllocationsPerDay.begin(), stepAllocationsPerDay.end())}
+        ,{"days-with-allocations", int(daysWithAllocations)}
+        };
+    }
+    return res;
+  }
+};
+
+//! check the merged env and set what the benchmark runs need
+bool finishEnv(const Errors& mergeResult, bool hourlyFvCB, Env& env) {
+  printPossibleErrors(mergeResult, true);
+  if (mergeResult.failure()) return false;
+  if (!env.climateData.isValid()) {
+    cerr << "Error: no valid climate data." << endl;
+    return false;
+  }
+
+  env.params.userCropParameters.__enable_hourly_FvCB_photosynthesis__ = hourlyFvCB;
+  env.params.userSoilMoistureParameters.getCapillaryRiseRate =
+    [](const string& soilTexture, size_t distance) {
+      return Soil::readCapillaryRiseRates().getRate(soilTexture, distance);
+    };
+  return true;
+}
+
+//! merge a fresh Env and run it while timing the step kernels
+bool benchRun(const Json& envJson, const PwpFcSatFunctions& pwpFcSatFunctions, BenchResult& res) {
+  Env env;
+  env.params.siteParameters.calculateAndSetPwpFcSatFunctions = pwpFcSatFunctions;
+
+  auto allocations = threadAllocationCount();
+  auto start = chrono::steady_clock::now();
+  auto mergeResult = env.merge(envJson);
+  res.envMerge.add(nsSince(start), threadAllocationCount() - allocations);
+  if (!finishEnv(mergeResult, res.hourlyFvCB, env)) return false;
+  res.noOfDays = env.climateData.noOfStepsPossible();
+
+  // fresh counters for every run
+  StepKernelTimes times;
+  setThreadStepKernelTimes(&times);
+  allocations = threadAllocationCount();
+  start = chrono::steady_clock::now();
+  auto output = runMonica(kj::mv(env));
+  res.run.add(nsSince(start), threadAllocationCount() - allocations);
+  setThreadStepKernelTimes(nullptr);
+
+  for (int k = 0; k < _NO_OF_STEP_KERNELS_; k++) res.kernels[k].add(times.ns[k], times.allocations[k]);
+
+  for (const auto& e : output.errors) cerr << e << endl;
+  return output.errors.empty();
+}
+
+//! run once more, with the stepAllocations output of every day as the only output
+bool collectStepAllocations(const Json& envJson, const PwpFcSatFunctions& pwpFcSatFunctions, BenchResult& res) {
+  Env env;
+  env.params.siteParameters.calculateAndSetPwpFcSatFunctions = pwpFcSatFunctions;
+  if (!finishEnv(env.merge(envJson), res.hourlyFvCB, env)) return false;
+  env.events = J11Array{"daily", J11Array{"stepAllocations"}};
+  auto outputs = env.outputs.object_items();
+  outputs["obj-outputs?"] = false;
+  env.outputs = outputs;
+
+  auto output = runMonica(kj::mv(env));
+  for (const auto& e : output.errors) cerr << e << endl;
+  if (!output.errors.empty()) return false;
+  if (output.data.empty() || output.data.front().results.empty()) {
+    cerr << "Error: no stepAllocations output." << endl;
+    return false;
+  }
+
+  const auto& column = output.data.front().results.front();
+  res.stepAllocationsPerDay.clear();
+  for (size_t row = 0; row < column.size(); row++) res.stepAllocationsPerDay.push_back(column.at(row).number_value());
+  return true;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+  setlocale(LC_ALL, "");
+  setlocale(LC_NUMERIC, "C");
+
+  string pathToSimJson = MONICA_BENCH_DEFAULT_SIM_JSON;
+  string pathToOutputFile;
+  size_t noOfRepeats = 3;
+  size_t noOfWarmUpRuns = 1;
+  double maxAllocationsPerDay = -1;
+
+  auto printHelp = [=]() {
+    cout
+      << appName << " [options] [path-to-sim-json]" << endl
+      << endl
+      << "runs the simulation of sim.json (default: " << MONICA_BENCH_DEFAULT_SIM_JSON << ")" << endl
+      << "with and without hourly FvCB photosynthesis and outputs as json the time and heap allocations" << endl
+      << "per simulated day of the daily step kernels (the average of the repeats after the warm-up runs)" << endl
+      << "the kernels can't be timed if built with the cmake option MONICA_STEP_TIMERS=OFF" << endl
+      << "and the allocations are only counted if built with the cmake option MONICA_COUNT_ALLOCATIONS" << endl
+      << endl
+      << "options:" << endl
+      << endl
+      << " -h   | --help ... this help output" << endl
+      << " -v   | --version ... outputs " << appName << " version" << endl
+      << endl
+      << " -r   | --repeats N (default: 3) ... number of measured runs per configuration" << endl
+      << " -w   | --warm-up-runs N (default: 1) ... number of runs per configuration before measuring" << endl
+      << " -o   | --path-to-output-file FILE (default: stdout) ... write the json to FILE" << endl
+      << " -ma  | --max-allocations-per-day N ... fail if the model's step (without storing the results) allocates" << endl
+      << "        more than N times on a steady state day, which is the median of the days" << endl;
+  };
+
+  for (auto i = 1; i < argc; i++) {
+    string arg = argv[i];
+    if ((arg == "-r" || arg == "--repeats") && i + 1 < argc) noOfRepeats = max(size_t(1), size_t(stoul(argv[++i])));
+    else if ((arg == "-w" || arg == "--warm-up-runs") && i + 1 < argc) noOfWarmUpRuns = stoul(argv[++i]);
+    else if ((arg == "-o" || arg == "--path-to-output-file") && i + 1 < argc) pathToOutputFile = argv[++i];
+    else if ((arg == "-ma" || arg == "--max-allocations-per-day") && i + 1 < argc) maxAllocationsPerDay = stod(argv[++i]);
+    else if (arg == "-h" || arg == "--help") printHelp(), exit(0);
+    else if (arg == "-v" || arg == "--version") cout << appName << " version " << version << endl, exit(0);
+    else pathToSimJson = argv[i];
+  }
+
+  activateDebug = false;
+
+  if (!stepKernelTimersCompiled()) {
+    cerr << "Error: the step kernel timers are compiled out (cmake option MONICA_STEP_TIMERS=OFF), "
+            "no kernel times to report." << endl;
+    return 1;
+  }
+
+  // build the shared lookups before anything is timed
+  buildOutputTable();
+  Soil::readCapillaryRiseRates();
+  const auto& pwpFcSatFunctions = monica::pwpFcSatFunctions();
+
+  auto envJson = createEnvJsonFromSimJsonFile(pathToSimJson);
+  if (envJson.is_null()) return 1;
+
+  vector<BenchResult> results(2);
+  results[1].hourlyFvCB = true;
+  for (auto& res : results) {
+    // the warm-up runs fill the caches (e.g. climate data, pwp/fc/sat memo) and are not measured
+    for (size_t r = 0; r < noOfWarmUpRuns; r++) {
+      if (!benchRun(envJson, pwpFcSatFunctions, res)) return 1;
+    }
+    res.resetMeasurements();
+    for (size_t r = 0; r < noOfRepeats; r++) {
+      if (!benchRun(envJson, pwpFcSatFunctions, res)) return 1;
+    }
+    if (maxAllocationsPerDay >= 0 && allocationsCounted()) {
+      if (!collectStepAllocations(envJson, pwpFcSatFunctions, res)) return 1;
+    }
+  }
+
+  J11Array rs;
+  for (const auto& res : results) rs.push_back(res.to_json());
+  Json bench = J11Object
+    {{"type", "monica-bench"}
+    ,{"version", version}
+    ,{"sim.json", pathToSimJson}
+    ,{"warm-up-runs", int(noOfWarmUpRuns)}
+    ,{"repeats", int(noOfRepeats)}
+    ,{"kernelsTimed", stepKernelTimersCompiled()}
+    ,{"allocationsCounted", allocationsCounted()}
+    ,{"runs", rs}
+    };
+
+  if (pathToOutputFile.empty()) cout << bench.dump() << endl;
+  else {
+    ofstream out(pathToOutputFile);
+    if (out.fail()) {
+      cerr << "Error while opening output file \"" << pathToOutputFile << "\"" << endl;
+      return 1;
+    }
+    out << bench.dump() << endl;
+  }
+
+  if (maxAllocationsPerDay >= 0) {
+    if (!allocationsCounted()) {
+      cerr << "Error: checking the allocations per day needs a build with MONICA_COUNT_ALLOCATIONS." << endl;
+      return 1;
+    }
+    for (const auto& res : results) {
+      if (res.medianStepAllocations() > maxAllocationsPerDay) {
+        cerr << "Error: " << res.medianStepAllocations() << " allocations on a steady state day (hourly FvCB "
+             << "photosynthesis: " << (res.hourlyFvCB ? "on" : "off") << ") exceed the maximum of "
+             << maxAllocationsPerDay << "." << endl;
+        return 1;
+      }
+    }
+  }
+
+  return 0;
+}
@@ -13,7 +13,9 @@ This file is part of the MONICA model.
 Copyright (C) Leibniz Centre for Agricultural Landscape Research (ZALF)
 */
 
+#include <algorithm>
 #include <iostream>
+#include <thread>
 
 #include <kj/common.h>
 #include <kj/debug.h>
@@ -42,6 +44,7 @@ public:
 
   kj::MainBuilder::Validity setDebug() { startedServerInDebugMode = true; return true; }
   kj::MainBuilder::Validity setSRT(kj::StringPtr name) { srt = kj::str(name); return true; }
+  kj::MainBuilder::Validity setWorkers(kj::StringPtr no) { noOfWorkers = std::max(1ul, no.parseAs<unsigned long>()); return true; }
 
   kj::MainBuilder::Validity startService()
   {
@@ -49,7 +52,7 @@ public:
 
     KJ_LOG(INFO, "Starting Cap'n Proto MONICA service");
 
-      auto ownedRunMonica = kj::heap<RunMonica>(startedServerInDebugMode);
+      auto ownedRunMonica = kj::heap<RunMonica>(startedServerInDebugMode, nullptr, noOfWorkers);
       auto runMonica = ownedRunMonica.get();
       if (name.size() > 0) runMonica->setName(name);
       MonicaEnvInstance::Client runMonicaClient = kj::mv(ownedRunMonica);
@@ -75,6 +78,8 @@ public:
       .addOption({'d', "debug"}, KJ_BIND_METHOD(*this, setDebug), "Activate debug output.")
       .addOptionWithArg({'t', "srt"}, KJ_BIND_METHOD(*this, setSRT),
                           "<sturdy-ref token>", "Set a fixed sturdy ref token.")
+      .addOptionWithArg({"workers"}, KJ_BIND_METHOD(*this, setWorkers),
+                          "<number>", "Run MONICA on this many worker threads (default: number of cores).")
       .callAfterParsing(KJ_BIND_METHOD(*this, startService))
       .build();
   }
@@ -82,6 +87,7 @@ public:
 private:
   bool startedServerInDebugMode{false};
   kj::String srt;
+  size_t noOfWorkers{std::max(1u, std::thread::hardware_concurrency())};
 };
 
 }
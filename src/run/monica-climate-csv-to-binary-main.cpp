@@ -0,0 +1,119 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+* License, v. 2.0. If a copy of the MPL was not distributed with this
+* file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+/*
+Authors:
+Michael Berg <michael.berg@zalf.de>
+
+Maintainers:
+Currently maintained by the authors.
+
+This file is part of the MONICA model.
+Copyright (C) Leibniz Centre for Agricultural Landscape Research (ZALF)
+*/
+
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+#include "json11/json11.hpp"
+#include "json11/json11-helper.h"
+
+#include "tools/helper.h"
+#include "../io/climate-binary.h"
+#include "../io/climate-csv-reader.h"
+#include "../io/climate-io-helper.h"
+#include "resource/version.h"
+
+using namespace std;
+using namespace monica;
+using namespace Tools;
+using namespace json11;
+
+string appName = "monica-climate-csv-to-binary";
+string version = VER_FILE_VERSION_STR;
+
+int main(int argc, char** argv) {
+  string pathToSimJson, pathToCSV, pathToBinary;
+  string separator, noOfHeaderLines;
+  bool asFloat32 = false;
+
+  auto printHelp = [=]() {
+    cout
+      << appName << " [options] path-to-climate-csv path-to-binary-file" << endl
+      << endl
+      << "converts a climate csv file into a binary climate file, which MONICA reads instead of the csv file" << endl
+      << "e.g. as climate.csv in sim.json, the csv file needs a date column and one row per day without gaps" << endl
+      << endl
+      << "options:" << endl
+      << endl
+      << " -h   | --help ... this help output" << endl
+      << " -v   | --version ... outputs " << appName << " version" << endl
+      << endl
+      << " -sj  | --sim-json FILE ... use the climate.csv-options of FILE (start-date and end-date are ignored)" << endl
+      << " -s   | --csv-separator SEPARATOR (default: ,) ... the separator of the csv file" << endl
+      << " -hl  | --header-lines N (default: 1) ... number of header lines of the csv file" << endl
+      << " -f32 | --float32 ... store the values as float32 instead of float64" << endl;
+  };
+
+  for (auto i = 1; i < argc; i++) {
+    string arg = argv[i];
+    if ((arg == "-sj" || arg == "--sim-json") && i + 1 < argc) pathToSimJson = argv[++i];
+    else if ((arg == "-s" || arg == "--csv-separator") && i + 1 < argc) separator = argv[++i];
+    else if ((arg == "-hl" || arg == "--header-lines") && i + 1 < argc) noOfHeaderLines = argv[++i];
+    else if (arg == "-f32" || arg == "--float32") asFloat32 = true;
+    else if (arg == "-h" || arg == "--help") printHelp(), exit(0);
+    else if (arg == "-v" || arg == "--version") cout << appName << " version " << version << endl, exit(0);
+    else if (pathToCSV.empty()) pathToCSV = arg;
+    else pathToBinary = arg;
+  }
+  if (pathToCSV.empty() || pathToBinary.empty()) {
+    printHelp();
+    return 1;
+  }
+
+  J11Object options;
+  if (!pathToSimJson.empty()) {
+    auto simj = readAndParseJsonFile(pathToSimJson);
+    if (simj.failure()) {
+      for (const auto& e : simj.errors) cerr << e << endl;
+      return 1;
+    }
+    options = simj.result["climate.csv-options"].object_items();
+  }
+  // the whole file is converted
+  options.erase("start-date");
+  options.erase("end-date");
+  if (!separator.empty()) options["csv-separator"] = separator;
+  else if (!options["csv-separator"].is_string()) options["csv-separator"] = ",";
+  if (!noOfHeaderLines.empty()) options["no-of-climate-file-header-lines"] = stoi(noOfHeaderLines);
+  else if (!options["no-of-climate-file-header-lines"].is_number()) options["no-of-climate-file-header-lines"] = 1;
+
+  ClimateCSVOptions csvOptions;
+  if (!toClimateCSVOptions(options, csvOptions)) {
+    cerr << "Error: unsupported csv options: " << Json(options).dump() << endl;
+    return 1;
+  }
+
+  MappedFile file(pathToCSV);
+  if (!file.isOpen()) {
+    cerr << "Error: couldn't open climate csv file: '" << pathToCSV << "'." << endl;
+    return 1;
+  }
+  ClimateCSVData data;
+  if (!parseClimateCSV(file.begin(), file.end(), csvOptions, data)) {
+    cerr << "Error: couldn't convert '" << pathToCSV << "', it needs a date column (iso-date or de-date), "
+         << "one row per day without gaps and numbers in all climate element columns." << endl;
+    return 1;
+  }
+
+  auto res = writeClimateBinaryFile(pathToBinary, data, asFloat32);
+  if (res.failure()) {
+    for (const auto& e : res.errors) cerr << e << endl;
+    return 1;
+  }
+  cout << "wrote " << data.columns.front().size() << " days of " << data.acdNames.size() << " climate elements to '"
+       << pathToBinary << "'" << endl;
+  return 0;
+}
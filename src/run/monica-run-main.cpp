@@ -18,6 +18,9 @@ Copyright (C) Leibniz Centre for Agricultural Landscape Research (ZALF)
 #include <fstream>
 #include <string>
 #include <tuple>
+#include <atomic>
+#include <memory>
+#include <thread>
 
 #include <kj/async-io.h>
 
@@ -30,9 +33,14 @@ Copyright (C) Leibniz Centre for Agricultural Landscape Research (ZALF)
 #include "run-monica.h"
 #include "create-env-from-json-config.h"
 #include "../io/csv-format.h"
+#include "../io/result-sink.h"
 #include "common/rpc-connection-manager.h"
 #include "capnp-helper.h"
+#include "job-pool.h"
+#include "../io/build-output.h"
 #include "climate/climate-file-io.h"
+#include "climate-data-cache.h"
+#include "pwp-fc-sat-functions.h"
 #include "resource/version.h"
 
 #include "climate.capnp.h"
@@ -46,6 +54,240 @@ using namespace json11;
 string appName = "monica-run";
 string version = VER_FILE_VERSION_STR;
 
+namespace {
+
+//! one line of a batch manifest: sim.json[,crop.json[,site.json[,climate.csv[,output.csv]]]]
+struct BatchJob {
+  string pathToSimJson;
+  string pathToCropJson;
+  string pathToSiteJson;
+  string pathToClimateCSV;
+  string pathToOutputFile;
+};
+
+vector<BatchJob> readBatchManifest(const string& pathToManifest) {
+  vector<BatchJob> jobs;
+  ifstream ifs(pathToManifest);
+  if (!ifs.good()) {
+    cerr << "Error: couldn't open batch manifest: '" << pathToManifest << "'." << endl;
+    return jobs;
+  }
+
+  string line;
+  while (getline(ifs, line)) {
+    if (!line.empty() && line.back() == '\r') line.pop_back();
+    auto firstNonSpace = line.find_first_not_of(" \t");
+    if (firstNonSpace == string::npos || line[firstNonSpace] == '#') continue;
+
+    // keep empty fields, they mean: use what sim.json says
+    vector<string> fields;
+    size_t start = 0;
+    while (true) {
+      auto end = line.find(',', start);
+      auto field = line.substr(start, end == string::npos ? string::npos : end - start);
+      auto b = field.find_first_not_of(" \t");
+      auto e = field.find_last_not_of(" \t");
+      fields.push_back(b == string::npos ? string() : field.substr(b, e - b + 1));
+      if (end == string::npos) break;
+      start = end + 1;
+    }
+    fields.resize(5);
+    jobs.push_back({fields[0], fields[1], fields[2], fields[3], fields[4]});
+  }
+  return jobs;
+}
+
+void writeOutputAsCSV(ostream& out, const Output& output, const Json& csvOptions, bool returnObjOutputs) {
+  string csvSep = csvOptions["csv-separator"].string_value();
+  bool includeHeaderRow = csvOptions["include-header-row"].bool_value();
+  bool includeUnitsRow = csvOptions["include-units-row"].bool_value();
+  bool includeAggRows = csvOptions["include-aggregation-rows"].bool_value();
+
+  for (const auto& d : output.data) {
+    out << "\"" << replace(d.origSpec, "\"", "") << "\"" << endl;
+    writeOutputHeaderRows(out, d.outputIds, csvSep, includeHeaderRow, includeUnitsRow, includeAggRows);
+    if (returnObjOutputs) writeOutputObj(out, d.outputIds, d.resultsObj, csvSep);
+    else writeOutput(out, d.outputIds, d.results, csvSep);
+    out << endl;
+  }
+}
+
+//! a batch job with its env read, ready to run
+struct PreparedJob {
+  size_t jobNo{0};
+  Env env;
+  Json csvOptions;
+  string pathToOutputFile;
+  bool isIC{false};
+  bool returnObjOutputs{false};
+};
+
+//! read everything a job needs, besides the shared lookups everything is local to the job
+bool prepareBatchJob(const BatchJob& job,
+                     size_t jobNo,
+                     const PwpFcSatFunctions& pwpFcSatFunctions,
+                     const string& pathToOutputDir,
+                     PreparedJob& pj) {
+  string pathOfSimJson, simFileName;
+  tie(pathOfSimJson, simFileName) = splitPathToFile(job.pathToSimJson);
+
+  auto simj = readAndParseJsonFile(job.pathToSimJson);
+  if (simj.failure()) {
+    for (const auto& e : simj.errors) cerr << "job " << jobNo << ": " << e << endl;
+    return false;
+  }
+  auto simm = simj.result.object_items();
+  simm["sim.json"] = job.pathToSimJson;
+
+  auto makeAbsolute = [&](const string& path) {
+    return path.find("capnp://") == 0 || isAbsolutePath(path) ? path : pathOfSimJson + path;
+  };
+
+  if (!job.pathToCropJson.empty()) simm["crop.json"] = job.pathToCropJson;
+  simm["crop.json"] = makeAbsolute(simm["crop.json"].string_value());
+  if (!job.pathToSiteJson.empty()) simm["site.json"] = job.pathToSiteJson;
+  simm["site.json"] = makeAbsolute(simm["site.json"].string_value());
+  if (!job.pathToClimateCSV.empty()) simm["climate.csv"] = job.pathToClimateCSV;
+  if (simm["climate.csv"].is_string()) simm["climate.csv"] = makeAbsolute(simm["climate.csv"].string_value());
+  else if (simm["climate.csv"].is_array()) {
+    vector<string> ps;
+    for (const auto& j : simm["climate.csv"].array_items()) ps.push_back(makeAbsolute(j.string_value()));
+    simm["climate.csv"] = toPrimJsonArray(ps);
+  }
+
+  map<string, Json> ps;
+  ps["sim"] = json11::Json(simm);
+  ps["crop"] = printPossibleErrors(parseJsonString(printPossibleErrors(readFile(simm["crop.json"].string_value()),
+                                                                       activateDebug)), activateDebug);
+  ps["site"] = printPossibleErrors(parseJsonString(printPossibleErrors(readFile(simm["site.json"].string_value()),
+                                                                       activateDebug)), activateDebug);
+
+  // sturdy refs need the connection manager of the main thread, which can't be shared with the workers
+  if (ps["site"]["SiteParameters"]["SoilProfileParameters"].is_string()) {
+    cerr << "job " << jobNo << ": Error: soil profile sturdy refs are not supported in batch mode." << endl;
+    return false;
+  }
+
+  auto& env = pj.env;
+  env.params.siteParameters.calculateAndSetPwpFcSatFunctions = pwpFcSatFunctions;
+
+  auto mergeResult = updateEnvFromJsonObjects(env, ps);
+  printPossibleErrors(mergeResult, activateDebug);
+  if (mergeResult.failure()) return false;
+
+  for (const auto& sr : env.pathsToClimateCSV) {
+    if (sr.find("capnp://") == 0) {
+      cerr << "job " << jobNo << ": Error: time series sturdy refs are not supported in batch mode." << endl;
+      return false;
+    }
+  }
+  if (!env.climateData.isValid()) {
+    cerr << "job " << jobNo << ": Error: no valid climate data for '" << job.pathToSimJson << "'." << endl;
+    return false;
+  }
+
+  env.params.userSoilMoistureParameters.getCapillaryRiseRate =
+    [](const string& soilTexture, size_t distance) {
+      return Soil::readCapillaryRiseRates().getRate(soilTexture, distance);
+    };
+
+  pj.jobNo = jobNo;
+  pj.isIC = env.params.userCropParameters.isIntercropping;
+  pj.returnObjOutputs = env.returnObjOutputs();
+  pj.csvOptions = simm["output"]["csv-options"];
+
+  // output of concurrent jobs can't go to stdout, so there is always a file
+  pj.pathToOutputFile = job.pathToOutputFile;
+  if (pj.pathToOutputFile.empty()) {
+    string fileName = simm["output"]["file-name"].string_value();
+    auto k = simFileName.find_last_of('.');
+    auto simName = k == string::npos ? simFileName : simFileName.substr(0, k);
+    if (fileName.empty()) fileName = simName + ".csv";
+    auto l = fileName.find_last_of('.');
+    pj.pathToOutputFile = fixSystemSeparator(pathToOutputDir + "/" + (l == string::npos ? fileName : fileName.substr(0, l))
+                                             + "_job_" + to_string(jobNo) + ".csv");
+  }
+
+  return true;
+}
+
+bool writeBatchJobOutput(const PreparedJob& pj, const Output& output, const Output& output2) {
+  string path, filename;
+  tie(path, filename) = splitPathToFile(pj.pathToOutputFile);
+  if (!path.empty() && !ensureDirExists(path)) {
+    cerr << "job " << pj.jobNo << ": Error failed to create path: '" << path << "'." << endl;
+    return false;
+  }
+  ofstream fout(pj.pathToOutputFile);
+  if (fout.fail()) {
+    cerr << "job " << pj.jobNo << ": Error while opening output file \"" << pj.pathToOutputFile << "\"" << endl;
+    return false;
+  }
+  writeOutputAsCSV(fout, output, pj.csvOptions, pj.returnObjOutputs);
+  if (pj.isIC) writeOutputAsCSV(fout, output2, pj.csvOptions, pj.returnObjOutputs);
+  fout.close();
+
+  for (const auto& e : output.errors) cerr << "job " << pj.jobNo << ": " << e << endl;
+  return output.errors.empty();
+}
+
+//! run a single job of a batch
+bool runBatchJob(const BatchJob& job,
+                 size_t jobNo,
+                 const PwpFcSatFunctions& pwpFcSatFunctions,
+                 const string& pathToOutputDir) {
+  PreparedJob pj;
+  if (!prepareBatchJob(job, jobNo, pwpFcSatFunctions, pathToOutputDir, pj)) return false;
+
+  Output output, output2;
+  tie(output, output2) = runMonicaIC(kj::mv(pj.env), pj.isIC);
+  return writeBatchJobOutput(pj, output, output2);
+}
+
+int runBatch(const string& pathToManifest, size_t noOfThreads, string pathToOutputDir) {
+  auto jobs = readBatchManifest(pathToManifest);
+  if (jobs.empty()) {
+    cerr << "Error: no jobs found in batch manifest: '" << pathToManifest << "'." << endl;
+    return 1;
+  }
+  if (pathToOutputDir.empty()) pathToOutputDir = ".";
+
+  // build the shared read only lookups once, before any worker touches them
+  buildOutputTable();
+  Soil::readCapillaryRiseRates();
+  const auto& pwpFcSatFunctions = monica::pwpFcSatFunctions();
+
+  atomic<size_t> noOfFailedJobs{0};
+  {
+    JobPool pool(noOfThreads);
+    if (activateDebug) {
+      cout << "running " << jobs.size() << " jobs on " << pool.noOfThreads() << " threads" << endl;
+    }
+    for (size_t i = 0; i < jobs.size(); i++) {
+      pool.submit([&, i] {
+        try {
+          if (!runBatchJob(jobs[i], i, pwpFcSatFunctions, pathToOutputDir)) noOfFailedJobs++;
+        } catch (const exception& e) {
+          cerr << "job " << i << ": Error while running MONICA: " << e.what() << endl;
+          noOfFailedJobs++;
+        } catch (...) {
+          cerr << "job " << i << ": Unknown error while running MONICA!" << endl;
+          noOfFailedJobs++;
+        }
+      });
+    }
+    pool.waitForAll();
+  }
+
+  if (noOfFailedJobs > 0) {
+    cerr << noOfFailedJobs << " of " << jobs.size() << " jobs failed." << endl;
+    return 1;
+  }
+  return 0;
+}
+
+} // namespace
+
 int main(int argc, char** argv) {
   setlocale(LC_ALL, "");
   setlocale(LC_NUMERIC, "C");
@@ -62,6 +304,9 @@ int main(int argc, char** argv) {
   string pathToSimJson = "./sim.json", crop, site, climate;
   string icReaderSr;
   string icWriterSr;
+  string pathToBatchManifest;
+  string pathToStreamOutput;
+  size_t noOfThreads = std::thread::hardware_concurrency();
 
   auto printHelp = [=]() {
     cout
@@ -82,7 +327,17 @@ int main(int argc, char** argv) {
       << " -o   | --path-to-output-file FILE ... path to output file" << endl
       << " -c   | --path-to-crop FILE (default: ./crop.json) ... path to crop.json file" << endl
       << " -s   | --path-to-site FILE (default: ./site.json) ... path to site.json file" << endl
-      << " -w   | --path-to-climate FILE (default: ./climate.csv) ... path to climate.csv" << endl;
+      << " -w   | --path-to-climate FILE (default: ./climate.csv) ... path to climate.csv" << endl
+      << " -so  | --stream-output FILE ... write the results while running, FILE.bin as binary file," << endl
+      << "        otherwise as one csv file per output section named like with --write-multiple-output-files" << endl
+      << endl
+      << " -b   | --batch MANIFEST ... run all jobs in MANIFEST, one job per line:" << endl
+      << "        path-to-sim-json[,path-to-crop-json[,path-to-site-json[,path-to-climate-csv[,path-to-output-file]]]]" << endl
+      << "        empty fields are taken from the sim.json, without output file the results go to the output directory"
+      << endl
+      << " -t   | --threads N (default: number of cores) ... number of threads running batch jobs" << endl
+      << " -cc  | --climate-cache-mb N (default: " << climateDataCacheCapacity() / (1024 * 1024) << ") ... max size of the"
+      << " climate csv files kept parsed for jobs sharing them, 0 disables the cache" << endl;
   };
 
   if (argc > 1) {
@@ -100,13 +355,25 @@ int main(int argc, char** argv) {
       else if ((arg == "-c" || arg == "--path-to-crop") && i + 1 < argc) crop = argv[++i];
       else if ((arg == "-s" || arg == "--path-to-site") && i + 1 < argc) site = argv[++i];
       else if ((arg == "-w" || arg == "--path-to-climate") && i + 1 < argc) climate = argv[++i];
+      else if ((arg == "-so" || arg == "--stream-output") && i + 1 < argc) pathToStreamOutput = argv[++i];
       else if (arg == "-h" || arg == "--help") printHelp(), exit(0);
       else if (arg == "-v" || arg == "--version") cout << appName << " version " << version << endl, exit(0);
       else if ((arg == "-icrsr" || arg == "--intercropping-reader-sr") && i + 1 < argc) icReaderSr = argv[++i];
       else if ((arg == "-icwsr" || arg == "--intercropping-writer-sr") && i + 1 < argc) icWriterSr = argv[++i];
+      else if ((arg == "-b" || arg == "--batch") && i + 1 < argc) pathToBatchManifest = argv[++i];
+      else if ((arg == "-t" || arg == "--threads") && i + 1 < argc) noOfThreads = stoul(argv[++i]);
+      else if ((arg == "-cc" || arg == "--climate-cache-mb") && i + 1 < argc) {
+        setClimateDataCacheCapacity(size_t(stoul(argv[++i])) * 1024 * 1024);
+      }
       else pathToSimJson = argv[i];
     }
 
+    if (!pathToBatchManifest.empty()) {
+      // the debug flag is process global, so batch jobs can't switch it individually
+      activateDebug = debug;
+      return runBatch(pathToBatchManifest, noOfThreads, pathToOutput);
+    }
+
     string pathOfSimJson, simFileName;
     tie(pathOfSimJson, simFileName) = splitPathToFile(pathToSimJson);
 
@@ -176,20 +443,10 @@ int main(int argc, char** argv) {
     Env env;
 
     // set available functions to calculate pwp, fc and sat before env creation
-    auto pathToSoilDir = fixSystemSeparator(replaceEnvVars("${MONICA_PARAMETERS}/soil/"));
-    env.params.siteParameters.calculateAndSetPwpFcSatFunctions["Wessolek2009"] =
-      Soil::getInitializedUpdateUnsetPwpFcSatfromKA5textureClassFunction(pathToSoilDir);
-    env.params.siteParameters.calculateAndSetPwpFcSatFunctions["VanGenuchten"] =
-      Soil::updateUnsetPwpFcSatFromVanGenuchtenVereecken;
-    env.params.siteParameters.calculateAndSetPwpFcSatFunctions["VanGenuchtenVereecken"] =
-      Soil::updateUnsetPwpFcSatFromVanGenuchtenVereecken;
-    env.params.siteParameters.calculateAndSetPwpFcSatFunctions["VanGenuchtenToth"] =
-      Soil::updateUnsetPwpFcSatFromVanGenuchtenToth;
-    env.params.siteParameters.calculateAndSetPwpFcSatFunctions["Toth"] = Soil::updateUnsetPwpFcSatFromToth;
-
+    env.params.siteParameters.calculateAndSetPwpFcSatFunctions = pwpFcSatFunctions();
 
     // merge the json objects into the env
-    auto mergeResult = env.merge(createEnvJsonFromJsonObjects(ps));
+    auto mergeResult = updateEnvFromJsonObjects(env, ps);
     printPossibleErrors(mergeResult, activateDebug);
     if (mergeResult.failure()) return 1;
 
@@ -236,7 +493,29 @@ int main(int argc, char** argv) {
     bool isAsyncIC = env.ic.isAsync();
     bool returnObjOutputs = env.returnObjOutputs();
     Output output, output2;
-    tie(output, output2) = runMonicaIC(kj::mv(env), isIC);
+
+    unique_ptr<ResultSink> sink;
+    if (!pathToStreamOutput.empty()) {
+      string path, filename;
+      tie(path, filename) = splitPathToFile(pathToStreamOutput);
+      if (!path.empty() && !ensureDirExists(path)) cerr << "Error failed to create path: '" << path << "'." << endl;
+      auto k = filename.find_last_of('.');
+      if (k != string::npos && filename.substr(k) == ".bin") {
+        sink = make_unique<BinaryFileResultSink>(pathToStreamOutput);
+      } else {
+        sink = make_unique<CsvFileResultSink>(path, filename.substr(0, k), simm["output"]["csv-options"]);
+      }
+    }
+
+    tie(output, output2) = runMonicaIC(kj::mv(env), isIC, sink.get());
+
+    if (sink) {
+      // the results have been written while running
+      for (const auto& e : output.errors) cerr << e << endl;
+      for (const auto& e : output2.errors) cerr << e << endl;
+      if (activateDebug) cout << "finished MONICA" << endl;
+      return 0;
+    }
 
     if (pathToOutputFile.empty() && simm["output"]["write-file?"].bool_value()) {
       pathToOutputDir = fixSystemSeparator(simm["output"]["path-to-output"].string_value());
@@ -316,19 +595,7 @@ int main(int argc, char** argv) {
       }
 
       ostream& out = writeOutputFile ? fout : cout;
-
-      string csvSep = simm["output"]["csv-options"]["csv-separator"].string_value();
-      bool includeHeaderRow = simm["output"]["csv-options"]["include-header-row"].bool_value();
-      bool includeUnitsRow = simm["output"]["csv-options"]["include-units-row"].bool_value();
-      bool includeAggRows = simm["output"]["csv-options"]["include-aggregation-rows"].bool_value();
-
-      for (const auto& d : output.data) {
-        out << "\"" << replace(d.origSpec, "\"", "") << "\"" << endl;
-        writeOutputHeaderRows(out, d.outputIds, csvSep, includeHeaderRow, includeUnitsRow, includeAggRows);
-        if (returnObjOutputs) writeOutputObj(out, d.outputIds, d.resultsObj, csvSep);
-        else writeOutput(out, d.outputIds, d.results, csvSep);
-        out << endl;
-      }
+      writeOutputAsCSV(out, output, simm["output"]["csv-options"], returnObjOutputs);
 
       if (writeOutputFile) fout.close();
     }
@@ -401,19 +668,7 @@ int main(int argc, char** argv) {
         }
 
         ostream& out = writeOutputFile2 ? fout : cout;
-
-        string csvSep = simm["output"]["csv-options"]["csv-separator"].string_value();
-        bool includeHeaderRow = simm["output"]["csv-options"]["include-header-row"].bool_value();
-        bool includeUnitsRow = simm["output"]["csv-options"]["include-units-row"].bool_value();
-        bool includeAggRows = simm["output"]["csv-options"]["include-aggregation-rows"].bool_value();
-
-        for (const auto& d : output2.data) {
-          out << "\"" << replace(d.origSpec, "\"", "") << "\"" << endl;
-          writeOutputHeaderRows(out, d.outputIds, csvSep, includeHeaderRow, includeUnitsRow, includeAggRows);
-          if (returnObjOutputs) writeOutputObj(out, d.outputIds, d.resultsObj, csvSep);
-          else writeOutput(out, d.outputIds, d.results, csvSep);
-          out << endl;
-        }
+        writeOutputAsCSV(out, output2, simm["output"]["csv-options"], returnObjOutputs);
 
         if (writeOutputFile2) fout.close();
       }
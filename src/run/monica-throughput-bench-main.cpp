@@ -0,0 +1,354 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+* License, v. 2.0. If a copy of the MPL was not distributed with this
+* file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+/*
+Authors:
+Michael Berg <michael.berg@zalf.de>
+
+Maintainers:
+Currently maintained by the authors.
+
+This file is part of the MONICA model.
+Copyright (C) Leibniz Centre for Agricultural Landscape Research (ZALF)
+*/
+
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <set>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <vector>
+
+#include "zeromq/zmq-helper.h"
+#include "json11/json11.hpp"
+#include "json11/json11-helper.h"
+
+#include "tools/helper.h"
+#include "tools/debug.h"
+#include "run-monica.h"
+#include "create-env-from-json-config.h"
+#include "pwp-fc-sat-functions.h"
+#include "serve-monica-zmq.h"
+#include "job-pool.h"
+#include "../io/build-output.h"
+#include "resource/version.h"
+
+using namespace std;
+using namespace monica;
+using namespace Tools;
+using namespace json11;
+
+string appName = "monica-throughput-bench";
+string version = VER_FILE_VERSION_STR;
+
+#ifndef MONICA_BENCH_FIXTURES_DIR
+#define MONICA_BENCH_FIXTURES_DIR "./"
+#endif
+
+namespace {
+
+//! a representative workload, a sim.json of the fixtures directory with possibly other outputs
+struct Scenario {
+  string name;
+  string simJson;
+  Json events; //!< replaces the events of the sim.json, if not null
+};
+
+vector<Scenario> createScenarios() {
+  Json perLayer = J11Array{1, 20};
+  return {
+    {"single-crop-daily", "sim-min.json", Json()},
+    {"rotation-monthly", "sim.json", J11Array
+      {"monthly", J11Array{"Year", "Month", J11Array{"SOC", J11Array{1, 3, "AVG"}},
+                           J11Array{"WaterContent", J11Array{1, 9, "AVG"}}, "Recharge", "NLeach",
+                           J11Array{"RunOff", "SUM"}, J11Array{"Precip", "SUM"}, "Act_ET"}
+      ,"yearly", J11Array{"Year", J11Array{"N", J11Array{1, 3}}, J11Array{"RunOff", "SUM"},
+                          J11Array{"NLeach", "SUM"}, J11Array{"Recharge", "SUM"}}
+      ,"crop", J11Array{"Crop", J11Array{"Yield", "LAST"}, J11Array{"Date|sowing", "FIRST"},
+                        J11Array{"Date|harvest", "LAST"}}
+      }},
+    {"intercropping", "sim-min-ic.json", Json()},
+    {"per-layer-daily", "sim.json", J11Array
+      {"daily", J11Array{"Date", "Crop", J11Array{"Mois", perLayer}, J11Array{"STemp", perLayer},
+                         J11Array{"SOC", perLayer}, J11Array{"NO3", perLayer}, J11Array{"NH4", perLayer},
+                         J11Array{"Carb", perLayer}, J11Array{"SOMs", perLayer}, J11Array{"AOMf", perLayer}}
+      }}
+  };
+}
+
+struct Workload {
+  Json envJson;
+  bool isIC{false};
+  size_t noOfDays{0};
+};
+
+//! merge an Env from the workload's json, ready to run
+bool createEnv(const Workload& wl, const PwpFcSatFunctions& pwpFcSatFunctions, Env& env) {
+  env.params.siteParameters.calculateAndSetPwpFcSatFunctions = pwpFcSatFunctions;
+  auto mergeResult = env.merge(wl.envJson);
+  printPossibleErrors(mergeResult, true);
+  if (mergeResult.failure() || !env.climateData.isValid()) return false;
+  env.params.userSoilMoistureParameters.getCapillaryRiseRate =
+    [](const string& soilTexture, size_t distance) {
+      return Soil::readCapillaryRiseRates().getRate(soilTexture, distance);
+    };
+  return true;
+}
+
+//! merge the Env and run MONICA as a caller of the library would
+bool runWorkload(const Workload& wl, const PwpFcSatFunctions& pwpFcSatFunctions) {
+  Env env;
+  if (!createEnv(wl, pwpFcSatFunctions, env)) return false;
+  Output out, out2;
+  tie(out, out2) = runMonicaIC(kj::mv(env), wl.isIC);
+  for (const auto& e : out.errors) cerr << e << endl;
+  return out.errors.empty();
+}
+
+//! run noOfRuns times the workload on noOfThreads threads (0 = on the calling thread)
+bool runOnThreads(const Workload& wl, const PwpFcSatFunctions& pwpFcSatFunctions, size_t noOfThreads, size_t noOfRuns) {
+  if (noOfThreads == 0) {
+    for (size_t r = 0; r < noOfRuns; r++) if (!runWorkload(wl, pwpFcSatFunctions)) return false;
+    return true;
+  }
+
+  atomic<size_t> noOfFailedRuns{0};
+  JobPool pool(noOfThreads);
+  for (size_t r = 0; r < noOfRuns; r++) {
+    pool.submit([&] {
+      try {
+        if (!runWorkload(wl, pwpFcSatFunctions)) noOfFailedRuns++;
+      } catch (const exception& e) {
+        cerr << "Error while running MONICA: " << e.what() << endl;
+        noOfFailedRuns++;
+      }
+    });
+  }
+  pool.waitForAll();
+  return noOfFailedRuns == 0;
+}
+
+//! run noOfRuns times the workload through a MONICA zmq server with noOfWorkers workers in the same process
+bool runViaZmqInproc(const Workload& wl, size_t noOfWorkers, size_t noOfRuns) {
+  const string address = "inproc://monica-throughput-bench";
+  zmq::context_t context(1);
+  map<SocketRole, SocketConfig> socketAddresses{{ReceiveJob, {Reply, {address}, bind}}};
+  thread server(serveZmqMonicaFull, &context, socketAddresses, noOfWorkers);
+
+  // a dealer socket can have all requests in flight, the server's router socket talks the reply protocol
+  zmq::socket_t client(context, ZMQ_DEALER);
+  client.connect(address.c_str());
+  auto msg = wl.envJson.dump();
+  for (size_t r = 0; r < noOfRuns; r++) {
+    s_sendmore(client, "");
+    s_send(client, msg);
+  }
+
+  size_t noOfFailedRuns = 0;
+  for (size_t r = 0; r < noOfRuns; r++) {
+    s_recv(client); // empty delimiter
+    string err;
+    auto result = Json::parse(s_recv(client), err);
+    auto errors = wl.isIC ? result["1"]["errors"] : result["errors"];
+    if (!err.empty() || !errors.array_items().empty()) {
+      for (const auto& e : errors.array_items()) cerr << e.string_value() << endl;
+      noOfFailedRuns++;
+    }
+  }
+
+  s_sendmore(client, "");
+  s_send(client, Json(J11Object{{"type", "finish"}}).dump());
+  s_recv(client);
+  s_recv(client); // ack
+  server.join();
+  client.setsockopt(ZMQ_LINGER, 0);
+  client.close();
+
+  return noOfFailedRuns == 0;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+  setlocale(LC_ALL, "");
+  setlocale(LC_NUMERIC, "C");
+
+  string pathToFixtures = MONICA_BENCH_FIXTURES_DIR;
+  string pathToBaseline;
+  string pathToNewBaseline;
+  string pathToOutputFile;
+  set<string> selectedScenarios;
+  size_t noOfThreads = max(1u, thread::hardware_concurrency());
+  size_t noOfRunsPerThread = 2;
+  double tolerance = 0.1;
+  bool withZmq = true;
+
+  auto printHelp = [=]() {
+    cout
+      << appName << " [options]" << endl
+      << endl
+      << "runs representative workloads on the Hohenfinow2 example on 1 thread, on N threads" << endl
+      << "and through a MONICA zmq server with N workers in the same process," << endl
+      << "outputs the simulated site-years per second (per thread) as json and, if given, compares them to a baseline" << endl
+      << "recorded with --record-baseline on the same machine" << endl
+      << endl
+      << "options:" << endl
+      << endl
+      << " -h   | --help ... this help output" << endl
+      << " -v   | --version ... outputs " << appName << " version" << endl
+      << endl
+      << " -f   | --fixtures DIRECTORY (default: " << MONICA_BENCH_FIXTURES_DIR << ") ... directory of the sim.json files"
+      << endl
+      << " -s   | --scenario NAME (default: all) ... run only the scenario NAME, can be given multiple times:" << endl
+      << "        single-crop-daily, rotation-monthly, intercropping, per-layer-daily" << endl
+      << " -t   | --threads N (default: number of cores) ... number of threads and zmq workers" << endl
+      << " -r   | --runs N (default: 2) ... runs per thread" << endl
+      << " -nz  | --no-zmq ... don't run the workloads through the zmq server" << endl
+      << " -o   | --path-to-output-file FILE (default: stdout) ... write the json to FILE" << endl
+      << " -b   | --baseline FILE ... baseline to compare to, fail on regressions" << endl
+      << " -tol | --tolerance FRACTION (default: 0.1) ... fail if the site-years per second and thread of a workload" << endl
+      << "        are more than FRACTION below the baseline" << endl
+      << " -rb  | --record-baseline FILE ... write the results as new baseline to FILE" << endl;
+  };
+
+  for (auto i = 1; i < argc; i++) {
+    string arg = argv[i];
+    if ((arg == "-f" || arg == "--fixtures") && i + 1 < argc) pathToFixtures = argv[++i];
+    else if ((arg == "-s" || arg == "--scenario") && i + 1 < argc) selectedScenarios.insert(argv[++i]);
+    else if ((arg == "-t" || arg == "--threads") && i + 1 < argc) noOfThreads = max(size_t(1), size_t(stoul(argv[++i])));
+    else if ((arg == "-r" || arg == "--runs") && i + 1 < argc) noOfRunsPerThread = max(size_t(1), size_t(stoul(argv[++i])));
+    else if (arg == "-nz" || arg == "--no-zmq") withZmq = false;
+    else if ((arg == "-o" || arg == "--path-to-output-file") && i + 1 < argc) pathToOutputFile = argv[++i];
+    else if ((arg == "-b" || arg == "--baseline") && i + 1 < argc) pathToBaseline = argv[++i];
+    else if ((arg == "-tol" || arg == "--tolerance") && i + 1 < argc) tolerance = stod(argv[++i]);
+    else if ((arg == "-rb" || arg == "--record-baseline") && i + 1 < argc) pathToNewBaseline = argv[++i];
+    else if (arg == "-h" || arg == "--help") printHelp(), exit(0);
+    else if (arg == "-v" || arg == "--version") cout << appName << " version " << version << endl, exit(0);
+  }
+  if (!pathToFixtures.empty() && pathToFixtures.back() != '/') pathToFixtures += "/";
+
+  activateDebug = false;
+
+  // build the shared read only lookups once, before any worker touches them
+  buildOutputTable();
+  Soil::readCapillaryRiseRates();
+  const auto& pwpFcSatFunctions = monica::pwpFcSatFunctions();
+
+  Json baseline;
+  if (!pathToBaseline.empty()) {
+    auto bj = readAndParseJsonFile(pathToBaseline);
+    if (bj.failure() || !bj.result["site-years/s/thread"].is_object()) {
+      cerr << "Error: no baseline found at '" << pathToBaseline << "', record one with --record-baseline." << endl;
+      return 1;
+    }
+    baseline = bj.result["site-years/s/thread"];
+  }
+
+  J11Object results, siteYearsPerSec;
+  J11Array regressions;
+  for (const auto& scenario : createScenarios()) {
+    if (!selectedScenarios.empty() && selectedScenarios.count(scenario.name) == 0) continue;
+
+    Workload wl;
+    auto envJson = createEnvJsonFromSimJsonFile(pathToFixtures + scenario.simJson);
+    if (envJson.is_null()) return 1;
+    auto envm = envJson.object_items();
+    if (!scenario.events.is_null()) envm["events"] = scenario.events;
+    wl.envJson = envm;
+
+    // one untimed run, which also gives the simulated period
+    {
+      Env env;
+      if (!createEnv(wl, pwpFcSatFunctions, env)) return 1;
+      wl.isIC = env.params.userCropParameters.isIntercropping;
+      wl.noOfDays = env.climateData.noOfStepsPossible();
+      Output out, out2;
+      tie(out, out2) = runMonicaIC(kj::mv(env), wl.isIC);
+    }
+
+    // the multi threaded modes are compared per thread, so the keys don't depend on the number of threads
+    vector<pair<string, function<bool(size_t)>>> modes{
+      {"1-thread", [&](size_t noOfRuns) { return runOnThreads(wl, pwpFcSatFunctions, 0, noOfRuns); }},
+      {"n-threads", [&](size_t noOfRuns) { return runOnThreads(wl, pwpFcSatFunctions, noOfThreads, noOfRuns); }}
+    };
+    if (withZmq) {
+      modes.push_back({"zmq-inproc-n-workers",
+                       [&](size_t noOfRuns) { return runViaZmqInproc(wl, noOfThreads, noOfRuns); }});
+    }
+
+    for (const auto& mode : modes) {
+      auto key = scenario.name + "/" + mode.first;
+      auto modeThreads = mode.first == "1-thread" ? 1 : noOfThreads;
+      auto noOfRuns = noOfRunsPerThread * modeThreads;
+      auto start = chrono::steady_clock::now();
+      if (!mode.second(noOfRuns)) {
+        cerr << "Error: " << key << " failed." << endl;
+        return 1;
+      }
+      double secs = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+      double siteYears = noOfRuns * wl.noOfDays / 365.25;
+      double sypsec = siteYears / secs;
+      double sypsecPerThread = sypsec / modeThreads;
+      siteYearsPerSec[key] = sypsecPerThread;
+
+      J11Object res{{"site-years/s", sypsec}, {"site-years/s/thread", sypsecPerThread}, {"runs", int(noOfRuns)},
+                    {"seconds", secs}};
+      if (!pathToBaseline.empty()) {
+        if (!baseline[key].is_number()) {
+          cerr << "Error: the baseline '" << pathToBaseline << "' has no value for " << key
+               << ", record a new one with --record-baseline." << endl;
+          return 1;
+        }
+        res["baseline"] = baseline[key];
+        if (sypsecPerThread < baseline[key].number_value() * (1 - tolerance)) regressions.push_back(key);
+      }
+      results[key] = res;
+    }
+  }
+
+  Json bench = J11Object
+    {{"type", "monica-throughput-bench"}
+    ,{"version", version}
+    ,{"threads", int(noOfThreads)}
+    ,{"runsPerThread", int(noOfRunsPerThread)}
+    ,{"tolerance", tolerance}
+    ,{"results", results}
+    ,{"regressions", regressions}
+    };
+
+  if (pathToOutputFile.empty()) cout << bench.dump() << endl;
+  else {
+    ofstream out(pathToOutputFile);
+    if (out.fail()) {
+      cerr << "Error while opening output file \"" << pathToOutputFile << "\"" << endl;
+      return 1;
+    }
+    out << bench.dump() << endl;
+  }
+
+  if (!pathToNewBaseline.empty()) {
+    ofstream out(pathToNewBaseline);
+    if (out.fail()) {
+      cerr << "Error while opening baseline file \"" << pathToNewBaseline << "\"" << endl;
+      return 1;
+    }
+    out << Json(J11Object{{"type", "monica-throughput-baseline"}, {"version", version},
+                          {"threads", int(noOfThreads)}, {"site-years/s/thread", siteYearsPerSec}}).dump() << endl;
+  }
+
+  if (!regressions.empty()) {
+    for (const auto& r : regressions) {
+      cerr << "Regression: " << r.string_value() << " " << siteYearsPerSec[r.string_value()].number_value()
+           << " site-years/s/thread, baseline " << baseline[r.string_value()].number_value() << " site-years/s/thread"
+           << endl;
+    }
+    return 1;
+  }
+
+  return 0;
+}
@@ -152,6 +152,7 @@ int main(int argc, char **argv) {
   bool usePipeline = false;
   bool useRouterOutputSocket = false;
   string controlAddress = defControlAddress;
+  size_t noOfWorkers = 0;
 
   SocketOp inputOp = monica::connect;
   SocketOp outputOp = monica::connect;
@@ -184,7 +185,9 @@ int main(int argc, char **argv) {
         << " -or | --router-output-address [ADDRESS1[,ADDRESS2,...]] (default: " << outputAddress
         << ")] ... send results to this address(es) but use a router socket" << endl
         << " -c | --control-address [ADDRESS] (default: " << controlAddress
-        << ")] ... connect MONICA server to this address for control messages" << endl;
+        << ")] ... connect MONICA server to this address for control messages" << endl
+        << " -w | --workers [NUMBER] (default: " << noOfWorkers
+        << ")] ... run jobs on NUMBER worker threads, 0 = run them on the receiving thread" << endl;
   };
 
   zmq::context_t context(1);
@@ -226,6 +229,9 @@ int main(int argc, char **argv) {
       } else if (arg == "-c" || arg == "--control-address") {
         if (i + 1 < argc && argv[i + 1][0] != '-')
           controlAddress = argv[++i];
+      } else if (arg == "-w" || arg == "--workers") {
+        if (i + 1 < argc && argv[i + 1][0] != '-')
+          noOfWorkers = stoul(argv[++i]);
       } else if (arg == "-h" || arg == "--help")
         printHelp(), exit(0);
       else if (arg == "-v" || arg == "--version")
@@ -246,7 +252,7 @@ int main(int argc, char **argv) {
 
     addresses[Control] = {Subscribe, vector<string>{controlAddress}, monica::connect};
 
-    serveZmqMonicaFull(&context, addresses);
+    serveZmqMonicaFull(&context, addresses, noOfWorkers);
 
     debug() << "stopped ZeroMQ MONICA server" << endl;
   }
@@ -0,0 +1,119 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+* License, v. 2.0. If a copy of the MPL was not distributed with this
+* file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+/*
+Authors:
+Michael Berg <michael.berg@zalf.de>
+
+Maintainers:
+Currently maintained by the authors.
+
+This file is part of the MONICA model.
+Copyright (C) Leibniz Centre for Agricultural Landscape Research (ZALF)
+*/
+
+#include "pwp-fc-sat-functions.h"
+
+#include <atomic>
+#include <mutex>
+#include <shared_mutex>
+#include <unordered_map>
+
+using namespace monica;
+using namespace std;
+using namespace Tools;
+
+namespace {
+
+//! stop memoizing new layers beyond this, to bound the memory of long running servers
+const size_t MAX_NO_OF_MEMOIZED_LAYERS = 1000000;
+
+struct Result {
+  Errors errors;
+  double pwp{0}, fc{0}, sat{0};
+};
+
+struct Memo {
+  shared_mutex lock;
+  unordered_map<string, Result> key2result;
+  atomic<size_t> hits{0}, misses{0};
+};
+
+Memo& memo() {
+  static Memo m;
+  return m;
+}
+
+void appendBytes(string& key, double v) { key.append(reinterpret_cast<const char*>(&v), sizeof(v)); }
+
+//! everything the functions read from the layer
+string createKey(const string& name, const Soil::SoilParameters& sps, int i) {
+  string key = name;
+  key += '|';
+  key += sps.vs_SoilTexture;
+  key += '|';
+  key.append(reinterpret_cast<const char*>(&i), sizeof(i));
+  appendBytes(key, sps.vs_SoilSandContent);
+  appendBytes(key, sps.vs_SoilClayContent);
+  appendBytes(key, sps.vs_SoilStoneContent);
+  appendBytes(key, sps.vs_SoilBulkDensity());
+  appendBytes(key, sps.vs_SoilOrganicCarbon());
+  appendBytes(key, sps.vs_PermanentWiltingPoint);
+  appendBytes(key, sps.vs_FieldCapacity);
+  appendBytes(key, sps.vs_Saturation);
+  return key;
+}
+
+PwpFcSatFunction memoized(const string& name, PwpFcSatFunction f) {
+  return [name, f](Soil::SoilParameters* sps, int i) {
+    auto& m = memo();
+    auto key = createKey(name, *sps, i);
+    {
+      shared_lock<shared_mutex> lock(m.lock);
+      auto it = m.key2result.find(key);
+      if (it != m.key2result.end()) {
+        sps->vs_PermanentWiltingPoint = it->second.pwp;
+        sps->vs_FieldCapacity = it->second.fc;
+        sps->vs_Saturation = it->second.sat;
+        m.hits++;
+        return it->second.errors;
+      }
+    }
+
+    auto errors = f(sps, i);
+    m.misses++;
+    unique_lock<shared_mutex> lock(m.lock);
+    if (m.key2result.size() < MAX_NO_OF_MEMOIZED_LAYERS) {
+      m.key2result.emplace(key, Result{errors, sps->vs_PermanentWiltingPoint, sps->vs_FieldCapacity, sps->vs_Saturation});
+    }
+    return errors;
+  };
+}
+
+} // namespace
+
+const PwpFcSatFunctions& monica::pwpFcSatFunctions() {
+  static const PwpFcSatFunctions fs = []() {
+    auto pathToSoilDir = fixSystemSeparator(replaceEnvVars("${MONICA_PARAMETERS}/soil/"));
+    PwpFcSatFunctions fs;
+    fs["Wessolek2009"] = memoized("Wessolek2009",
+                                  Soil::getInitializedUpdateUnsetPwpFcSatfromKA5textureClassFunction(pathToSoilDir));
+    fs["VanGenuchten"] = memoized("VanGenuchtenVereecken", Soil::updateUnsetPwpFcSatFromVanGenuchtenVereecken);
+    fs["VanGenuchtenVereecken"] = fs["VanGenuchten"];
+    fs["VanGenuchtenToth"] = memoized("VanGenuchtenToth", Soil::updateUnsetPwpFcSatFromVanGenuchtenToth);
+    fs["Toth"] = memoized("Toth", Soil::updateUnsetPwpFcSatFromToth);
+    return fs;
+  }();
+  return fs;
+}
+
+PwpFcSatMemoStats monica::pwpFcSatMemoStats() {
+  auto& m = memo();
+  shared_lock<shared_mutex> lock(m.lock);
+  PwpFcSatMemoStats stats;
+  stats.hits = m.hits;
+  stats.misses = m.misses;
+  stats.entries = m.key2result.size();
+  return stats;
+}
@@ -0,0 +1,52 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+* License, v. 2.0. If a copy of the MPL was not distributed with this
+* file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+/*
+Authors:
+Michael Berg <michael.berg@zalf.de>
+
+Maintainers:
+Currently maintained by the authors.
+
+This file is part of the MONICA model.
+Copyright (C) Leibniz Centre for Agricultural Landscape Research (ZALF)
+*/
+
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <map>
+#include <string>
+
+#include "soil/soil.h"
+#include "tools/helper.h"
+
+namespace monica {
+
+/*
+ * The functions to calculate pwp, fc and sat of the soil layers, to be set as
+ * SiteParameters::calculateAndSetPwpFcSatFunctions before the env is merged.
+ *
+ * They are created once per process (so the KA5 tables in ${MONICA_PARAMETERS}/soil/ are
+ * read just once) and are shared by all jobs and threads. As grid runs use the same soil
+ * profiles over and over again, the results per layer are memoized by the layer's texture,
+ * sand, clay and stone content, bulk density, organic carbon and already set pwp, fc and sat.
+ */
+
+typedef std::function<Tools::Errors(Soil::SoilParameters*, int)> PwpFcSatFunction;
+typedef std::map<std::string, PwpFcSatFunction> PwpFcSatFunctions;
+
+//! the functions by name (e.g. "Wessolek2009", "VanGenuchten"), safe to be called concurrently
+const PwpFcSatFunctions& pwpFcSatFunctions();
+
+//! the memoization's statistics since the start of the process
+struct PwpFcSatMemoStats {
+  size_t hits{0};
+  size_t misses{0};
+  size_t entries{0};
+};
+PwpFcSatMemoStats pwpFcSatMemoStats();
+
+} // namespace monica
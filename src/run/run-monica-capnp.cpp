@@ -15,17 +15,22 @@ Copyright (C) Leibniz Centre for Agricultural Landscape Research (ZALF)
 
 #include "run-monica-capnp.h"
 
+#include <memory>
 #include <string>
 #include <vector>
 
 #include <kj/debug.h>
 #include <kj/common.h>
+#include <kj/async.h>
 
 #include "json11/json11.hpp"
 
 #include "tools/helper.h"
 #include "run-monica.h"
+#include "../io/climate-csv-reader.h"
 #include "climate/climate-file-io.h"
+#include "climate-data-cache.h"
+#include "pwp-fc-sat-functions.h"
 #include "capnp-helper.h"
 #include "common/sole.hpp"
 
@@ -41,9 +46,80 @@ using namespace mas;
 
 //std::map<std::string, DataAccessor> daCache;
 
-RunMonica::RunMonica(bool startedServerInDebugMode, mas::infrastructure::common::Restorer* restorer)
+namespace {
+
+//! everything a single run request needs, owned by the request, so concurrent requests don't share state
+struct RunRequest {
+  std::string envJsonStr;
+  bool startedServerInDebugMode{false};
+  DataAccessor da;
+  J11Array soilLayers;
+  kj::Own<kj::CrossThreadPromiseFulfiller<monica::Output>> fulfiller;
+};
+
+monica::Output runMonicaRequest(const RunRequest& req) {
+  std::string err;
+  const Json& envJson = Json::parse(req.envJsonStr, err);
+  //cout << "runMonica: " << envJson["customId"].dump() << endl;
+
+  Env env;
+
+  // set available functions to calculate pwp, fc and sat before env creation
+  env.params.siteParameters.calculateAndSetPwpFcSatFunctions = pwpFcSatFunctions();
+
+  monica::Output out;
+  EResult<DataAccessor> eda;
+  try {
+    auto errors = env.merge(envJson);
+
+    if (!req.soilLayers.empty()) {
+      if (auto it = std::find(errors.errors.begin(), errors.errors.end(), "Soil profile is empty!");
+        it != errors.errors.end()) {
+        errors.errors.erase(it);
+      }
+      errors.append(env.params.siteParameters.merge(J11Object{{"SoilProfileParameters", req.soilLayers}}));
+    }
+    eda.append(errors);
+
+    if (req.da.isValid()) {
+      eda.result = req.da;
+    } else if (!env.climateData.isValid()) {
+      if (!env.climateCSV.empty()) {
+        eda = readClimateDataFromCSVStringViaHeadersFast(env.climateCSV, env.csvViaHeaderOptions);
+      } else if (!env.pathsToClimateCSV.empty()) {
+        eda = *readClimateDataFromCSVFilesViaHeadersCached(env.pathsToClimateCSV, env.csvViaHeaderOptions);
+      }
+    }
+
+    if (eda.success()) {
+      if (eda.result.isValid()) env.climateData = eda.result;
+      else
+        assert(env.climateData.isValid());
+      env.debugMode = req.startedServerInDebugMode && env.debugMode;
+      env.params.userSoilMoistureParameters.getCapillaryRiseRate =
+        [](std::string soilTexture, size_t distance) {
+          return Soil::readCapillaryRiseRates().getRate(kj::mv(soilTexture), distance);
+        };
+
+      out = monica::runMonica(kj::mv(env));
+    } else {
+      out.customId = env.customId;
+    }
+  } catch (std::exception& e) {
+    eda.appendError(kj::str("Error running MONICA: ", e.what()).cStr());
+  }
+  out.errors = eda.errors;
+  out.warnings = eda.warnings;
+  return out;
+}
+
+} // namespace
+
+RunMonica::RunMonica(bool startedServerInDebugMode, mas::infrastructure::common::Restorer* restorer,
+                     size_t noOfWorkerThreads)
 : _restorer(restorer)
-, _startedServerInDebugMode(startedServerInDebugMode) {
+, _startedServerInDebugMode(startedServerInDebugMode)
+, _jobPool(std::make_unique<JobPool>(noOfWorkerThreads)) {
   _id = kj::str(sole::uuid4().str());
   _name = kj::str("Monica capnp server");
 }
@@ -62,122 +138,76 @@ kj::Promise<void> RunMonica::info(InfoContext context) //override
 kj::Promise<void> RunMonica::run(RunContext context) {
   auto envR = context.getParams().getEnv();
 
-  auto runMonica =
-    [envR, this](const DataAccessor& da = DataAccessor(), J11Array soilLayers = J11Array()) mutable {
-    std::string err;
-    auto rest = envR.getRest();
-    if (rest.getType() != mas::schema::common::StructuredText::Type::JSON) {
-      return monica::Output(std::string("Error: 'rest' field is not valid JSON!"));
-    }
-
-    const Json& envJson = Json::parse(rest.getValue().cStr(), err);
-    //cout << "runMonica: " << envJson["customId"].dump() << endl;
-
-    Env env;
-
-    // set available functions to calculate pwp, fc and sat before env creation
-    auto pathToSoilDir = fixSystemSeparator(replaceEnvVars("${MONICA_PARAMETERS}/soil/"));
-    env.params.siteParameters.calculateAndSetPwpFcSatFunctions["Wessolek2009"] =
-      Soil::getInitializedUpdateUnsetPwpFcSatfromKA5textureClassFunction(pathToSoilDir);
-    env.params.siteParameters.calculateAndSetPwpFcSatFunctions["VanGenuchten"] =
-      Soil::updateUnsetPwpFcSatFromVanGenuchtenVereecken;
-    env.params.siteParameters.calculateAndSetPwpFcSatFunctions["VanGenuchtenVereecken"] =
-      Soil::updateUnsetPwpFcSatFromVanGenuchtenVereecken;
-    env.params.siteParameters.calculateAndSetPwpFcSatFunctions["VanGenuchtenToth"] =
-      Soil::updateUnsetPwpFcSatFromVanGenuchtenToth;
-    env.params.siteParameters.calculateAndSetPwpFcSatFunctions["Toth"] = Soil::updateUnsetPwpFcSatFromToth;
-
-    auto errors = env.merge(envJson);
-
-    if (!soilLayers.empty()) {
-      if (auto it = std::find(errors.errors.begin(), errors.errors.end(), "Soil profile is empty!");
-        it != errors.errors.end()) {
-        errors.errors.erase(it);
-      }
-      errors.append(env.params.siteParameters.merge(J11Object{{"SoilProfileParameters", soilLayers}}));
-    }
+  auto setResult = [](RunContext& context, const auto& value) {
+    auto res = context.getResults().initResult();
+    res.setType(mas::schema::common::StructuredText::Type::JSON);
+    res.setValue(value);
+  };
 
-    Output out;
-    EResult<DataAccessor> eda;
-    eda.append(errors);
-    try {
-      if (da.isValid()) {
-        eda.result = da;
-      } else if (!env.climateData.isValid()) {
-        if (!env.climateCSV.empty()) {
-          eda = readClimateDataFromCSVStringViaHeaders(env.climateCSV, env.csvViaHeaderOptions);
-        } else if (!env.pathsToClimateCSV.empty()) {
-          eda = readClimateDataFromCSVFilesViaHeaders(env.pathsToClimateCSV, env.csvViaHeaderOptions);
-        }
-      }
+  auto rest = envR.getRest();
+  if (rest.getType() != mas::schema::common::StructuredText::Type::JSON) {
+    setResult(context, monica::Output(std::string("Error: 'rest' field is not valid JSON!")).toString());
+    return kj::READY_NOW;
+  }
 
-      if (eda.success()) {
-        if (eda.result.isValid()) env.climateData = eda.result;
-        else
-          assert(env.climateData.isValid());
-        env.debugMode = _startedServerInDebugMode && env.debugMode;
-        env.params.userSoilMoistureParameters.getCapillaryRiseRate =
-          [](std::string soilTexture, size_t distance) {
-            return Soil::readCapillaryRiseRates().getRate(kj::mv(soilTexture), distance);
-          };
-
-        out = monica::runMonica(kj::mv(env));
-      } else {
-        out.customId = env.customId;
-      }
-    } catch (std::exception& e) {
-      eda.appendError(kj::str("Error running MONICA: ", e.what()).cStr());
-    }
-    out.errors = eda.errors;
-    out.warnings = eda.warnings;
-    return out;
-  };
+  // the request state is shared with the worker thread, which runs MONICA and fulfills the promise for the result
+  auto req = std::make_shared<RunRequest>();
+  req->envJsonStr = rest.getValue().cStr();
+  req->startedServerInDebugMode = _startedServerInDebugMode;
 
   auto proms = kj::heapArrayBuilder<kj::Promise<void>>(2);
 
   if (envR.hasTimeSeries()) {
     auto ts = envR.getTimeSeries();
     proms.add(dataAccessorFromTimeSeries(kj::mv(ts))
-              .then([this](const DataAccessor& da2) {
-                      _da = da2;
+              .then([req](const DataAccessor& da2) {
+                      req->da = da2;
                     }, [](auto&& e) {
                       KJ_LOG(INFO,
                              "Error while trying to get data accessor from time series: ",
                              e);
                     }));
   } else {
-    _da = DataAccessor();
     proms.add(kj::READY_NOW);
   }
 
   if (envR.hasSoilProfile()) {
     auto layersProm = fromCapnpSoilProfile(envR.getSoilProfile());
-    proms.add(layersProm.then([this](auto&& layers) mutable {
-                                _soilLayers = layers;
+    proms.add(layersProm.then([req](auto&& layers) mutable {
+                                req->soilLayers = layers;
                               }, [](auto&& e) {
                                 KJ_LOG(INFO, "Error while trying to get soil layers: ", e);
                               }));
   } else {
-    _soilLayers = J11Array();
     proms.add(kj::READY_NOW);
   }
 
-  return kj::joinPromises(proms.finish()).then([context, runMonica, this]() mutable {
-                                                 auto out = runMonica(_da, _soilLayers);
-                                                 auto rs = context.getResults();
-                                                 auto res = rs.initResult();
-                                                 res.setType(mas::schema::common::StructuredText::Type::JSON);
-                                                 res.setValue(out.toString());
-                                               }, [context](auto&& e) mutable {
+  return kj::joinPromises(proms.finish()).then([context, req, setResult, this]() mutable -> kj::Promise<void> {
+                                                 auto paf = kj::newPromiseAndCrossThreadFulfiller<monica::Output>();
+                                                 req->fulfiller = kj::mv(paf.fulfiller);
+                                                 _jobPool->submit([req] {
+                                                   // kj exceptions (e.g. from capnp readers) must not escape the
+                                                   // worker thread, they reject just this request
+                                                   monica::Output out;
+                                                   KJ_IF_MAYBE(exc, kj::runCatchingExceptions([&]() {
+                                                     out = runMonicaRequest(*req);
+                                                   })) {
+                                                     req->fulfiller->reject(kj::mv(*exc));
+                                                   } else {
+                                                     req->fulfiller->fulfill(kj::mv(out));
+                                                   }
+                                                 });
+                                                 return paf.promise.then([context, setResult](monica::Output&& out) mutable {
+                                                   setResult(context, out.toString());
+                                                 });
+                                               }, [context, setResult](auto&& e) mutable -> kj::Promise<void> {
                                                  KJ_LOG(INFO,
                                                         "Error while trying to gather soil and/or time series data: ",
                                                         e);
-                                                 auto rs = context.getResults();
-                                                 auto res = rs.initResult();
-                                                 res.setType(mas::schema::common::StructuredText::Type::JSON);
-                                                 res.
-                                                   setValue(kj::str("Error while trying to gather soil and/or time series data: ",
-                                                                    e));
+                                                 setResult(context,
+                                                           kj::str("Error while trying to gather soil and/or time series data: ",
+                                                                   e));
+                                                 return kj::READY_NOW;
                                                });
 }
 
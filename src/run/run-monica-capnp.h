@@ -20,10 +20,13 @@ Copyright (C) Leibniz Centre for Agricultural Landscape Research (ZALF)
 #include <kj/string.h>
 #include <kj/thread.h>
 
+#include <memory>
+
 #include "common/common.h"
 #include "common/restorer.h"
 #include "json11/json11-helper.h"
 #include "climate/climate-common.h"
+#include "job-pool.h"
 
 #include "model.capnp.h"
 #include "common.capnp.h"
@@ -35,7 +38,9 @@ typedef mas::schema::model::EnvInstance<mas::schema::common::StructuredText, mas
 
 class RunMonica final : public MonicaEnvInstance::Server {
 public:
-  explicit RunMonica(bool startedServerInDebugMode = false, mas::infrastructure::common::Restorer *restorer = nullptr);
+  //! the simulations are run on noOfWorkerThreads threads, so the event loop stays responsive while MONICA runs
+  explicit RunMonica(bool startedServerInDebugMode = false, mas::infrastructure::common::Restorer *restorer = nullptr,
+                     size_t noOfWorkerThreads = 1);
 
   kj::StringPtr getId() const { return _id; }
 
@@ -74,8 +79,7 @@ private:
   //mas::schema::common::Action::Client _unregisterAction{ nullptr };
   mas::infrastructure::common::Restorer *_restorer{nullptr};
   MonicaEnvInstance::Client _client{nullptr};
-  Tools::J11Array _soilLayers;
-  Climate::DataAccessor _da;
+  std::unique_ptr<JobPool> _jobPool;
 };
 
 } // namespace monica
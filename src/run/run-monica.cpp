@@ -41,7 +41,11 @@ Copyright (C) Leibniz Centre for Agricultural Landscape Research (ZALF)
 #include "json11/json11-helper.h"
 #include "tools/algorithms.h"
 #include "../io/build-output.h"
+#include "../io/result-sink.h"
 #include "../core/crop-module.h"
+#include "../core/debug-log.h"
+#include "../core/event-registry.h"
+#include "../core/step-timer.h"
 
 using namespace monica;
 using namespace std;
@@ -289,18 +293,6 @@ void writeDebugInputs(const Env &env, string fileName = "inputs.json") {
 }
 
 
-template<typename T = int>
-Maybe<T> parseInt(const string &s) {
-  Maybe<T> res;
-  if (s.empty() || (s.size() > 1 && s.substr(0, 2) == "xx")) return res;
-  else {
-    try { res = stoi(s); }
-    catch (exception e) {}
-  }
-  return res;
-}
-
-
 Tools::Errors Spec::merge(json11::Json j) {
   //init(start, j, "start");
   //init(end, j, "end");
@@ -309,152 +301,145 @@ Tools::Errors Spec::merge(json11::Json j) {
   //init(to, j, "to");
   //Maybe<DMY> dummy;
   //init(dummy, j, "while");
-  startf = createExpressionFunc(j["start"]);
-  endf = createExpressionFunc(j["end"]);
-  atf = createExpressionFunc(j["at"]);
-  fromf = createExpressionFunc(j["from"]);
-  tof = createExpressionFunc(j["to"]);
-  whilef = createExpressionFunc(j["while"]);
+  auto create = [this](const Json& ej) { return predicates ? predicates->add(ej) : createExpressionFunc(ej); };
+  startf = create(j["start"]);
+  endf = create(j["end"]);
+  atf = create(j["at"]);
+  fromf = create(j["from"]);
+  tof = create(j["to"]);
+  whilef = create(j["while"]);
 
   return {};
 }
 
 std::function<bool(const MonicaModel &)> Spec::createExpressionFunc(Json j) {
-  //is an expression event
-  if (j.is_array()) {
-    if (auto f = buildCompareExpression(j.array_items())) return f;
-  } else if (j.is_string()) {
-    auto jts = j.string_value();
-    if (!jts.empty()) {
-      auto s = splitString(jts, "-");
-      //is date event
-      if (jts.size() == 10
-          && s.size() == 3
-          && s[0].size() == 4
-          && s[1].size() == 2
-          && s[2].size() == 2) {
-        auto year = parseInt<uint16_t>(s[0]);
-        auto month = parseInt<uint8_t>(s[1]);
-        auto day = parseInt<uint8_t>(s[2]);
-
-        auto f = [day, month, year](const MonicaModel &monica) {
-          auto cd = monica.currentStepDate();
-
-          // build date to compare against
-          // apply min() for day, to allow for matching of the last day for each month by choosing 31st
-          Date date(day.isNothing() ? cd.day() : min(day.value(), cd.daysInMonth()),
-                    month.isNothing() ? cd.month() : month.value(),
-                    year.isNothing() ? cd.year() : year.value(),
-                    false, true);
-
-          return date == cd;
-        };
-        return f;
-      } else { //treat all other strings as potential workstep event
-        return [jts](const MonicaModel &monica) {
-          const auto &currentEvents = monica.currentEvents();
-          return currentEvents.find(jts) != currentEvents.end();
-        };
-      }
-    }
-  }
-
-  return {};
+  return compileSpecPredicate(j);
 }
 
 
-void storeResults(const vector<OId> &outputIds,
-                  vector<J11Array> &results,
-                  const MonicaModel &monica) {
-  const auto &ofs = buildOutputTable().ofs;
-
-  size_t i = 0;
+void storeResults(const vector<CompiledOId> &outputPlan,
+                  vector<ResultColumn> &results,
+                  const MonicaModel &monica,
+                  const vector<OId> &outputIds) {
   results.resize(outputIds.size());
-  for (auto oid: outputIds) {
-    auto ofi = ofs.find(oid.id);
-    if (ofi != ofs.end()) results[i].push_back(ofi->second(monica, oid));
-    ++i;
+  for (const auto &coid: outputPlan) {
+    const auto &oid = outputIds[coid.index];
+    auto &column = results[coid.index];
+    if (coid.extractNumber) column.push_back((*coid.extractNumber)(monica, oid));
+    else if (coid.extractString) column.push_back((*coid.extractString)(monica, oid));
+    else column.push_back((*coid.extract)(monica, oid));
   }
 };
 
-void storeResultsObj(const vector<OId> &outputIds,
+void storeResultsObj(const vector<CompiledOId> &outputPlan,
                      vector<J11Object> &results,
-                     const MonicaModel &monica) {
-  const auto &ofs = buildOutputTable().ofs;
-
+                     const MonicaModel &monica,
+                     const vector<OId> &outputIds) {
   J11Object result;
-  for (auto oid: outputIds) {
-    auto ofi = ofs.find(oid.id);
-    if (ofi != ofs.end()) result[oid.outputName()] = ofi->second(monica, oid);
+  for (const auto &coid: outputPlan) {
+    result[coid.outputName] = (*coid.extract)(monica, outputIds[coid.index]);
   }
   results.push_back(result);
 };
 
+J11Array currentRow(const vector<CompiledOId> &outputPlan,
+                    const MonicaModel &monica,
+                    const vector<OId> &outputIds) {
+  J11Array row(outputIds.size());
+  for (const auto &coid: outputPlan) {
+    row[coid.index] = (*coid.extract)(monica, outputIds[coid.index]);
+  }
+  return row;
+}
+
+void StoreData::compileOutputPlan() {
+  const auto &bot = buildOutputTable();
+  const auto &ofs = bot.ofs;
+
+  outputPlan.clear();
+  outputPlan.reserve(outputIds.size());
+  needsStepKernelTimes = false;
+  for (size_t i = 0, size = outputIds.size(); i < size; ++i) {
+    const auto &oid = outputIds[i];
+    auto ofi = ofs.find(oid.id);
+    if (ofi != ofs.end()) {
+      CompiledOId coid;
+      coid.extract = &ofi->second;
+      auto nofi = bot.numberOfs.find(oid.id);
+      if (nofi != bot.numberOfs.end()) coid.extractNumber = &nofi->second;
+      auto sofi = bot.stringOfs.find(oid.id);
+      if (sofi != bot.stringOfs.end()) coid.extractString = &sofi->second;
+      coid.index = i;
+      coid.outputName = oid.outputName();
+      outputPlan.push_back(move(coid));
+    }
+    // the perf-ns-* outputs need the model's step kernels to be timed
+    if (oid.name.rfind("perf-ns-", 0) == 0) needsStepKernelTimes = true;
+  }
+}
 
 void StoreData::aggregateResults() {
-  if (!intermediateResults.empty()) {
-    if (results.size() < intermediateResults.size()) {
-      results.resize(intermediateResults.size());
+  if (!accumulators.empty()) {
+    if (!sink && results.size() < accumulators.size()) {
+      results.resize(accumulators.size());
     }
 
-    assert(intermediateResults.size() == outputIds.size());
-
-    size_t i = 0;
-    for (auto oid: outputIds) {
-      auto &ivs = intermediateResults.at(i);
-      if (!ivs.empty()) {
-        if (ivs.front().is_string()) {
-          switch (oid.timeAggOp) {
-            case OId::FIRST:
-              results[i].push_back(ivs.front());
-              break;
-            case OId::LAST:
-              results[i].push_back(ivs.back());
-              break;
-            default:
-              results[i].push_back(ivs.front());
-          }
-        } else results[i].push_back(applyOIdOP(oid.timeAggOp, ivs));
+    assert(accumulators.size() == outputIds.size());
 
-        intermediateResults[i].clear();
+    J11Array row;
+    if (sink) row.resize(outputIds.size());
+    bool aggregatedSomething = false;
+    for (size_t i = 0, size = accumulators.size(); i < size; ++i) {
+      auto &acc = accumulators[i];
+      if (!acc.empty()) {
+        if (sink) row[i] = acc.result();
+        else results[i].push_back(acc.result());
+        aggregatedSomething = true;
+
+        acc.clear();
       }
-      ++i;
     }
+
+    if (sink && aggregatedSomething) sink->row(sinkSection, row);
   }
 }
 
 void StoreData::aggregateResultsObj() {
-  if (!intermediateResults.empty()) {
-    assert(intermediateResults.size() == outputIds.size());
+  // a sink gets rows in both cases
+  if (sink) {
+    aggregateResults();
+    return;
+  }
 
-    J11Object result;
-    size_t i = 0;
-    for (auto oid: outputIds) {
-      auto &ivs = intermediateResults.at(i);
-      if (!ivs.empty()) {
-        if (ivs.front().is_string()) {
-          switch (oid.timeAggOp) {
-            case OId::FIRST:
-              result[oid.outputName()] = ivs.front();
-              break;
-            case OId::LAST:
-              result[oid.outputName()] = ivs.back();
-              break;
-            default:
-              result[oid.outputName()] = ivs.front();
-          }
-        } else result[oid.outputName()] = applyOIdOP(oid.timeAggOp, ivs);
+  if (!accumulators.empty()) {
+    assert(accumulators.size() == outputIds.size());
 
-        intermediateResults[i].clear();
+    J11Object result;
+    for (const auto &coid: outputPlan) {
+      auto &acc = accumulators[coid.index];
+      if (!acc.empty()) {
+        result[coid.outputName] = acc.result();
+        acc.clear();
       }
-      ++i;
     }
     resultsObj.push_back(result);
   }
 }
 
+void StoreData::accumulateResults(const MonicaModel &monica) {
+  if (accumulators.empty()) {
+    accumulators.reserve(outputIds.size());
+    for (const auto &oid: outputIds) accumulators.emplace_back(oid.timeAggOp);
+  }
+
+  for (const auto &coid: outputPlan) {
+    const auto &oid = outputIds[coid.index];
+    if (coid.extractNumber) accumulators[coid.index].add((*coid.extractNumber)(monica, oid));
+    else accumulators[coid.index].add((*coid.extract)(monica, oid));
+  }
+}
+
 void StoreData::storeResultsIfSpecApplies(const MonicaModel &monica, bool storeObjOutputs) {
-  string os = spec.origSpec.dump();
   bool isCurrentlyEndEvent = false;
 
   // check for possible start event (if one exists at all and just enter in that case if it is false)
@@ -471,8 +456,9 @@ void StoreData::storeResultsIfSpecApplies(const MonicaModel &monica, bool storeO
   if (withinEventStartEndRange.isNothing() || withinEventStartEndRange.value()) {
     //check for at event
     if (spec.atf && spec.atf(monica)) {
-      if (storeObjOutputs) storeResultsObj(outputIds, resultsObj, monica);
-      else storeResults(outputIds, results, monica);
+      if (sink) sink->row(sinkSection, currentRow(outputPlan, monica, outputIds));
+      else if (storeObjOutputs) storeResultsObj(outputPlan, resultsObj, monica, outputIds);
+      else storeResults(outputPlan, results, monica, outputIds);
     } else if (spec.fromf && spec.tof) { //or from/to range event
       bool isCurrentlyToEvent = false;
       if (withinEventFromToRange.isNothing() || !withinEventFromToRange.value()) {
@@ -486,8 +472,8 @@ void StoreData::storeResultsIfSpecApplies(const MonicaModel &monica, bool storeO
         // but aggregate only if the range is left
         // this means the range specifies the extend of recording
         if (spec.whilef) {
-          if (spec.whilef(monica)) storeResults(outputIds, intermediateResults, monica);
-        } else storeResults(outputIds, intermediateResults, monica);
+          if (spec.whilef(monica)) accumulateResults(monica);
+        } else accumulateResults(monica);
 
         if (isCurrentlyToEvent) {
           if (storeObjOutputs) aggregateResultsObj();
@@ -498,8 +484,8 @@ void StoreData::storeResultsIfSpecApplies(const MonicaModel &monica, bool storeO
     }
       //or a single while aggregating expression
     else if (spec.whilef) {
-      if (spec.whilef(monica)) storeResults(outputIds, intermediateResults, monica);
-      else if (!intermediateResults.empty() && !intermediateResults.front().empty()) {
+      if (spec.whilef(monica)) accumulateResults(monica);
+      else if (!accumulators.empty() && !accumulators.front().empty()) {
         //if while event was not successful but we got intermediate results, they should be aggregated
         if (storeObjOutputs) aggregateResultsObj();
         else aggregateResults();
@@ -510,7 +496,8 @@ void StoreData::storeResultsIfSpecApplies(const MonicaModel &monica, bool storeO
   if (isCurrentlyEndEvent) withinEventStartEndRange = false;
 }
 
-vector<StoreData> monica::setupStorage(const json11::Json& event2oids, const Date& startDate, const Date& endDate) {
+vector<StoreData> monica::setupStorage(const json11::Json& event2oids, const Date& startDate, const Date& endDate,
+                                       ResultSink* sink, size_t firstSinkSection) {
   map<string, Json> shortcuts =
       {{"daily",   J11Object{{"at", "xxxx-xx-xx"}}},
        {"monthly", J11Object{{"from", "xxxx-xx-01"},
@@ -524,6 +511,8 @@ vector<StoreData> monica::setupStorage(const json11::Json& event2oids, const Dat
       };
 
   vector<StoreData> storeData;
+  // identical expressions of all sections are evaluated just once a day
+  auto predicates = make_shared<SpecPredicates>();
 
   const auto& e2os = event2oids.array_items();
   for (size_t i = 0, size = e2os.size(); i < size; i += 2) {
@@ -559,8 +548,16 @@ vector<StoreData> monica::setupStorage(const json11::Json& event2oids, const Dat
       spec = o;
     }
 
+    sd.spec.predicates = predicates;
     sd.spec.merge(spec);
     sd.outputIds = parseOutputIds(e2os[i + 1].array_items());
+    sd.compileOutputPlan();
+
+    if (sink) {
+      sd.sink = sink;
+      sd.sinkSection = firstSinkSection + storeData.size();
+      sink->beginSection(sd.sinkSection, sd.spec.origSpec.dump(), sd.outputIds);
+    }
 
     storeData.push_back(sd);
   }
@@ -595,28 +592,10 @@ DFSRes deserializeFullState(kj::Own<const kj::ReadableFile> file, bool serialize
   return res;
 }
 
-std::pair<Output, Output> monica::runMonicaIC(Env env, bool isIC) {
-  Output out, out2;
-  bool returnObjOutputs = env.returnObjOutputs();
-  out.customId = env.customId;
-  out2.customId = env.customId;
-
-  activateDebug = env.debugMode;
-  if (activateDebug) writeDebugInputs(env, "inputs.json");
-
-  //prefer multiple crop rotations, but use a single rotation if there
-  if (env.cropRotations.empty() && !env.cropRotation.empty()) {
-    env.cropRotations.push_back(CropRotation(env.climateData.startDate(), env.climateData.endDate(), env.cropRotation));
-  }
-  if (isIC && env.cropRotations2.empty() && !env.cropRotation2.empty()) {
-    env.cropRotations2.push_back(
-        CropRotation(env.climateData.startDate(), env.climateData.endDate(), env.cropRotation2));
-  }
-
-  debug() << "starting Monica" << endl;
-  debug() << "-----" << endl;
-  kj::Own<MonicaModel> monica, monica2;
+namespace {
 
+kj::Own<MonicaModel> createMonicaModel(const Env& env) {
+  kj::Own<MonicaModel> monica;
   if (env.params.simulationParameters.loadSerializedMonicaStateAtStart) {
     auto pathToSerFile = kj::str(env.params.simulationParameters.pathToLoadSerializationFile);
     auto fs = kj::newDiskFilesystem();
@@ -630,115 +609,157 @@ std::pair<Output, Output> monica::runMonicaIC(Env env, bool isIC) {
     monica = kj::heap<MonicaModel>(env.params);
     monica->simulationParametersNC().startDate = env.climateData.startDate();
   }
-  bool isSyncIC = false;
-  if (isIC) {
-    monica->setIntercropping(env.ic);
-    isSyncIC = !monica->intercropping().isAsync();
-    if (isSyncIC) {
-      monica2 = kj::heap<MonicaModel>(env.params);
-      monica2->simulationParametersNC().startDate = env.climateData.startDate();
+  return monica;
+}
+
+//! runs the crop rotations of one MonicaModel day by day: applies the worksteps and stores the results
+class CropRotationRunner {
+public:
+  CropRotationRunner(MonicaModel* monica,
+                     vector<CropRotation>& envCropRotations,
+                     const Json& events,
+                     Date startDate,
+                     Date endDate,
+                     string debugPrefix,
+                     ResultSink* sink = nullptr,
+                     size_t firstSinkSection = 0)
+    : _monica(monica)
+    , _envCropRotations(envCropRotations)
+    , _crit(envCropRotations.begin())
+    , _debugPrefix(kj::mv(debugPrefix)) {
+    // create a way for worksteps to let the runtime calculate at a daily basis things a workstep needs when being executed
+    // e.g. to actually accumulate values from days before the workstep (for calculating a moving window of past values)
+    int dailyFuncId = 0;
+
+    //iterate through all the worksteps in the croprotation(s) and check for functions which have to run daily
+    for (auto &cr: _envCropRotations) {
+      for (auto &cm: cr.cropRotation) {
+        for (auto wsptr: cm.getWorksteps()) {
+          wsptr->attachTo(_monica);
+          auto df = wsptr->registerDailyFunction(
+              [this, dailyFuncId]() -> vector<double> & { return _dailyValues[dailyFuncId]; });
+          if (df) {
+            _applyDailyFuncs.push_back(
+                [this, df, dailyFuncId] { _dailyValues[dailyFuncId].push_back(df(_monica)); });
+          }
+          dailyFuncId++;
+        }
+      }
     }
+
+    //after loading deserialized state, move the iterator to the previous position if possible
+    //!!! attention doesn't check currently if the env is the same as when the state had been serialized !!!
+    //while (critPos-- > 0 && crit + 1 != env.cropRotations.end())
+    //  crit++;
+
+    //iterator through the crop rotation
+    _cmit = _cropRotation.begin();
+    //after loading deserialized state, move the iterator to the previous position if possible
+    //!!! attention doesn't check currently if the env is the same as when the state had been serialized !!!
+    //while (cmitPos-- > 0 && cmit + 1 != cropRotation.end())
+    //	cmit++;
+
+    tie(_currentCM, _nextAbsoluteCMApplicationDate) = findNextCultivationMethod(startDate, false);
+
+    //while (cmitPos-- > 0 && cmit + 1 != cropRotation.end())
+    //	tie(currentCM, nextAbsoluteCMApplicationDate) = findNextCultivationMethod(currentDate, true);;
+
+    _store = setupStorage(events, startDate, endDate, sink, firstSinkSection);
+    for (const auto& s : _store) if (s.needsStepKernelTimes) _monica->setStepKernelsTimed(true);
   }
 
-  monica->simulationParametersNC().endDate = env.climateData.endDate();
-  monica->simulationParametersNC().noOfPreviousDaysSerializedClimateData = env.params.simulationParameters.noOfPreviousDaysSerializedClimateData;
-  if (isSyncIC) {
-    monica2->simulationParametersNC().endDate = env.climateData.endDate();
-    monica2->simulationParametersNC().noOfPreviousDaysSerializedClimateData = env.params.simulationParameters.noOfPreviousDaysSerializedClimateData;
+  CropRotationRunner(const CropRotationRunner&) = delete;
+  CropRotationRunner& operator=(const CropRotationRunner&) = delete;
+
+  //! to be called at the start of every day, before the model's daily reset
+  void beginDay(Date currentDate) {
+    if (checkAndInitShadowOfNextCropRotation(currentDate)) {
+      //cmit = cropRotation.empty() ? cropRotation.end() : cropRotation.begin();
+      _cmit = _cropRotation.begin();
+      tie(_currentCM, _nextAbsoluteCMApplicationDate) = findNextCultivationMethod(currentDate, false);
+    }
   }
 
-  debug() << "currentDate" << endl;
-  Date currentDate = env.climateData.startDate();
+  //! try to apply dynamic worksteps marked to run before everything else that day
+  void applyDynamicWorkstepsBeforeStep() {
+    if (_currentCM) _currentCM->apply(_monica, true);
+  }
 
-  // create a way for worksteps to let the runtime calculate at a daily basis things a workstep needs when being executed
-  // e.g. to actually accumulate values from days before the workstep (for calculating a moving window of past values)
-  int dailyFuncId = 0, dailyFuncId2 = 0;
-  map<int, vector<double>> dailyValues, dailyValues2;
-  vector<function<void()>> applyDailyFuncs, applyDailyFuncs2;
-
-  //iterate through all the worksteps in the croprotation(s) and check for functions which have to run daily
-  for (auto &cr: env.cropRotations) {
-    for (auto &cm: cr.cropRotation) {
-      for (auto wsptr: cm.getWorksteps()) {
-        auto df = wsptr->registerDailyFunction(
-            [&dailyValues, dailyFuncId]() -> vector<double> & { return dailyValues[dailyFuncId]; });
-        if (df) {
-          applyDailyFuncs.push_back(
-              [&monica, df, dailyFuncId, &dailyValues] { dailyValues[dailyFuncId].push_back(df(monica.get())); });
-        }
-        dailyFuncId++;
-      }
+  //! apply worksteps and cycle through crop rotation
+  //! @return if absolute worksteps had been applied at currentDate
+  bool applyAbsoluteWorksteps(Date currentDate) {
+    if (_currentCM && _nextAbsoluteCMApplicationDate == currentDate) {
+      MONICA_DEBUG(_debugPrefix << "applying absolute-at: " << _nextAbsoluteCMApplicationDate.toString() << endl);
+      _currentCM->absApply(_nextAbsoluteCMApplicationDate, _monica);
+
+      _nextAbsoluteCMApplicationDate = _currentCM->nextAbsDate(_nextAbsoluteCMApplicationDate);
+
+      MONICA_DEBUG(_debugPrefix << "next abs app-date: " << _nextAbsoluteCMApplicationDate.toString() << endl);
+      return true;
     }
+    return false;
   }
-  if (isSyncIC) {
-    for (auto &cr: env.cropRotations2) {
-      for (auto &cm: cr.cropRotation) {
-        for (auto wsptr: cm.getWorksteps()) {
-          auto df = wsptr->registerDailyFunction([&dailyValues2, dailyFuncId2]() -> vector<double> & {
-            return dailyValues2[dailyFuncId2];
-          });
-          if (df) {
-            applyDailyFuncs2.push_back([&monica2, df, dailyFuncId2, &dailyValues2] {
-              dailyValues2[dailyFuncId2].push_back(df(monica2.get()));
-            });
-          }
-          dailyFuncId2++;
-        }
-      }
+
+  //! to be called after the model's step for the day
+  void endDay(Date currentDate, bool returnObjOutputs) {
+    // call all daily functions, assuming it's better to do this after the steps, than before
+    // so the daily monica calculations will be taken into account
+    // but means also that a workstep which gets executed before the steps, can't take the
+    // values into account by applying a daily function
+    for (auto &f: _applyDailyFuncs) f();
+
+    //try to apply dynamic worksteps marked to run AFTER everything else that day
+    if (_currentCM) _currentCM->apply(_monica, false);
+
+    //store results
+    {
+      StepKernelTimer t(STORE_RESULTS, _monica->timedStepKernelTimes());
+      for (auto &s: _store) s.storeResultsIfSpecApplies(*_monica, returnObjOutputs);
+    }
+
+    //if the next application date is not valid, we're at the end
+    //of the application list of this cultivation method
+    //and go to the next one in the crop rotation
+    if (_currentCM && _currentCM->allDynamicWorkstepsFinished() && !_nextAbsoluteCMApplicationDate.isValid()) {
+      // to count the applied fertiliser for the next production process
+      _monica->resetFertiliserCounter();
+      tie(_currentCM, _nextAbsoluteCMApplicationDate) = findNextCultivationMethod(currentDate + 1);
     }
   }
 
-  auto crit = env.cropRotations.begin();
-  auto crit2 = env.cropRotations2.begin();
-  //after loading deserialized state, move the iterator to the previous position if possible
-  //!!! attention doesn't check currently if the env is the same as when the state had been serialized !!!
-  //while (critPos-- > 0 && crit + 1 != env.cropRotations.end())
-  //  crit++;
+  size_t noOfStoreSections() const { return _store.size(); }
 
-  //cropRotation is a shadow of the env.cropRotation, which will hold pointers to CMs in env.cropRotation, but might shrink
-  //if pure absolute CMs are finished
-  vector<CultivationMethod *> cropRotation, cropRotation2;
+  void collectResults(Output& out, bool returnObjOutputs) {
+    for (auto &sd: _store) {
+      //aggregate results of while events or unfinished other from/to ranges (where to event didn't happen yet)
+      if (returnObjOutputs) sd.aggregateResultsObj();
+      else sd.aggregateResults();
+      out.data.push_back({sd.spec.origSpec.dump(), sd.outputIds, sd.results, sd.resultsObj});
+    }
+  }
 
-  auto checkAndInitShadowOfNextCropRotation_ = [](auto &envCropRotations, auto &crit, auto &cropRotation,
-                                                  Date currentDate) {
-    if (crit != envCropRotations.end()) {
+private:
+  bool checkAndInitShadowOfNextCropRotation(Date currentDate) {
+    if (_crit != _envCropRotations.end()) {
       //if current cropRotation is finished, try to move to next
-      if (crit->end.isValid() && currentDate == crit->end + 1) {
-        crit++;
-        cropRotation.clear();
+      if (_crit->end.isValid() && currentDate == _crit->end + 1) {
+        _crit++;
+        _cropRotation.clear();
       }
 
       //check again, because we might have moved to next cropRotation
-      if (crit != envCropRotations.end()) {
+      if (_crit != _envCropRotations.end()) {
         //if a new cropRotation starts, copy the pointers to the CMs to the shadow CR
-        if (crit->start.isValid() && currentDate == crit->start) {
-          for (auto &cm: crit->cropRotation) cropRotation.push_back(&cm);
+        if (_crit->start.isValid() && currentDate == _crit->start) {
+          for (auto &cm: _crit->cropRotation) _cropRotation.push_back(&cm);
           return true;
         }
       }
     }
     return false;
-  };
-
-  auto checkAndInitShadowOfNextCropRotation = [&](Date currentDate) {
-    return checkAndInitShadowOfNextCropRotation_(env.cropRotations, crit, cropRotation, currentDate);
-  };
-  auto checkAndInitShadowOfNextCropRotation2 = [&](Date currentDate) {
-    return checkAndInitShadowOfNextCropRotation_(env.cropRotations2, crit2, cropRotation2, currentDate);
-  };
+  }
 
-  //iterator through the crop rotation
-  auto cmit = cropRotation.begin();
-  auto cmit2 = cropRotation2.begin();
-  //after loading deserialized state, move the iterator to the previous position if possible
-  //!!! attention doesn't check currently if the env is the same as when the state had been serialized !!!
-  //while (cmitPos-- > 0 && cmit + 1 != cropRotation.end())
-  //	cmit++;
-
-  auto findNextCultivationMethod_ = [&](Date currentDate,
-                                        auto &cropRotation,
-                                        auto &cmit,
-                                        bool advanceToNextCM = true) {
+  pair<CultivationMethod*, Date> findNextCultivationMethod(Date currentDate, bool advanceToNextCM = true) {
     CultivationMethod *currentCM = nullptr;
     Date nextAbsoluteCMApplicationDate;
 
@@ -748,17 +769,17 @@ std::pair<Output, Output> monica::runMonicaIC(Env env, bool isIC) {
       if (advanceToNextCM) {
         //delete fully cultivation methods with only absolute worksteps,
         //because they won't participate in a new run when wrapping the crop rotation 
-        if ((*cmit)->areOnlyAbsoluteWorksteps() || !(*cmit)->repeat()) cmit = cropRotation.erase(cmit);
-        else cmit++;
+        if ((*_cmit)->areOnlyAbsoluteWorksteps() || !(*_cmit)->repeat()) _cmit = _cropRotation.erase(_cmit);
+        else _cmit++;
 
         //start anew if we reached the end of the crop rotation
-        if (cmit == cropRotation.end()) cmit = cropRotation.begin();
+        if (_cmit == _cropRotation.end()) _cmit = _cropRotation.begin();
       }
 
       //check if there's at least a cultivation method left in cropRotation
-      if (cmit != cropRotation.end()) {
+      if (_cmit != _cropRotation.end()) {
         advanceToNextCM = true;
-        currentCM = *cmit;
+        currentCM = *_cmit;
 
         //addedYear tells that the start of the cultivation method was before currentDate and thus the whole 
         //CM had to be moved into the next year
@@ -784,7 +805,7 @@ std::pair<Output, Output> monica::runMonicaIC(Env env, bool isIC) {
         else {
           nextAbsoluteCMApplicationDate = currentCM->staticWorksteps().empty() ? Date() : currentCM->absStartDate(
               false);
-          debug() << "new valid next abs app-date: " << nextAbsoluteCMApplicationDate.toString() << endl;
+          MONICA_DEBUG("new valid next abs app-date: " << nextAbsoluteCMApplicationDate.toString() << endl);
         }
       } else {
         currentCM = nullptr;
@@ -794,44 +815,88 @@ std::pair<Output, Output> monica::runMonicaIC(Env env, bool isIC) {
     }
 
     return make_pair(currentCM, nextAbsoluteCMApplicationDate);
-  };
-
-  auto findNextCultivationMethod = [&](Date currentDate, bool advanceToNextCM = true) {
-    return findNextCultivationMethod_(currentDate, cropRotation, cmit, advanceToNextCM);
-  };
-  auto findNextCultivationMethod2 = [&](Date currentDate, bool advanceToNextCM = true) {
-    return findNextCultivationMethod_(currentDate, cropRotation2, cmit2, advanceToNextCM);
-  };
+  }
 
+  MonicaModel* _monica{nullptr};
+  vector<CropRotation>& _envCropRotations;
+  vector<CropRotation>::iterator _crit;
+  //cropRotation is a shadow of the env.cropRotation, which will hold pointers to CMs in env.cropRotation, but might shrink
+  //if pure absolute CMs are finished
+  vector<CultivationMethod*> _cropRotation;
+  vector<CultivationMethod*>::iterator _cmit;
   //direct handle to current cultivation method
-  CultivationMethod *currentCM{nullptr};
-  CultivationMethod *currentCM2{nullptr};
-  Date nextAbsoluteCMApplicationDate, nextAbsoluteCMApplicationDate2;
-  tie(currentCM, nextAbsoluteCMApplicationDate) = findNextCultivationMethod(currentDate, false);
-  if (isSyncIC) tie(currentCM2, nextAbsoluteCMApplicationDate2) = findNextCultivationMethod2(currentDate, false);
+  CultivationMethod* _currentCM{nullptr};
+  Date _nextAbsoluteCMApplicationDate;
+  map<int, vector<double>> _dailyValues;
+  vector<function<void()>> _applyDailyFuncs;
+  vector<StoreData> _store;
+  string _debugPrefix;
+};
+
+} // namespace
+
+std::pair<Output, Output> monica::runMonicaIC(Env env, bool isIC, ResultSink* sink) {
+  Output out, out2;
+  bool returnObjOutputs = env.returnObjOutputs();
+  out.customId = env.customId;
+  out2.customId = env.customId;
+
+  // activateDebug is process global and has to be set by the caller,
+  // writing it here would switch debug output for all concurrently running simulations,
+  // so the env's debug mode is applied to this thread only
+  ThreadDebugMode debugMode(env.debugMode);
+  if (env.debugMode) writeDebugInputs(env, "inputs.json");
+
+  //prefer multiple crop rotations, but use a single rotation if there
+  if (env.cropRotations.empty() && !env.cropRotation.empty()) {
+    env.cropRotations.push_back(CropRotation(env.climateData.startDate(), env.climateData.endDate(), env.cropRotation));
+  }
+  if (isIC && env.cropRotations2.empty() && !env.cropRotation2.empty()) {
+    env.cropRotations2.push_back(
+        CropRotation(env.climateData.startDate(), env.climateData.endDate(), env.cropRotation2));
+  }
+
+  MONICA_DEBUG("starting Monica" << endl);
+  MONICA_DEBUG("-----" << endl);
+  kj::Own<MonicaModel> monica = createMonicaModel(env), monica2;
+  bool isSyncIC = false;
+  if (isIC) {
+    monica->setIntercropping(env.ic);
+    isSyncIC = !monica->intercropping().isAsync();
+    if (isSyncIC) {
+      monica2 = kj::heap<MonicaModel>(env.params);
+      monica2->simulationParametersNC().startDate = env.climateData.startDate();
+    }
+  }
 
-  //while (cmitPos-- > 0 && cmit + 1 != cropRotation.end())
-  //	tie(currentCM, nextAbsoluteCMApplicationDate) = findNextCultivationMethod(currentDate, true);;
+  monica->simulationParametersNC().endDate = env.climateData.endDate();
+  monica->simulationParametersNC().noOfPreviousDaysSerializedClimateData = env.params.simulationParameters.noOfPreviousDaysSerializedClimateData;
+  if (isSyncIC) {
+    monica2->simulationParametersNC().endDate = env.climateData.endDate();
+    monica2->simulationParametersNC().noOfPreviousDaysSerializedClimateData = env.params.simulationParameters.noOfPreviousDaysSerializedClimateData;
+  }
 
-  vector<StoreData> store = setupStorage(env.events, env.climateData.startDate(), env.climateData.endDate());
-  vector<StoreData> store2;
-  if (isSyncIC) store2 = setupStorage(env.events2, env.climateData.startDate(), env.climateData.endDate());
+  MONICA_DEBUG("currentDate" << endl);
+  Date currentDate = env.climateData.startDate();
+
+  CropRotationRunner runner(monica.get(), env.cropRotations, env.events,
+                            env.climateData.startDate(), env.climateData.endDate(), "MONICA 1: ", sink);
+  kj::Own<CropRotationRunner> runner2;
+  if (isSyncIC) {
+    runner2 = kj::heap<CropRotationRunner>(monica2.get(), env.cropRotations2, env.events2,
+                                           env.climateData.startDate(), env.climateData.endDate(), "MONICA 2: ",
+                                           sink, runner.noOfStoreSections());
+  }
+
+  ClimateStepReader climateSteps(env.climateData, env.params.siteParameters.vs_Latitude);
 
   monica->addEvent("run-started");
   if (isSyncIC) monica2->addEvent("run-started");
   for (size_t d = 0, nods = env.climateData.noOfStepsPossible(); d < nods; ++d, ++currentDate) {
-    debug() << "currentDate: " << currentDate.toString() << endl;
+    MONICA_DEBUG("currentDate: " << currentDate.toString() << endl);
 
-    if (checkAndInitShadowOfNextCropRotation(currentDate)) {
-      //cmit = cropRotation.empty() ? cropRotation.end() : cropRotation.begin();
-      cmit = cropRotation.begin();
-      tie(currentCM, nextAbsoluteCMApplicationDate) = findNextCultivationMethod(currentDate, false);
-    }
-    if (isSyncIC && checkAndInitShadowOfNextCropRotation2(currentDate)) {
-      //cmit = cropRotation.empty() ? cropRotation.end() : cropRotation.begin();
-      cmit2 = cropRotation2.begin();
-      tie(currentCM2, nextAbsoluteCMApplicationDate2) = findNextCultivationMethod2(currentDate, false);
-    }
+    runner.beginDay(currentDate);
+    if (isSyncIC) runner2->beginDay(currentDate);
 
     monica->dailyReset();
     if (isSyncIC) monica2->dailyReset();
@@ -850,11 +915,11 @@ std::pair<Output, Output> monica::runMonicaIC(Env env, bool isIC) {
 
     monica->setCurrentStepDate(currentDate);
     if (isSyncIC) monica2->setCurrentStepDate(currentDate);
-    monica->setCurrentStepClimateData(env.climateData.allDataForStep(d, env.params.siteParameters.vs_Latitude));
+    auto cd = climateSteps.step(d);
+    monica->setCurrentStepClimateData(cd);
     if (isSyncIC) {
-      auto cd = env.climateData.allDataForStep(d, env.params.siteParameters.vs_Latitude);
       // in case of sequential water use activated, set the precipitation for the second monica to 0
-      if (monica->cropParameters().sequentialWaterUse) cd[Climate::precip] = 0;
+      if (monica->cropParameters().sequentialWaterUse) cd.set(Climate::precip, 0);
       monica2->setCurrentStepClimateData(cd);
     }
 
@@ -867,30 +932,14 @@ std::pair<Output, Output> monica::runMonicaIC(Env env, bool isIC) {
       monica2->incorporateCurrentCrop();
     }
 
-    //try to apply dynamic worksteps marked to run before everything else that day
-    if (currentCM) currentCM->apply(monica.get(), true);
-    if (isSyncIC && currentCM2) currentCM2->apply(monica2.get(), true);
-
-    //apply worksteps and cycle through crop rotation
-    if (currentCM && nextAbsoluteCMApplicationDate == currentDate) {
-      debug() << "MONICA 1: applying absolute-at: " << nextAbsoluteCMApplicationDate.toString() << endl;
-      currentCM->absApply(nextAbsoluteCMApplicationDate, monica.get());
-
-      nextAbsoluteCMApplicationDate = currentCM->nextAbsDate(nextAbsoluteCMApplicationDate);
-
-      debug() << "MONICA 1: next abs app-date: " << nextAbsoluteCMApplicationDate.toString() << endl;
-    }
-    if (isSyncIC && currentCM2 && nextAbsoluteCMApplicationDate2 == currentDate) {
-      debug() << "MONICA 2: applying absolute-at: " << nextAbsoluteCMApplicationDate2.toString() << endl;
-      currentCM2->absApply(nextAbsoluteCMApplicationDate2, monica2.get());
-
-      nextAbsoluteCMApplicationDate2 = currentCM2->nextAbsDate(nextAbsoluteCMApplicationDate2);
-
-      debug() << "MONICA 2: next abs app-date: " << nextAbsoluteCMApplicationDate2.toString() << endl;
+    runner.applyDynamicWorkstepsBeforeStep();
+    if (isSyncIC) runner2->applyDynamicWorkstepsBeforeStep();
 
+    runner.applyAbsoluteWorksteps(currentDate);
+    if (isSyncIC && runner2->applyAbsoluteWorksteps(currentDate)) {
       // calculate phRedux if set to automatic
       if (monica2->cropParameters().pc_intercropping_autoPhRedux &&
-          monica2->currentEvents().find("Sowing") != monica2->currentEvents().end() &&
+          monica2->currentEvents().contains(SOWING_EVENT) &&
           monica->cropGrowth() != nullptr) {
         auto cg1 = monica->cropGrowth();
         // crop 1 (wheat) has not yet reached anthesis, use first part of curve
@@ -922,7 +971,7 @@ std::pair<Output, Output> monica::runMonicaIC(Env env, bool isIC) {
       }
     }
 
-    if (isSyncIC) debug() << "MONICA 1: ";
+    if (isSyncIC) MONICA_DEBUG("MONICA 1: ");
     monica->step();
     if (isSyncIC) {
       if (monica->cropGrowth()) {
@@ -931,7 +980,7 @@ std::pair<Output, Output> monica::runMonicaIC(Env env, bool isIC) {
       } else {
         monica2->setOtherCropHeightAndLAIt(-1, -1);
       }
-      debug() << "MONICA 2: ";
+      MONICA_DEBUG("MONICA 2: ");
       //set the soil moisture of monica2's soil column to monica1's soil column (after running for current day)
       if (monica->cropParameters().sequentialWaterUse) {
         auto nols = monica->soilColumnNC().size();
@@ -942,37 +991,10 @@ std::pair<Output, Output> monica::runMonicaIC(Env env, bool isIC) {
       }
       monica2->step();
     }
-    debug() << std::endl;
-
-    // call all daily functions, assuming it's better to do this after the steps, than before
-    // so the daily monica calculations will be taken into account
-    // but means also that a workstep which gets executed before the steps, can't take the
-    // values into account by applying a daily function
-    for (auto &f: applyDailyFuncs) f();
-    if (isSyncIC) for (auto &f: applyDailyFuncs2) f();
+    MONICA_DEBUG(std::endl);
 
-    //try to apply dynamic worksteps marked to run AFTER everything else that day
-    if (currentCM) currentCM->apply(monica.get(), false);
-    if (isSyncIC && currentCM2) currentCM2->apply(monica2.get(), false);
-
-    //store results
-    for (auto &s: store) s.storeResultsIfSpecApplies(*monica, returnObjOutputs);
-    if (isSyncIC) for (auto &s: store2) s.storeResultsIfSpecApplies(*monica2, returnObjOutputs);
-
-    //if the next application date is not valid, we're at the end
-    //of the application list of this cultivation method
-    //and go to the next one in the crop rotation
-    if (currentCM && currentCM->allDynamicWorkstepsFinished() && !nextAbsoluteCMApplicationDate.isValid()) {
-      // to count the applied fertiliser for the next production process
-      monica->resetFertiliserCounter();
-      tie(currentCM, nextAbsoluteCMApplicationDate) = findNextCultivationMethod(currentDate + 1);
-    }
-    if (isSyncIC && currentCM2 && currentCM2->allDynamicWorkstepsFinished() &&
-        !nextAbsoluteCMApplicationDate2.isValid()) {
-      // to count the applied fertiliser for the next production process
-      monica2->resetFertiliserCounter();
-      tie(currentCM2, nextAbsoluteCMApplicationDate2) = findNextCultivationMethod2(currentDate + 1);
-    }
+    runner.endDay(currentDate, returnObjOutputs);
+    if (isSyncIC) runner2->endDay(currentDate, returnObjOutputs);
   }
 
   if (env.params.simulationParameters.serializeMonicaStateAtEnd) {
@@ -986,22 +1008,11 @@ std::pair<Output, Output> monica::runMonicaIC(Env env, bool isIC) {
   //	sms.apply(monica2.get());
   //}
 
-  for (auto &sd: store) {
-    //aggregate results of while events or unfinished other from/to ranges (where to event didn't happen yet)
-    if (returnObjOutputs) sd.aggregateResultsObj();
-    else sd.aggregateResults();
-    out.data.push_back({sd.spec.origSpec.dump(), sd.outputIds, sd.results, sd.resultsObj});
-  }
-  if (isSyncIC) {
-    for (auto &sd: store2) {
-      //aggregate results of while events or unfinished other from/to ranges (where to event didn't happen yet)
-      if (returnObjOutputs) sd.aggregateResultsObj();
-      else sd.aggregateResults();
-      out2.data.push_back({sd.spec.origSpec.dump(), sd.outputIds, sd.results, sd.resultsObj});
-    }
-  }
+  runner.collectResults(out, returnObjOutputs);
+  if (isSyncIC) runner2->collectResults(out2, returnObjOutputs);
+  if (sink) sink->finish();
 
-  debug() << "returning from runMonica" << endl;
+  MONICA_DEBUG("returning from runMonica" << endl);
 
 #ifdef TEST_HOURLY_OUTPUT
   tout(true);
@@ -1010,4 +1021,4 @@ std::pair<Output, Output> monica::runMonicaIC(Env env, bool isIC) {
   return make_pair(out, out2);
 }
 
-Output monica::runMonica(Env env) { return runMonicaIC(kj::mv(env), false).first; }
+Output monica::runMonica(Env env, ResultSink* sink) { return runMonicaIC(kj::mv(env), false, sink).first; }
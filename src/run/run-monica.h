@@ -17,6 +17,7 @@ Copyright (C) Leibniz Centre for Agricultural Landscape Research (ZALF)
 
 #pragma once
 
+#include <memory>
 #include <ostream>
 #include <vector>
 
@@ -26,11 +27,15 @@ Copyright (C) Leibniz Centre for Agricultural Landscape Research (ZALF)
 #include "common/dll-exports.h"
 #include "../core/monica-model.h"
 #include "cultivation-method.h"
+#include "spec-predicates.h"
 #include "climate/climate-common.h"
 #include "../io/output.h"
+#include "../io/build-output.h"
 
 namespace monica
 {
+class ResultSink;
+
 struct CropRotation : public Tools::Json11Serializable {
   CropRotation() = default;
 
@@ -117,6 +122,9 @@ struct Spec : public Tools::Json11Serializable {
 
   json11::Json origSpec;
 
+  //! if set before merging, the expressions are shared with the other specs using the same predicates
+  std::shared_ptr<SpecPredicates> predicates;
+
   std::function<bool(const MonicaModel&)> startf;
   std::function<bool(const MonicaModel&)> endf;
   std::function<bool(const MonicaModel&)> fromf;
@@ -125,26 +133,51 @@ struct Spec : public Tools::Json11Serializable {
   std::function<bool(const MonicaModel&)> whilef;
 };
 
+//! an output id resolved against the output table
+//! plain number and string outputs are also resolved to their typed output function,
+//! so their values are only boxed into a json11::Json if a row is actually written
+struct CompiledOId {
+  const std::function<json11::Json(const MonicaModel&, const OId&)>* extract{nullptr};
+  const NumberOutputFunction* extractNumber{nullptr};
+  const StringOutputFunction* extractString{nullptr};
+  size_t index{0}; //!< position of the OId in StoreData::outputIds and the results
+  std::string outputName; //!< key for the object outputs
+};
+
 struct StoreData {
   void aggregateResults();
   void aggregateResultsObj();
   void storeResultsIfSpecApplies(const MonicaModel& monica, bool storeObjOutputs = false);
 
+  //! resolve outputIds to the output functions once, so storing a day is just a loop over the plan
+  void compileOutputPlan();
+
+  //! add the current values to the time aggregation of the from/to and while events
+  void accumulateResults(const MonicaModel& monica);
+
   Tools::Maybe<bool> withinEventStartEndRange;
   Tools::Maybe<bool> withinEventFromToRange;
   Spec spec;
   std::vector<OId> outputIds;
-  std::vector<Tools::J11Array> intermediateResults;
-  std::vector<Tools::J11Array> results;
+  std::vector<CompiledOId> outputPlan;
+  bool needsStepKernelTimes{false}; //!< set by compileOutputPlan if a perf-ns-* output is requested
+  std::vector<OIdAccumulator> accumulators; //!< one per output id, empty until the first values are accumulated
+  std::vector<ResultColumn> results;
   std::vector<Tools::J11Object> resultsObj;
+  ResultSink* sink{nullptr}; //!< if set, final rows are pushed into the sink instead of being kept in results
+  size_t sinkSection{0};
 };
 
-std::vector<StoreData> setupStorage(const json11::Json& event2oids, const Tools::Date& startDate, const Tools::Date& endDate);
+//! @param sink optional sink receiving the results while running, the sections are numbered from firstSinkSection
+std::vector<StoreData> setupStorage(const json11::Json& event2oids, const Tools::Date& startDate, const Tools::Date& endDate,
+                                    ResultSink* sink = nullptr, size_t firstSinkSection = 0);
 
 //! main function for running monica under a given Env(ironment)
 //! @param env the environment completely defining what the model needs and gets
+//! @param sink if set, the results are pushed into the sink while running and the Output holds no result rows
+//! (the sections of the second intercropping model follow the ones of the first model)
 //! @return a structure with all the Monica results
-DLL_API std::pair<Output, Output> runMonicaIC(Env env, bool isIntercropping = true);
-DLL_API Output runMonica(Env env);
+DLL_API std::pair<Output, Output> runMonicaIC(Env env, bool isIntercropping = true, ResultSink* sink = nullptr);
+DLL_API Output runMonica(Env env, ResultSink* sink = nullptr);
   
 } // namespace monica
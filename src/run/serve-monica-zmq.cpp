@@ -17,15 +17,23 @@ Copyright (C) Leibniz Centre for Agricultural Landscape Research (ZALF)
 
 #include <iostream>
 #include <algorithm>
+#include <atomic>
+#include <deque>
 #include <map>
 #include <mutex>
+#include <set>
+#include <thread>
 #include <tuple>
 
 #include "zeromq/zmq-helper.h"
 #include "cultivation-method.h"
 #include "tools/debug.h"
 #include "run-monica.h"
+#include "../io/result-sink.h"
+#include "../io/climate-csv-reader.h"
 #include "climate/climate-file-io.h"
+#include "climate-data-cache.h"
+#include "pwp-fc-sat-functions.h"
 
 #ifdef INCLUDE_SR_SUPPORT
 #include "common/rpc-connection-manager.h"
@@ -380,13 +388,428 @@ void Monica::ZmqServer::startZeroMQMonica(zmq::context_t* zmqContext,
 }
 */
 
-void monica::serveZmqMonicaFull(zmq::context_t* zmqContext,
-                                map<SocketRole, SocketConfig> socketAddresses) {
+namespace {
+
+//! what a thread needs to run MONICA for "Env" messages
+struct RunState {
 #ifdef INCLUDE_SR_SUPPORT
-  auto ioContext = kj::setupAsyncIo();
-  mas::infrastructure::common::ConnectionManager conMan(ioContext);
+  RunState() : ioContext(kj::setupAsyncIo()), conMan(ioContext) {}
+
+  kj::AsyncIoContext ioContext;
+  mas::infrastructure::common::ConnectionManager conMan;
 #endif
+  bool startedServerInDebugMode{false};
+};
+
+//! run MONICA for the "Env" message msgJson
+//! @return the serialized result message
+string runEnvMessage(RunState& rs, const Json& msgJson, ResultSink* sink = nullptr) {
+#ifdef INCLUDE_SR_SUPPORT
+  auto& ioContext = rs.ioContext;
+  auto& conMan = rs.conMan;
+#endif
+  monica::Output out, out2;
+  auto customId = msgJson["customId"];
+  out.customId = customId;
+  out2.customId = customId;
+  bool isNoDataPassThrough = customId.is_object() && customId["nodata"].bool_value();
+  bool isIC = msgJson["params"]["userCropParameters"]["intercropping"]["is_intercropping"].bool_value();
+  if (isNoDataPassThrough) {
+    debug() << "nodata pass through -> customId: " << customId.dump() << endl;
+  } else {
+    Env env;
+    env.params.siteParameters.calculateAndSetPwpFcSatFunctions = pwpFcSatFunctions();
+
+    auto errors = env.merge(msgJson);
+    if (errors.success()) {
+      EResult<DataAccessor> eda;
+      try {
+        if (!env.climateData.isValid()) {
+          if (!env.climateCSV.empty()) {
+            eda = readClimateDataFromCSVStringViaHeadersFast(env.climateCSV, env.csvViaHeaderOptions);
+          } else if (!env.pathsToClimateCSV.empty()) {
+            eda = *readClimateDataFromCSVFilesViaHeadersCached(env.pathsToClimateCSV, env.csvViaHeaderOptions);
+
+#ifdef INCLUDE_SR_SUPPORT
+            Climate::DataAccessor finalDA = kj::mv(eda.result);
+            for (const auto& sr : env.pathsToClimateCSV) {
+              if (sr.find("capnp://") == 0) {
+                auto ts = conMan.tryConnectB(sr).castAs<mas::schema::climate::TimeSeries>();
+                auto da = dataAccessorFromTimeSeries(ts).wait(ioContext.waitScope);
+                if (!finalDA.isValid()) {
+                  finalDA = kj::mv(da);
+                } else {
+                  finalDA.mergeClimateData(kj::mv(da), true);
+                }
+              }
+            }
+            eda.result = kj::mv(finalDA);
+#endif
+          }
+        }
+
+#ifdef INCLUDE_SR_SUPPORT
+        //no soil data have been loaded, but there might be a capnp sturdy ref
+        string soilSR;
+        if (msgJson["params"]["siteParameters"]["SoilProfileParameters"].is_string()) {
+          soilSR = msgJson["params"]["siteParameters"]["SoilProfileParameters"].string_value();
+        }
+        if (!soilSR.empty()) {
+          auto sp = conMan.tryConnectB(soilSR).castAs<mas::schema::soil::Profile>();
+          auto soilpsj = fromCapnpSoilProfile(sp).wait(ioContext.waitScope);
+          auto soilps = Soil::createSoilPMs(soilpsj);
+          if (soilps.second.failure()) printPossibleErrors(soilps.second, activateDebug);
+          else env.params.siteParameters.vs_SoilParameters = soilps.first;
+        }
+#endif
+
+        if (eda.success()) {
+          if (!env.climateData.isValid()) env.climateData = kj::mv(eda.result);
+
+          env.debugMode = rs.startedServerInDebugMode && env.debugMode;
+
+          env.params.userSoilMoistureParameters.getCapillaryRiseRate =
+            [](const string& soilTexture, size_t distance) {
+              return Soil::readCapillaryRiseRates().getRate(soilTexture, distance);
+            };
+
+          //isIC = env.params.userCropParameters.isIntercropping;
+          debug() << "running             -> customId: " << env.customId.dump() << endl;
+          auto str = msgJson.dump();
+          std::tie(out, out2) = runMonicaIC(kj::mv(env), isIC, sink);
+          //cout << "out: " << out.to_json().dump() << endl;
+        }
+      } catch (std::exception& e) {
+        eda.appendError(kj::str("Error while running MONICA: ", e.what()).cStr());
+      }
+      out.errors = eda.errors;
+      out.warnings = eda.warnings;
+    } else {
+      out.errors = errors.errors;
+      out.warnings = errors.warnings;
+    }
+  }
+
+  if (isIC) {
+    return json11::Json(J11Object({
+                                    {"1", out.to_json()},
+                                    {"2", out2.to_json()}
+                                  })).dump();
+  }
+  return out.to_json().dump();
+}
+
+//! inproc address the worker threads connect to
+const char* workersAddress = "inproc://monica-workers";
 
+zmq::message_t toFrame(const string& str) { return zmq::message_t(str.data(), str.size()); }
+
+string fromFrame(const zmq::message_t& msg) { return string(static_cast<const char*>(msg.data()), msg.size()); }
+
+vector<zmq::message_t> receiveFrames(zmq::socket_t& socket) {
+  vector<zmq::message_t> frames;
+  do {
+    frames.emplace_back();
+    socket.recv(&frames.back());
+  } while (frames.back().more());
+  return frames;
+}
+
+void sendFrames(zmq::socket_t& socket, vector<zmq::message_t>& frames) {
+  for (size_t i = 0; i < frames.size(); i++) socket.send(frames[i], i + 1 < frames.size() ? ZMQ_SNDMORE : 0);
+}
+
+//! pushes the results of a run as multipart messages while the run is going on
+//! ["section", customId, section, origSpec, outputIds] before the rows of a section
+//! ["row", customId, section, values] for every final row
+class ZmqMultipartResultSink : public ResultSink {
+public:
+  ZmqMultipartResultSink(zmq::socket_t& socket, string customId)
+    : _socket(socket), _customId(move(customId)) {}
+
+  void beginSection(size_t section, const string& origSpec, const vector<OId>& outputIds) override {
+    vector<zmq::message_t> frames;
+    frames.push_back(toFrame("section"));
+    frames.push_back(toFrame(_customId));
+    frames.push_back(toFrame(to_string(section)));
+    frames.push_back(toFrame(origSpec));
+    frames.push_back(toFrame(Json(toJsonArray(outputIds)).dump()));
+    send(frames);
+  }
+
+  void row(size_t section, const J11Array& values) override {
+    vector<zmq::message_t> frames;
+    frames.push_back(toFrame("row"));
+    frames.push_back(toFrame(_customId));
+    frames.push_back(toFrame(to_string(section)));
+    frames.push_back(toFrame(Json(values).dump()));
+    send(frames);
+  }
+
+private:
+  void send(vector<zmq::message_t>& frames) {
+    try {
+      sendFrames(_socket, frames);
+    } catch (const zmq::error_t& e) {
+      cerr << "Exception on trying to push streamed results! Error: [" << e.what() << "]" << endl;
+    }
+  }
+
+  zmq::socket_t& _socket;
+  string _customId;
+};
+
+//! result message of a job which could not be run because of the given error
+string errorResultMessage(const Json& customId, const string& error) {
+  monica::Output out(error);
+  out.customId = customId;
+  return out.to_json().dump();
+}
+
+//! worker thread, runs the jobs handed over by the receiving thread until it is told to stop
+//! or its socket fails, in which case it flags itself as exited for the dispatcher
+void runWorker(zmq::context_t* zmqContext, const string& workerId, atomic<bool>& exited,
+               bool startedServerInDebugMode) {
+  RunState runState;
+  runState.startedServerInDebugMode = startedServerInDebugMode;
+
+  zmq::socket_t socket(*zmqContext, ZMQ_REQ);
+  try {
+    socket.setsockopt(ZMQ_IDENTITY, workerId.data(), workerId.size());
+    socket.connect(workersAddress);
+    vector<zmq::message_t> ready;
+    ready.push_back(toFrame("ready"));
+    sendFrames(socket, ready);
+
+    while (true) {
+      // frames: "job", job id, "Env" message | "stop"
+      auto frames = receiveFrames(socket);
+      if (frames.size() < 3 || fromFrame(frames[0]) != "job") break;
+
+      string err;
+      auto msgJson = Json::parse(fromFrame(frames[2]), err);
+      auto sharedId = msgJson["sharedId"].is_null() ? "" : msgJson["sharedId"].string_value();
+
+      // a failing job must not take down the worker, the dispatcher waits for its result
+      string resultMsg;
+      try {
+        resultMsg = runEnvMessage(runState, msgJson);
+      } catch (const std::exception& e) {
+        resultMsg = errorResultMessage(msgJson["customId"], string("Error while running MONICA: ") + e.what());
+      } catch (...) {
+        resultMsg = errorResultMessage(msgJson["customId"], "Unknown error while running MONICA!");
+      }
+
+      // frames: "result", job id, [shared id], result message
+      vector<zmq::message_t> result;
+      result.push_back(toFrame("result"));
+      result.push_back(std::move(frames[1]));
+      if (!sharedId.empty()) result.push_back(toFrame(sharedId));
+      result.push_back(toFrame(resultMsg));
+      sendFrames(socket, result);
+    }
+  } catch (const zmq::error_t& e) {
+    cerr << "Exception in MONICA worker thread on zmq socket with address: " << workersAddress
+      << "! Worker will exit! Error: [" << e.what() << "]" << endl;
+  } catch (const std::exception& e) {
+    cerr << "Exception in MONICA worker thread! Worker will exit! Error: [" << e.what() << "]" << endl;
+  } catch (...) {
+    cerr << "Unknown exception in MONICA worker thread! Worker will exit!" << endl;
+  }
+  socket.setsockopt(ZMQ_LINGER, 0);
+  socket.close();
+  exited = true;
+}
+
+//! receive jobs on the calling thread and hand them to noOfWorkers worker threads,
+//! as zmq sockets may not be shared between threads, results are sent back from the calling thread as well
+void dispatchToWorkers(zmq::context_t* zmqContext,
+                       zmq::socket_t& socket,
+                       zmq::socket_t& sendSocket,
+                       bool distinctSendSocket,
+                       zmq::socket_t& controlSocket,
+                       bool distinctControlSocket,
+                       int topicCharCount,
+                       bool replyToFinish,
+                       const vector<string>& sAddresses,
+                       size_t noOfWorkers,
+                       bool startedServerInDebugMode) {
+  zmq::socket_t workersSocket(*zmqContext, ZMQ_ROUTER);
+  workersSocket.bind(workersAddress);
+
+  vector<string> workerIds;
+  for (size_t i = 0; i < noOfWorkers; i++) workerIds.push_back("worker-" + to_string(i));
+  vector<atomic<bool>> workerExited(noOfWorkers);
+  vector<thread> workers;
+  for (size_t i = 0; i < noOfWorkers; i++) {
+    workers.emplace_back(runWorker, zmqContext, cref(workerIds[i]), ref(workerExited[i]), startedServerInDebugMode);
+  }
+  debug() << "MONICA: started " << noOfWorkers << " worker threads" << endl;
+
+  //! a job handed to a worker, with what is needed to reply to its request
+  struct RunningJob {
+    vector<zmq::message_t> envelope; //!< envelope of the job's request
+    Json customId;
+    string sharedId;
+    string workerId;
+  };
+
+  deque<string> idleWorkers;
+  set<string> exitedWorkers;
+  size_t noOfLiveWorkers = noOfWorkers;
+  map<string, RunningJob> runningJobs; //!< by job id
+  size_t jobCount = 0;
+  bool finish = false;
+  vector<zmq::message_t> finishEnvelope;
+
+  // send frames as reply to the request with the given envelope (empty if not received via a router socket)
+  auto sendReply = [&](vector<zmq::message_t>& envelope, vector<zmq::message_t>& frames, const string& what) {
+    vector<zmq::message_t> reply;
+    if (!distinctSendSocket) for (auto& f : envelope) reply.push_back(std::move(f));
+    for (auto& f : frames) reply.push_back(std::move(f));
+    try {
+      sendFrames(distinctSendSocket ? sendSocket : socket, reply);
+    } catch (const zmq::error_t& e) {
+      cerr << "Exception on trying to reply with " << what << " message on zmq socket with address: ";
+      for (auto i : kj::indices(sAddresses)) cerr << (i > 0 ? "," : "") << sAddresses[i];
+      cerr << "! Will continue! Error: [" << e.what() << "]" << endl;
+    }
+  };
+
+  // drop workers which exited (their socket failed), the jobs they were running are answered with an error
+  auto dropExitedWorkers = [&]() {
+    for (size_t i = 0; i < noOfWorkers; i++) {
+      const auto& workerId = workerIds[i];
+      if (!workerExited[i] || exitedWorkers.count(workerId)) continue;
+      exitedWorkers.insert(workerId);
+      noOfLiveWorkers--;
+      cerr << "MONICA " << workerId << " exited, " << noOfLiveWorkers << " worker threads left!" << endl;
+      idleWorkers.erase(remove(idleWorkers.begin(), idleWorkers.end(), workerId), idleWorkers.end());
+      for (auto it = runningJobs.begin(); it != runningJobs.end(); ++it) {
+        if (it->second.workerId != workerId) continue;
+        vector<zmq::message_t> result;
+        if (!it->second.sharedId.empty()) result.push_back(toFrame(it->second.sharedId));
+        result.push_back(toFrame(errorResultMessage(it->second.customId, "MONICA worker thread exited while running the job!")));
+        sendReply(it->second.envelope, result, "error result");
+        runningJobs.erase(it);
+        break;
+      }
+    }
+  };
+
+  while (noOfLiveWorkers > 0 && !(finish && runningJobs.empty() && idleWorkers.size() == noOfLiveWorkers)) {
+    // only take requests if there is an idle worker, so pending jobs stay with the sender
+    // and can be picked up by other MONICA servers in the meantime
+    bool acceptJobs = !finish && !idleWorkers.empty();
+    zmq::pollitem_t items[] = {
+      {(void*)workersSocket, 0, ZMQ_POLLIN, 0},
+      {(void*)socket, 0, ZMQ_POLLIN, 0},
+      {(void*)controlSocket, 0, ZMQ_POLLIN, 0}
+    };
+
+    try {
+      // wake up regularly to notice exited workers
+      zmq::poll(&items[0], acceptJobs ? (distinctControlSocket ? 3 : 2) : 1, 1000);
+
+      if (items[0].revents & ZMQ_POLLIN) {
+        // frames: worker id, empty delimiter, "ready" | "result", job id, result frames
+        auto frames = receiveFrames(workersSocket);
+        if (frames.size() >= 3) {
+          auto workerId = fromFrame(frames[0]);
+          if (!exitedWorkers.count(workerId)) idleWorkers.push_back(workerId);
+          if (fromFrame(frames[2]) == "result" && frames.size() > 4) {
+            auto it = runningJobs.find(fromFrame(frames[3]));
+            if (it != runningJobs.end()) {
+              vector<zmq::message_t> result;
+              for (size_t i = 4; i < frames.size(); i++) result.push_back(std::move(frames[i]));
+              sendReply(it->second.envelope, result, "result");
+              runningJobs.erase(it);
+            }
+          }
+        }
+      }
+
+      dropExitedWorkers();
+      if (!acceptJobs || idleWorkers.empty()) continue;
+
+      vector<zmq::message_t> frames;
+      size_t topicChars = 0;
+      if (items[1].revents & ZMQ_POLLIN) {
+        frames = receiveFrames(socket);
+      } else if (distinctControlSocket && items[2].revents & ZMQ_POLLIN) {
+        frames = receiveFrames(controlSocket);
+        topicChars = topicCharCount;
+      }
+      if (frames.empty()) continue;
+
+      // what remains after removing the message frame is the envelope of a request on a router socket
+      auto msgStr = fromFrame(frames.back());
+      msgStr = topicChars < msgStr.size() ? msgStr.substr(topicChars) : "";
+      frames.pop_back();
+      string err;
+      auto msgJson = Json::parse(msgStr, err);
+      auto msgType = msgJson["type"].string_value();
+
+      if (msgType == "finish") {
+        finish = true;
+        finishEnvelope = std::move(frames);
+      } else if (msgType == "Env") {
+        auto jobId = to_string(jobCount++);
+        auto workerId = idleWorkers.front();
+        vector<zmq::message_t> job;
+        job.push_back(toFrame(workerId));
+        job.emplace_back();
+        job.push_back(toFrame("job"));
+        job.push_back(toFrame(jobId));
+        job.push_back(toFrame(msgStr));
+        sendFrames(workersSocket, job);
+        idleWorkers.pop_front();
+        auto sharedId = msgJson["sharedId"].is_null() ? "" : msgJson["sharedId"].string_value();
+        runningJobs[jobId] = {std::move(frames), msgJson["customId"], sharedId, workerId};
+      } else {
+        debug() << "Error, original message was: " << msgStr << endl;
+        J11Object resultMsg;
+        resultMsg["type"] = "error";
+        vector<zmq::message_t> reply;
+        reply.push_back(toFrame(Json(resultMsg).dump()));
+        sendReply(frames, reply, "'error'");
+      }
+    } catch (const zmq::error_t& e) {
+      cerr << "Exception on trying to dispatch request messages to MONICA worker threads! "
+        "Will continue to receive requests! Error: [" << e.what() << "]" << endl;
+    }
+  }
+
+  if (noOfLiveWorkers == 0) {
+    cerr << "All MONICA worker threads exited! Will stop serving!" << endl;
+  }
+
+  for (const auto& workerId : idleWorkers) {
+    vector<zmq::message_t> stop;
+    stop.push_back(toFrame(workerId));
+    stop.emplace_back();
+    stop.push_back(toFrame("stop"));
+    sendFrames(workersSocket, stop);
+  }
+  for (auto& w : workers) w.join();
+  workersSocket.setsockopt(ZMQ_LINGER, 0);
+  workersSocket.close();
+
+  //only send reply when not in pipeline configuration
+  if (replyToFinish && finish) {
+    J11Object resultMsg;
+    resultMsg["type"] = "ack";
+    vector<zmq::message_t> reply;
+    reply.push_back(toFrame(Json(resultMsg).dump()));
+    sendReply(finishEnvelope, reply, "'ack'");
+  }
+}
+
+} // namespace
+
+void monica::serveZmqMonicaFull(zmq::context_t* zmqContext,
+                                map<SocketRole, SocketConfig> socketAddresses,
+                                size_t noOfWorkers) {
   bool startedServerInDebugMode = activateDebug;
 
   if (socketAddresses.empty()) {
@@ -400,6 +823,8 @@ void monica::serveZmqMonicaFull(zmq::context_t* zmqContext,
   vector<string> rAddresses = rconfig.addresses;
   int receiveSocketType = ZMQ_REP;
   if (rconfig.type == Pull) receiveSocketType = ZMQ_PULL;
+  // a reply socket can't have multiple requests in flight, a router socket talks the same protocol but can
+  else if (noOfWorkers > 0) receiveSocketType = ZMQ_ROUTER;
   zmq::socket_t socket(*zmqContext, receiveSocketType);
 
   try {
@@ -454,173 +879,98 @@ void monica::serveZmqMonicaFull(zmq::context_t* zmqContext,
           controlSocket.setsockopt(ZMQ_SUBSCRIBE, topic, topicCharCount);
         }
 
-        while (true) {
-          try {
-            Msg msg;
-            zmq::poll(&items[0], distinctControlSocket ? 2 : 1, -1);
-
-            if (items[0].revents & ZMQ_POLLIN) msg = receiveMsg(socket);
-            if (distinctControlSocket && items[1].revents & ZMQ_POLLIN) {
-              msg = receiveMsg(controlSocket, topicCharCount);
-            }
-
-            //auto msg = receiveMsg(socket);
+        if (noOfWorkers > 0) {
+          dispatchToWorkers(zmqContext, socket, sendSocket, distinctSendSocket, controlSocket, distinctControlSocket,
+                            topicCharCount, rconfig.type != Pull, sAddresses, noOfWorkers, startedServerInDebugMode);
 
-            string msgType = msg.type();
-            if (msgType == "finish") {
-              //only send reply when not in pipeline configuration
-              if (rconfig.type != Pull) {
-                J11Object resultMsg;
-                resultMsg["type"] = "ack";
-                try {
-                  s_send(distinctSendSocket ? sendSocket : socket, Json(resultMsg).dump());
-                } catch (const zmq::error_t& e) {
-                  cerr
-                    << "Exception on trying to reply to 'finish' request with 'ack' message on zmq socket with address(es): ";
-                  int i = 0;
-                  for (const auto& address : sAddresses) cerr << (i > 0 ? "," : "") << address, ++i;
-                  cerr << "! Still will finish MONICA process! Error: [" << e.what() << "]" << endl;
-                }
-              }
-              sendSocket.setsockopt(ZMQ_LINGER, 0);
-              sendSocket.close();
-
-              controlSocket.setsockopt(ZMQ_LINGER, 0);
-              controlSocket.close();
-
-              socket.setsockopt(ZMQ_LINGER, 0);
-              socket.close();
-
-              break;
-            } else if (msgType == "Env") {
-              auto sharedId = msg.json["sharedId"].is_null() ? "" : msg.json["sharedId"].string_value();
-              monica::Output out, out2;
-              auto customId = msg.json["customId"];
-              out.customId = customId;
-              out2.customId = customId;
-              bool isNoDataPassThrough = customId.is_object() && customId["nodata"].bool_value();
-              bool isIC = msg.json["params"]["userCropParameters"]["intercropping"]["is_intercropping"].bool_value();
-              if (isNoDataPassThrough) {
-                debug() << "nodata pass through -> customId: " << customId.dump() << endl;
-              } else {
-                Env env;
-                auto pathToSoilDir = fixSystemSeparator(replaceEnvVars("${MONICA_PARAMETERS}/soil/"));
-                env.params.siteParameters.calculateAndSetPwpFcSatFunctions["Wessolek2009"] =
-                  Soil::getInitializedUpdateUnsetPwpFcSatfromKA5textureClassFunction(pathToSoilDir);
-                env.params.siteParameters.calculateAndSetPwpFcSatFunctions["VanGenuchten"] =
-                  Soil::updateUnsetPwpFcSatFromVanGenuchtenVereecken;
-                env.params.siteParameters.calculateAndSetPwpFcSatFunctions["VanGenuchtenVereecken"] =
-                  Soil::updateUnsetPwpFcSatFromVanGenuchtenVereecken;
-                env.params.siteParameters.calculateAndSetPwpFcSatFunctions["VanGenuchtenToth"] =
-                  Soil::updateUnsetPwpFcSatFromVanGenuchtenToth;
-                env.params.siteParameters.calculateAndSetPwpFcSatFunctions["Toth"] = Soil::updateUnsetPwpFcSatFromToth;
-
-                auto errors = env.merge(msg.json);
-                if (errors.success()) {
-                  EResult<DataAccessor> eda;
-                  try {
-                    if (!env.climateData.isValid()) {
-                      if (!env.climateCSV.empty()) {
-                        eda = readClimateDataFromCSVStringViaHeaders(env.climateCSV, env.csvViaHeaderOptions);
-                      } else if (!env.pathsToClimateCSV.empty()) {
-                        eda = readClimateDataFromCSVFilesViaHeaders(env.pathsToClimateCSV, env.csvViaHeaderOptions);
+          sendSocket.setsockopt(ZMQ_LINGER, 0);
+          sendSocket.close();
 
-#ifdef INCLUDE_SR_SUPPORT
-                        Climate::DataAccessor finalDA = kj::mv(eda.result);
-                        for (const auto& sr : env.pathsToClimateCSV) {
-                          if (sr.find("capnp://") == 0) {
-                            auto ts = conMan.tryConnectB(sr).castAs<mas::schema::climate::TimeSeries>();
-                            auto da = dataAccessorFromTimeSeries(ts).wait(ioContext.waitScope);
-                            if (!finalDA.isValid()) {
-                              finalDA = kj::mv(da);
-                            } else {
-                              finalDA.mergeClimateData(kj::mv(da), true);
-                            }
-                          }
-                        }
-                        eda.result = kj::mv(finalDA);
-#endif
-                      }
-                    }
+          controlSocket.setsockopt(ZMQ_LINGER, 0);
+          controlSocket.close();
 
-#ifdef INCLUDE_SR_SUPPORT
-                    //no soil data have been loaded, but there might be a capnp sturdy ref
-                    string soilSR;
-                    if (msg.json["params"]["siteParameters"]["SoilProfileParameters"].is_string()) {
-                      soilSR = msg.json["params"]["siteParameters"]["SoilProfileParameters"].string_value();
-                    }
-                    if (!soilSR.empty()) {
-                      auto sp = conMan.tryConnectB(soilSR).castAs<mas::schema::soil::Profile>();
-                      auto soilpsj = fromCapnpSoilProfile(sp).wait(ioContext.waitScope);
-                      auto soilps = Soil::createSoilPMs(soilpsj);
-                      if (soilps.second.failure()) printPossibleErrors(soilps.second, activateDebug);
-                      else env.params.siteParameters.vs_SoilParameters = soilps.first;
-                    }
-#endif
+          socket.setsockopt(ZMQ_LINGER, 0);
+          socket.close();
+        } else {
+          RunState runState;
+          runState.startedServerInDebugMode = startedServerInDebugMode;
 
-                    if (eda.success()) {
-                      if (!env.climateData.isValid()) env.climateData = kj::mv(eda.result);
+          while (true) {
+            try {
+              Msg msg;
+              zmq::poll(&items[0], distinctControlSocket ? 2 : 1, -1);
 
-                      env.debugMode = startedServerInDebugMode && env.debugMode;
+              if (items[0].revents & ZMQ_POLLIN) msg = receiveMsg(socket);
+              if (distinctControlSocket && items[1].revents & ZMQ_POLLIN) {
+                msg = receiveMsg(controlSocket, topicCharCount);
+              }
 
-                      env.params.userSoilMoistureParameters.getCapillaryRiseRate =
-                        [](const string& soilTexture, size_t distance) {
-                          return Soil::readCapillaryRiseRates().getRate(soilTexture, distance);
-                        };
+              //auto msg = receiveMsg(socket);
 
-                      //isIC = env.params.userCropParameters.isIntercropping;
-                      debug() << "running             -> customId: " << env.customId.dump() << endl;
-                      auto str = msg.json.dump();
-                      std::tie(out, out2) = runMonicaIC(kj::mv(env), isIC);
-                      //cout << "out: " << out.to_json().dump() << endl;
-                    }
-                  } catch (std::exception& e) {
-                    eda.appendError(kj::str("Error while running MONICA: ", e.what()).cStr());
+              string msgType = msg.type();
+              if (msgType == "finish") {
+                //only send reply when not in pipeline configuration
+                if (rconfig.type != Pull) {
+                  J11Object resultMsg;
+                  resultMsg["type"] = "ack";
+                  try {
+                    s_send(distinctSendSocket ? sendSocket : socket, Json(resultMsg).dump());
+                  } catch (const zmq::error_t& e) {
+                    cerr
+                      << "Exception on trying to reply to 'finish' request with 'ack' message on zmq socket with address(es): ";
+                    int i = 0;
+                    for (const auto& address : sAddresses) cerr << (i > 0 ? "," : "") << address, ++i;
+                    cerr << "! Still will finish MONICA process! Error: [" << e.what() << "]" << endl;
                   }
-                  out.errors = eda.errors;
-                  out.warnings = eda.warnings;
-                } else {
-                  out.errors = errors.errors;
-                  out.warnings = errors.warnings;
                 }
-              }
+                sendSocket.setsockopt(ZMQ_LINGER, 0);
+                sendSocket.close();
+
+                controlSocket.setsockopt(ZMQ_LINGER, 0);
+                controlSocket.close();
+
+                socket.setsockopt(ZMQ_LINGER, 0);
+                socket.close();
+
+                break;
+              } else if (msgType == "Env") {
+                auto sharedId = msg.json["sharedId"].is_null() ? "" : msg.json["sharedId"].string_value();
+                // stream the result rows while running, only possible if pushing them to a distinct socket,
+                // the final result message then just closes the stream (errors, warnings, no result rows)
+                kj::Own<ZmqMultipartResultSink> sink;
+                if (msg.json["outputs"]["stream?"].bool_value() && distinctSendSocket && sconfig.type != Router) {
+                  sink = kj::heap<ZmqMultipartResultSink>(sendSocket, msg.json["customId"].dump());
+                }
+                auto result = runEnvMessage(runState, msg.json, sink.get());
 
-              try {
-                if (!sharedId.empty()) s_sendmore(distinctSendSocket ? sendSocket : socket, sharedId);
+                try {
+                  if (!sharedId.empty()) s_sendmore(distinctSendSocket ? sendSocket : socket, sharedId);
+                  s_send(distinctSendSocket ? sendSocket : socket, result);
+                } catch (const zmq::error_t& e) {
+                  cerr << "Exception on trying to reply with result message on zmq socket with address: ";
+                  for (auto i : kj::indices(sAddresses)) cerr << (i > 0 ? "," : "") << sAddresses[i];
+                  cerr << "! Will continue to receive requests! Error: [" << e.what() << "]" << endl;
+                }
+              } else {
+                J11Object resultMsg;
+                resultMsg["type"] = "error";
+                debug() << "Error, original message was: " << msg.msg << endl;
 
-                if (isIC) {
-                  auto outs = json11::Json(J11Object({
-                                                       {"1", out.to_json()},
-                                                       {"2", out2.to_json()}
-                                                     }));
-                  s_send(distinctSendSocket ? sendSocket : socket, outs.dump());
-                } else {
-                  s_send(distinctSendSocket ? sendSocket : socket, out.to_json().dump());
+                try {
+                  s_send(distinctSendSocket ? sendSocket : socket, Json(resultMsg).dump());
+                } catch (const zmq::error_t& e) {
+                  cerr
+                    << "Exception on trying to reply to '" << msgType
+                    << "' request with 'error' message on zmq socket with address: ";
+                  for (auto i : kj::indices(sAddresses)) cerr << (i > 0 ? "," : "") << sAddresses[i];
+                  cerr << "! Still will finish MONICA process! Error: [" << e.what() << "]" << endl;
                 }
-              } catch (const zmq::error_t& e) {
-                cerr << "Exception on trying to reply with result message on zmq socket with address: ";
-                for (auto i : kj::indices(sAddresses)) cerr << (i > 0 ? "," : "") << sAddresses[i];
-                cerr << "! Will continue to receive requests! Error: [" << e.what() << "]" << endl;
-              }
-            } else {
-              J11Object resultMsg;
-              resultMsg["type"] = "error";
-              debug() << "Error, original message was: " << msg.msg << endl;
-
-              try {
-                s_send(distinctSendSocket ? sendSocket : socket, Json(resultMsg).dump());
-              } catch (const zmq::error_t& e) {
-                cerr
-                  << "Exception on trying to reply to '" << msgType
-                  << "' request with 'error' message on zmq socket with address: ";
-                for (auto i : kj::indices(sAddresses)) cerr << (i > 0 ? "," : "") << sAddresses[i];
-                cerr << "! Still will finish MONICA process! Error: [" << e.what() << "]" << endl;
               }
+            } catch (const zmq::error_t& e) {
+              cerr << "Exception on trying to receive request message on zmq socket with address: ";
+              for (auto i : kj::indices(rAddresses)) cerr << (i > 0 ? "," : "") << rAddresses[i];
+              cerr << "! Will continue to receive requests! Error: [" << e.what() << "]" << endl;
             }
-          } catch (const zmq::error_t& e) {
-            cerr << "Exception on trying to receive request message on zmq socket with address: ";
-            for (auto i : kj::indices(rAddresses)) cerr << (i > 0 ? "," : "") << rAddresses[i];
-            cerr << "! Will continue to receive requests! Error: [" << e.what() << "]" << endl;
           }
         }
       } catch (const zmq::error_t& e) {
@@ -52,8 +52,11 @@ struct SocketConfig {
   SocketOp op;
 };
 
+//! serve MONICA runs on the given sockets,
+//! noOfWorkers > 0 runs the jobs on as many worker threads, while the calling thread receives jobs and sends results
 void serveZmqMonicaFull(zmq::context_t *zmqContext,
-                        std::map<SocketRole, SocketConfig> socketAddresses);
+                        std::map<SocketRole, SocketConfig> socketAddresses,
+                        size_t noOfWorkers = 0);
 
 } // namespace monica
 
@@ -0,0 +1,203 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+* License, v. 2.0. If a copy of the MPL was not distributed with this
+* file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+/*
+Authors:
+Michael Berg <michael.berg@zalf.de>
+
+Maintainers:
+Currently maintained by the authors.
+
+This file is part of the MONICA model.
+Copyright (C) Leibniz Centre for Agricultural Landscape Research (ZALF)
+*/
+
+#include "spec-predicates.h"
+
+#include <algorithm>
+#include <charconv>
+
+#include "tools/helper.h"
+#include "../core/event-registry.h"
+#include "../core/monica-model.h"
+#include "../io/build-output.h"
+
+using namespace monica;
+using namespace std;
+using namespace Tools;
+using namespace json11;
+
+namespace {
+
+//! @return -1 for a wildcard ("xx", "xxxx") or an unparsable field
+int parseDateField(const string& s) {
+  int value = -1;
+  auto res = from_chars(s.data(), s.data() + s.size(), value);
+  return res.ec == errc() && value >= 0 ? value : -1;
+}
+
+SpecPredicate compileDatePattern(int year, int month, int day) {
+  if (year < 0 && month < 0 && day < 0) return [](const MonicaModel&) { return true; };
+
+  return [year, month, day](const MonicaModel& monica) {
+    auto cd = monica.currentStepDate();
+    // apply min() for day, to allow for matching of the last day for each month by choosing 31st
+    return (year < 0 || int(cd.year()) == year)
+           && (month < 0 || int(cd.month()) == month)
+           && (day < 0 || int(cd.day()) == min(day, int(cd.daysInMonth())));
+  };
+}
+
+enum CompareOp { LT, LE, EQ, NE, GT, GE, UNKNOWN_OP };
+
+CompareOp parseCompareOp(const string& ops) {
+  if (ops == "<") return LT;
+  else if (ops == "<=") return LE;
+  else if (ops == "=") return EQ;
+  else if (ops == "!=") return NE;
+  else if (ops == ">") return GT;
+  else if (ops == ">=") return GE;
+  return UNKNOWN_OP;
+}
+
+inline bool compare(CompareOp op, double l, double r) {
+  switch (op) {
+    case LT: return l < r;
+    case LE: return l <= r;
+    case EQ: return l == r;
+    case NE: return l != r;
+    case GT: return l > r;
+    case GE: return l >= r;
+    default: return false;
+  }
+}
+
+typedef function<Json(const MonicaModel&, const OId&)> OutputFunction;
+
+//! a compare expression with the output functions resolved and the constant operand unboxed
+//! plain number outputs are compared via their typed output functions,
+//! everything else (e.g. arrays of layers) still goes through applyCompareOp
+struct CompiledCompare {
+  bool operator()(const MonicaModel& monica) const {
+    if (lnf && rnf) return compare(op, (*lnf)(monica, loid), (*rnf)(monica, roid));
+    else if (lnf && !rf) return compare(op, (*lnf)(monica, loid), rightValue);
+    else if (rnf && !lf) return compare(op, leftValue, (*rnf)(monica, roid));
+
+    if (lf && rf) {
+      auto l = (*lf)(monica, loid);
+      auto r = (*rf)(monica, roid);
+      if (l.is_number() && r.is_number()) return compare(op, l.number_value(), r.number_value());
+      return applyCompareOp(opf, l, r);
+    } else if (lf) {
+      auto l = (*lf)(monica, loid);
+      if (l.is_number()) return compare(op, l.number_value(), rightValue);
+      return applyCompareOp(opf, l, rightValue);
+    }
+    auto r = (*rf)(monica, roid);
+    if (r.is_number()) return compare(op, leftValue, r.number_value());
+    return applyCompareOp(opf, leftValue, r);
+  }
+
+  CompareOp op{UNKNOWN_OP};
+  function<bool(double, double)> opf;
+  const OutputFunction* lf{nullptr};
+  const OutputFunction* rf{nullptr};
+  const NumberOutputFunction* lnf{nullptr};
+  const NumberOutputFunction* rnf{nullptr};
+  OId loid, roid;
+  double leftValue{0}, rightValue{0};
+};
+
+//! @return the output function and OId of j, nullptr if j isn't a known output
+//! nf is set to the typed output function if j is a plain number output
+const OutputFunction* resolveOutput(const Json& j, OId& oid, const NumberOutputFunction*& nf) {
+  nf = nullptr;
+  if (j.is_number()) return nullptr;
+  auto oids = parseOutputIds({j});
+  if (oids.empty()) return nullptr;
+  oid = oids.front();
+  const auto& bot = buildOutputTable();
+  auto ofi = bot.ofs.find(oid.id);
+  if (ofi == bot.ofs.end()) return nullptr;
+  auto nofi = bot.numberOfs.find(oid.id);
+  if (nofi != bot.numberOfs.end()) nf = &nofi->second;
+  return &ofi->second;
+}
+
+//! same expressions as buildCompareExpression accepts
+SpecPredicate compileCompareExpression(const J11Array& a) {
+  if (a.size() == 3
+      && (a[0].is_number() || a[0].is_string() || a[0].is_array())
+      && a[1].is_string()
+      && (a[2].is_number() || a[2].is_string() || a[2].is_array())) {
+    CompiledCompare cc;
+    cc.op = parseCompareOp(a[1].string_value());
+    cc.opf = getCompareOp(a[1].string_value());
+    cc.lf = resolveOutput(a[0], cc.loid, cc.lnf);
+    cc.rf = resolveOutput(a[2], cc.roid, cc.rnf);
+    cc.leftValue = a[0].number_value();
+    cc.rightValue = a[2].number_value();
+    if ((cc.lf && cc.rf) || (cc.lf && a[2].is_number()) || (a[0].is_number() && cc.rf)) return cc;
+  }
+  return {};
+}
+
+} // namespace
+
+SpecPredicate monica::compileSpecPredicate(const Json& j) {
+  //is an expression event
+  if (j.is_array()) return compileCompareExpression(j.array_items());
+  else if (j.is_string()) {
+    auto jts = j.string_value();
+    if (!jts.empty()) {
+      auto s = splitString(jts, "-");
+      //is date event
+      if (jts.size() == 10
+          && s.size() == 3
+          && s[0].size() == 4
+          && s[1].size() == 2
+          && s[2].size() == 2) {
+        return compileDatePattern(parseDateField(s[0]), parseDateField(s[1]), parseDateField(s[2]));
+      } else { //treat all other strings as potential workstep event
+        auto eventId = lookupEvent(jts);
+        // names which aren't built-in events are matched as strings
+        if (eventId == NO_EVENT_ID) {
+          return [jts](const MonicaModel& monica) { return monica.currentEvents().contains(jts); };
+        }
+        return [eventId](const MonicaModel& monica) { return monica.currentEvents().contains(eventId); };
+      }
+    }
+  }
+  return {};
+}
+
+SpecPredicate SpecPredicates::add(const Json& j) {
+  if (j.is_null()) return {};
+
+  auto key = j.dump();
+  auto it = _expression2index.find(key);
+  size_t i = 0;
+  if (it == _expression2index.end()) {
+    auto f = compileSpecPredicate(j);
+    if (!f) return {};
+    i = _entries.size();
+    _entries.push_back({move(f)});
+    _expression2index[key] = i;
+  } else i = it->second;
+
+  auto self = shared_from_this();
+  return [self, i](const MonicaModel& monica) { return self->evaluate(i, monica); };
+}
+
+bool SpecPredicates::evaluate(size_t i, const MonicaModel& monica) {
+  auto& e = _entries[i];
+  auto cd = monica.currentStepDate();
+  int day = cd.year() * 10000 + cd.month() * 100 + cd.day();
+  if (e.evaluatedFor != &monica || e.evaluatedAt != day) {
+    e.value = e.f(monica);
+    e.evaluatedFor = &monica;
+    e.evaluatedAt = day;
+  }
+  return e.value;
+}
@@ -0,0 +1,62 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+* License, v. 2.0. If a copy of the MPL was not distributed with this
+* file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+/*
+Authors:
+Michael Berg <michael.berg@zalf.de>
+
+Maintainers:
+Currently maintained by the authors.
+
+This file is part of the MONICA model.
+Copyright (C) Leibniz Centre for Agricultural Landscape Research (ZALF)
+*/
+
+#pragma once
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "json11/json11.hpp"
+
+namespace monica {
+class MonicaModel;
+
+typedef std::function<bool(const MonicaModel&)> SpecPredicate;
+
+//! compile an expression of an events section spec (start, end, at, from, to, while)
+//! - a date pattern, e.g. "xxxx-xx-01", becomes a check of the current date's fields
+//! - any other string is a workstep/crop event, e.g. "Sowing", and becomes a test of the event's (built-in) id or name
+//! - a compare expression, e.g. ["Mois", ">", 0.3], compares the output's value directly as double
+//! @return an empty function if j isn't a valid expression
+SpecPredicate compileSpecPredicate(const json11::Json& j);
+
+//! the compiled predicates of all specs of one model's events section
+//! identical expressions are compiled once and evaluated at most once a day,
+//! all sections using them share the result
+class SpecPredicates : public std::enable_shared_from_this<SpecPredicates> {
+public:
+  //! @return the shared predicate for expression j, or an empty function if j isn't a valid expression
+  SpecPredicate add(const json11::Json& j);
+
+  //! number of distinct predicates
+  size_t size() const { return _entries.size(); }
+
+private:
+  bool evaluate(size_t i, const MonicaModel& monica);
+
+  struct Entry {
+    SpecPredicate f;
+    const MonicaModel* evaluatedFor{nullptr};
+    int evaluatedAt{0}; //!< day as yyyymmdd
+    bool value{false};
+  };
+  std::unordered_map<std::string, size_t> _expression2index;
+  std::vector<Entry> _entries;
+};
+
+} // namespace monica